@@ -21,6 +21,8 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/debug.h"
+#include "common/profiler.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -188,6 +190,16 @@ private:
 	uint32 _pauseStartTime;
 	uint32 _pauseTime;
 
+	/**
+	 * Odd while the timing values above are being updated, so that
+	 * getElapsedTime() can read a consistent set of them when the mixer
+	 * runs lock-free.
+	 */
+	Common::Atomic<uint32> _timingSeq;
+
+	void beginTimingUpdate();
+	void endTimingUpdate();
+
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
 };
@@ -196,8 +208,17 @@ private:
 #pragma mark --- Mixer ---
 #pragma mark -
 
-MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+// Without lock-free atomics, the command queues can't be shared with the
+// audio thread, so the mixer always takes the mutex
+#ifdef ATOMICS_ARE_LOCK_FREE
+static const bool kLockFreeSupported = true;
+#else
+static const bool kLockFreeSupported = false;
+#endif
+
+MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize, bool lockFree)
+	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _lockFree(lockFree && kLockFreeSupported), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _statCallbacks(0), _statXRuns(0), _statMaxCallbackTime(0), _statCommandStalls(0) {
 
 	assert(sampleRate > 0);
 
@@ -206,10 +227,127 @@ MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize)
 }
 
 MixerImpl::~MixerImpl() {
+	Stats stats = getStats();
+	debug(1, "MixerImpl: %u callbacks, %u xruns, longest callback %u ms, %u command queue stalls",
+	      stats.callbacks, stats.xruns, stats.maxCallbackTime, stats.commandStalls);
+
+	// The backend has stopped calling mixCallback() by now, so we can
+	// clean up both sides of the queues from here.
+	Command cmd;
+	while (_commands.pop(cmd)) {
+		if (cmd.type == kCommandAdd)
+			delete cmd.chan;
+	}
+	deleteRetiredChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
 }
 
+MixerImpl::Stats MixerImpl::getStats() const {
+	Common::StackLock lock(_mutex);
+
+	Stats stats;
+	stats.callbacks = _statCallbacks.load(Common::kMemoryOrderRelaxed);
+	stats.xruns = _statXRuns.load(Common::kMemoryOrderRelaxed);
+	stats.maxCallbackTime = _statMaxCallbackTime.load(Common::kMemoryOrderRelaxed);
+	stats.commandStalls = _statCommandStalls;
+	return stats;
+}
+
+void MixerImpl::pushCommand(CommandType type, int index, int value) {
+	Command cmd;
+	cmd.type = type;
+	cmd.index = index;
+	cmd.chan = _channelStates[index].chan;
+	cmd.value = value;
+
+	// The queue only fills up if the engine changes channels much faster
+	// than the backend calls us. Wait for the mixer callback to catch up.
+	while (!_commands.push(cmd)) {
+		_statCommandStalls++;
+		deleteRetiredChannels();
+		g_system->delayMillis(1);
+	}
+}
+
+void MixerImpl::processCommands() {
+	// Stopping a channel needs room to hand it back, so leave any further
+	// commands for the next callback if that is not guaranteed.
+	Command cmd;
+	while (!_retiredChannels.full() && _commands.pop(cmd)) {
+		Channel *chan = _channels[cmd.index];
+
+		if (cmd.type == kCommandAdd) {
+			assert(!chan);
+			_channels[cmd.index] = cmd.chan;
+			continue;
+		}
+
+		// Ignore commands for channels which already finished on their own
+		if (!chan || chan != cmd.chan)
+			continue;
+
+		switch (cmd.type) {
+		case kCommandStop:
+			_retiredChannels.push(chan);
+			_channels[cmd.index] = nullptr;
+			break;
+		case kCommandPause:
+			chan->pause(cmd.value != 0);
+			break;
+		case kCommandVolume:
+			chan->setVolume(cmd.value);
+			break;
+		case kCommandBalance:
+			chan->setBalance(cmd.value);
+			break;
+		case kCommandRate:
+			chan->setRate(cmd.value);
+			break;
+		case kCommandResetRate:
+			chan->resetRate();
+			break;
+		case kCommandLoop:
+			chan->loop();
+			break;
+		case kCommandGlobalVolume:
+			chan->notifyGlobalVolChange();
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void MixerImpl::deleteRetiredChannels() {
+	Channel *chan;
+	while (_retiredChannels.pop(chan)) {
+		// The slot is only still assigned to the channel if it finished
+		// by itself, since stopping it already released it.
+		const int index = chan->getHandle()._val % NUM_CHANNELS;
+		if (_channelStates[index].chan == chan)
+			_channelStates[index].chan = nullptr;
+
+		delete chan;
+	}
+}
+
+void MixerImpl::retireChannel(int index) {
+	pushCommand(kCommandStop, index);
+	_channelStates[index].chan = nullptr;
+}
+
+int MixerImpl::findChannelState(SoundHandle handle) {
+	deleteRetiredChannels();
+
+	const int index = handle._val % NUM_CHANNELS;
+	if (!_channelStates[index].chan || _channelStates[index].handle != handle._val)
+		return -1;
+
+	return index;
+}
+
 void MixerImpl::setReady(bool ready) {
 	Common::StackLock lock(_mutex);
 
@@ -231,7 +369,7 @@ uint MixerImpl::getOutputBufSize() const {
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == nullptr) {
+		if ((_lockFree ? _channelStates[i].chan : _channels[i]) == nullptr) {
 			index = i;
 			break;
 		}
@@ -242,7 +380,8 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		return;
 	}
 
-	_channels[index] = chan;
+	if (!_lockFree)
+		_channels[index] = chan;
 
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
@@ -251,6 +390,20 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	if (_lockFree) {
+		ChannelState &state = _channelStates[index];
+		state.chan = chan;
+		state.handle = chanHandle._val;
+		state.id = chan->getId();
+		state.type = chan->getType();
+		state.permanent = chan->isPermanent();
+		state.volume = chan->getVolume();
+		state.balance = chan->getBalance();
+		state.rate = state.nativeRate = chan->getRate();
+
+		pushCommand(kCommandAdd, index);
+	}
 }
 
 void MixerImpl::playStream(
@@ -271,10 +424,13 @@ void MixerImpl::playStream(
 
 	assert(_mixerReady);
 
+	if (_lockFree)
+		deleteRetiredChannels();
+
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != nullptr && _channels[i]->getId() == id) {
+			if (_lockFree ? (_channelStates[i].chan != nullptr && _channelStates[i].id == id) : (_channels[i] != nullptr && _channels[i]->getId() == id)) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -299,10 +455,44 @@ void MixerImpl::playStream(
 }
 
 int MixerImpl::mixCallback(byte *samples, uint len) {
+	PROFILE_ZONE("MixerImpl::mixCallback");
 	assert(samples);
 
-	Common::StackLock lock(_mutex);
+	// Reading the timer twice per callback is not free, so the callbacks
+	// are only timed while the statistics get reported
+	const bool timed = debugLevelSet(1);
+	const uint32 start = timed ? g_system->getMillis(true) : 0;
+
+	int res;
+	if (_lockFree) {
+		processCommands();
+		res = mixChannels(samples, len);
+		updateStats(len, timed, start);
+	} else {
+		Common::StackLock lock(_mutex);
+		res = mixChannels(samples, len);
+		updateStats(len, timed, start);
+	}
+
+	return res;
+}
+
+void MixerImpl::updateStats(uint len, bool timed, uint32 start) {
+	_statCallbacks.fetchAdd(1, Common::kMemoryOrderRelaxed);
+	if (!timed)
+		return;
+
+	// Anything taking longer than the audio we produced makes the output
+	// run dry, either from mixing itself or from waiting for the mutex.
+	const uint32 elapsed = g_system->getMillis(true) - start;
+	const uint32 duration = (len / (_stereo ? 4 : 2)) * 1000 / _sampleRate;
+	if (elapsed > duration)
+		_statXRuns.fetchAdd(1, Common::kMemoryOrderRelaxed);
+	if (elapsed > _statMaxCallbackTime.load(Common::kMemoryOrderRelaxed))
+		_statMaxCallbackTime.store(elapsed, Common::kMemoryOrderRelaxed);
+}
 
+int MixerImpl::mixChannels(byte *samples, uint len) {
 	int16 *buf = (int16 *)samples;
 
 	// Since the mixer callback has been called, the mixer must be ready...
@@ -325,8 +515,13 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
+				if (!_lockFree) {
+					delete _channels[i];
+					_channels[i] = nullptr;
+				} else if (_retiredChannels.push(_channels[i])) {
+					// The engine side deletes the channel for us
+					_channels[i] = nullptr;
+				}
 			} else if (!_channels[i]->isPaused()) {
 				tmp = _channels[i]->mix(buf, len);
 
@@ -340,6 +535,16 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		deleteRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channelStates[i].chan != nullptr && !_channelStates[i].permanent)
+				retireChannel(i);
+		}
+		return;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
 			delete _channels[i];
@@ -350,6 +555,16 @@ void MixerImpl::stopAll() {
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		deleteRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channelStates[i].chan != nullptr && _channelStates[i].id == id)
+				retireChannel(i);
+		}
+		return;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
 			delete _channels[i];
@@ -361,6 +576,13 @@ void MixerImpl::stopID(int id) {
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		const int index = findChannelState(handle);
+		if (index != -1)
+			retireChannel(index);
+		return;
+	}
+
 	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -374,6 +596,16 @@ void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 	_soundTypeSettings[type].mute = mute;
 
+	if (_lockFree) {
+		Common::StackLock lock(_mutex);
+		deleteRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (_channelStates[i].chan && _channelStates[i].type == type)
+				pushCommand(kCommandGlobalVolume, i);
+		}
+		return;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
 		if (_channels[i] && _channels[i]->getType() == type)
 			_channels[i]->notifyGlobalVolChange();
@@ -388,6 +620,15 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		const int index = findChannelState(handle);
+		if (index != -1) {
+			_channelStates[index].volume = volume;
+			pushCommand(kCommandVolume, index, volume);
+		}
+		return;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
@@ -396,6 +637,12 @@ void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
+	if (_lockFree) {
+		Common::StackLock lock(_mutex);
+		const int index = findChannelState(handle);
+		return index != -1 ? _channelStates[index].volume : 0;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -406,6 +653,15 @@ byte MixerImpl::getChannelVolume(SoundHandle handle) {
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		const int index = findChannelState(handle);
+		if (index != -1) {
+			_channelStates[index].balance = balance;
+			pushCommand(kCommandBalance, index, balance);
+		}
+		return;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
@@ -414,6 +670,12 @@ void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
+	if (_lockFree) {
+		Common::StackLock lock(_mutex);
+		const int index = findChannelState(handle);
+		return index != -1 ? _channelStates[index].balance : 0;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -424,6 +686,15 @@ int8 MixerImpl::getChannelBalance(SoundHandle handle) {
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		const int index = findChannelState(handle);
+		if (index != -1) {
+			_channelStates[index].rate = rate;
+			pushCommand(kCommandRate, index, rate);
+		}
+		return;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
@@ -432,6 +703,12 @@ void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) {
+	if (_lockFree) {
+		Common::StackLock lock(_mutex);
+		const int index = findChannelState(handle);
+		return index != -1 ? _channelStates[index].rate : 0;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -442,6 +719,15 @@ uint32 MixerImpl::getChannelRate(SoundHandle handle) {
 void MixerImpl::resetChannelRate(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		const int index = findChannelState(handle);
+		if (index != -1) {
+			_channelStates[index].rate = _channelStates[index].nativeRate;
+			pushCommand(kCommandResetRate, index);
+		}
+		return;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
@@ -456,6 +742,14 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		const int index = findChannelState(handle);
+		if (index == -1)
+			return Timestamp(0, _sampleRate);
+
+		return _channelStates[index].chan->getElapsedTime();
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return Timestamp(0, _sampleRate);
@@ -466,6 +760,13 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 void MixerImpl::loopChannel(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		const int index = findChannelState(handle);
+		if (index != -1)
+			pushCommand(kCommandLoop, index);
+		return;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
@@ -475,6 +776,15 @@ void MixerImpl::loopChannel(SoundHandle handle) {
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		deleteRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channelStates[i].chan != nullptr)
+				pushCommand(kCommandPause, i, paused);
+		}
+		return;
+	}
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr) {
 			_channels[i]->pause(paused);
@@ -484,6 +794,17 @@ void MixerImpl::pauseAll(bool paused) {
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		deleteRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channelStates[i].chan != nullptr && _channelStates[i].id == id) {
+				pushCommand(kCommandPause, i, paused);
+				return;
+			}
+		}
+		return;
+	}
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
 			_channels[i]->pause(paused);
@@ -495,6 +816,13 @@ void MixerImpl::pauseID(int id, bool paused) {
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		const int index = findChannelState(handle);
+		if (index != -1)
+			pushCommand(kCommandPause, index, paused);
+		return;
+	}
+
 	// Simply ignore (un)pause requests for sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -510,6 +838,14 @@ bool MixerImpl::isSoundIDActive(int id) {
 	g_eventRec.updateSubsystems();
 #endif
 
+	if (_lockFree) {
+		deleteRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			if (_channelStates[i].chan && _channelStates[i].id == id)
+				return true;
+		return false;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getId() == id)
 			return true;
@@ -518,6 +854,12 @@ bool MixerImpl::isSoundIDActive(int id) {
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		const int index = findChannelState(handle);
+		return index != -1 ? _channelStates[index].id : 0;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
 		return _channels[index]->getId();
@@ -531,12 +873,24 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	g_eventRec.updateSubsystems();
 #endif
 
+	if (_lockFree)
+		return findChannelState(handle) != -1;
+
 	const int index = handle._val % NUM_CHANNELS;
 	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		deleteRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			if (_channelStates[i].chan && _channelStates[i].type == type)
+				return true;
+		return false;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getType() == type)
 			return true;
@@ -555,6 +909,15 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
 
+	if (_lockFree) {
+		deleteRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (_channelStates[i].chan && _channelStates[i].type == type)
+				pushCommand(kCommandGlobalVolume, i);
+		}
+		return;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
 		if (_channels[i] && _channels[i]->getType() == type)
 			_channels[i]->notifyGlobalVolChange();
@@ -576,7 +939,7 @@ Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
 				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
 	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
+	  _pauseStartTime(0), _pauseTime(0), _timingSeq(0), _converter(nullptr), _volL(0), _volR(0),
 	  _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
@@ -652,9 +1015,20 @@ void Channel::updateChannelVolumes() {
 	}
 }
 
+void Channel::beginTimingUpdate() {
+	_timingSeq.fetchAdd(1, Common::kMemoryOrderRelaxed);
+	Common::atomicThreadFence(Common::kMemoryOrderRelease);
+}
+
+void Channel::endTimingUpdate() {
+	_timingSeq.fetchAdd(1, Common::kMemoryOrderRelease);
+}
+
 void Channel::pause(bool paused) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
+	beginTimingUpdate();
+
 	if (paused) {
 		_pauseLevel++;
 
@@ -668,6 +1042,8 @@ void Channel::pause(bool paused) {
 			_pauseStartTime = 0;
 		}
 	}
+
+	endTimingUpdate();
 }
 
 Timestamp Channel::getElapsedTime() {
@@ -676,17 +1052,30 @@ Timestamp Channel::getElapsedTime() {
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	// Take a consistent snapshot, in case the mixer is updating it right now
+	uint32 seq, samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime;
+	bool paused;
+	do {
+		seq = _timingSeq.load(Common::kMemoryOrderAcquire);
+		samplesConsumed = _samplesConsumed;
+		mixerTimeStamp = _mixerTimeStamp;
+		pauseStartTime = _pauseStartTime;
+		pauseTime = _pauseTime;
+		paused = isPaused();
+		Common::atomicThreadFence(Common::kMemoryOrderAcquire);
+	} while ((seq & 1) || seq != _timingSeq.load(Common::kMemoryOrderRelaxed));
+
+	if (mixerTimeStamp == 0)
 		return ts;
 
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
+	if (paused)
+		delta = pauseStartTime - mixerTimeStamp;
 	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
+		delta = g_system->getMillis(true) - mixerTimeStamp - pauseTime;
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -713,9 +1102,12 @@ int Channel::mix(int16 *data, uint len) {
 
 	int res = 0;
 	if (!_stream->endOfData() || _converter->needsDraining()) {
+		beginTimingUpdate();
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis(true);
 		_pauseTime = 0;
+		endTimingUpdate();
+
 		res = _converter->convert(*_stream, data, len, _volL, _volR);
 		_samplesDecoded += res;
 	}
@@ -24,6 +24,7 @@
 
 #include "common/scummsys.h"
 #include "common/mutex.h"
+#include "common/spsc-queue.h"
 #include "audio/mixer.h"
 
 namespace Audio {
@@ -53,9 +54,32 @@ namespace Audio {
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
  *
+ * By default, all methods and the mixer callback are serialized through the
+ * mixer mutex. In lock-free mode, the methods instead record their changes
+ * in a command queue which mixCallback() applies before mixing, so that the
+ * audio thread never waits for an engine thread. Finished and stopped
+ * channels are handed back and deleted on the engine side. Note that in this
+ * mode locking mutex() no longer keeps the mixer from reading the streams,
+ * so it is only suitable for engines which do not rely on that. Lock-free
+ * mode also needs ATOMICS_ARE_LOCK_FREE, without it the mutex is always used.
+ *
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
+public:
+	/**
+	 * Statistics about the mixer callback, to measure how well the audio
+	 * thread keeps up. The xruns and the callback times are only measured
+	 * while the debug level is at least 1, at which the mixer reports them
+	 * when it is destroyed.
+	 */
+	struct Stats {
+		uint32 callbacks;       ///< Number of calls to mixCallback().
+		uint32 xruns;           ///< Calls that took longer than the audio they produced.
+		uint32 maxCallbackTime; ///< Longest call to mixCallback(), in milliseconds.
+		uint32 commandStalls;   ///< Times an engine thread had to wait for room in the command queue.
+	};
+
 private:
 	enum {
 		NUM_CHANNELS = 32
@@ -66,27 +90,90 @@ private:
 	const uint _sampleRate;
 	const bool _stereo;
 	const uint _outBufSize;
-	bool _mixerReady;
+	const bool _lockFree;
+	Common::Atomic<bool> _mixerReady;
 	uint32 _handleSeed;
 
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
 
-		bool mute;
-		int volume;
+		Common::Atomic<bool> mute;
+		Common::Atomic<int> volume;
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	enum CommandType {
+		kCommandAdd,
+		kCommandStop,
+		kCommandPause,
+		kCommandVolume,
+		kCommandBalance,
+		kCommandRate,
+		kCommandResetRate,
+		kCommandLoop,
+		kCommandGlobalVolume
+	};
+
+	/** A change to a channel, queued for the mixer callback in lock-free mode. */
+	struct Command {
+		CommandType type;
+		int index;
+		Channel *chan;
+		int value;
+	};
+
+	/**
+	 * The engine side view of a channel in lock-free mode. This is only
+	 * accessed with the mutex held and never by the mixer callback.
+	 */
+	struct ChannelState {
+		ChannelState() : chan(nullptr), handle(0), id(-1), type(kPlainSoundType), permanent(false),
+			volume(kMaxChannelVolume), balance(0), rate(0), nativeRate(0) {}
+
+		Channel *chan;
+		uint32 handle;
+		int id;
+		SoundType type;
+		bool permanent;
+		byte volume;
+		int8 balance;
+		uint32 rate;
+		uint32 nativeRate;
+	};
+
+	ChannelState _channelStates[NUM_CHANNELS];
+	Common::SPSCQueue<Command, 256> _commands;
+	Common::SPSCQueue<Channel *, 64> _retiredChannels;
+
+	Common::Atomic<uint32> _statCallbacks;
+	Common::Atomic<uint32> _statXRuns;
+	Common::Atomic<uint32> _statMaxCallbackTime;
+	uint32 _statCommandStalls;
+
+	int mixChannels(byte *samples, uint len);
+	void updateStats(uint len, bool timed, uint32 start);
+
+	void pushCommand(CommandType type, int index, int value = 0);
+	void processCommands();
+	void deleteRetiredChannels();
+	void retireChannel(int index);
+	int findChannelState(SoundHandle handle);
 
 public:
 
-	MixerImpl(uint sampleRate, bool stereo = true, uint outBufSize = 0);
+	MixerImpl(uint sampleRate, bool stereo = true, uint outBufSize = 0, bool lockFree = false);
 	~MixerImpl();
 
 	virtual bool isReady() const { Common::StackLock lock(_mutex); return _mixerReady; }
 
+	/** Whether the mixer callback runs without taking the mixer mutex. */
+	bool isLockFree() const { return _lockFree; }
+
+	/** Return a snapshot of the mixer callback statistics. */
+	Stats getStats() const;
+
 	virtual Common::Mutex &mutex() { return _mutex; }
 
 	virtual void playStream(
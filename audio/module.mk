@@ -109,5 +109,21 @@ MODULE_OBJS += \
 	rwopl3.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	rate-neon.o
+$(MODULE)/rate-neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	rate-sse2.o
+$(MODULE)/rate-sse2.o: CXXFLAGS += -msse2
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	rate-avx2.o
+$(MODULE)/rate-avx2.o: CXXFLAGS += -mavx2
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include <immintrin.h>
+
+#include "audio/rate_intern.h"
+
+namespace Audio {
+
+// Divide by kMaxMixerVolume, rounding towards zero like the C division does
+static FORCEINLINE __m256i avx2_divVol(__m256i p) {
+	return _mm256_srai_epi32(_mm256_add_epi32(p, _mm256_srli_epi32(_mm256_srai_epi32(p, 31), 24)), 8);
+}
+
+// Divide by two, rounding towards zero like the C division does
+static FORCEINLINE __m256i avx2_half(__m256i s) {
+	return _mm256_srai_epi32(_mm256_add_epi32(s, _mm256_srli_epi32(s, 31)), 1);
+}
+
+// Saturate-add eight 32-bit values to eight samples in the output buffer
+static FORCEINLINE void avx2_mixOut(st_sample_t *outBuffer, __m256i v) {
+	__m256i out = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)outBuffer));
+	v = _mm256_add_epi32(v, out);
+	_mm_storeu_si128((__m128i *)outBuffer, _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+}
+
+/**
+ * Mixes eight frames at a time. Mono input is duplicated into both channels
+ * first, so that every combination can share the stereo code.
+ */
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void rateMixAVX2(st_sample_t *outBuffer, const st_sample_t *inBuffer, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m256i vol = reverseStereo ? _mm256_setr_epi32(volR, volL, volR, volL, volR, volL, volR, volL) : _mm256_setr_epi32(volL, volR, volL, volR, volL, volR, volL, volR);
+
+	for (; numFrames >= 8; numFrames -= 8) {
+		__m128i in0, in1;
+		if (inStereo) {
+			in0 = _mm_loadu_si128((const __m128i *)inBuffer);
+			in1 = _mm_loadu_si128((const __m128i *)(inBuffer + 8));
+			if (reverseStereo) {
+				in0 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(in0, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+				in1 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(in1, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+			}
+			inBuffer += 16;
+		} else {
+			__m128i in = _mm_loadu_si128((const __m128i *)inBuffer);
+			in0 = _mm_unpacklo_epi16(in, in);
+			in1 = _mm_unpackhi_epi16(in, in);
+			inBuffer += 8;
+		}
+
+		__m256i lo = avx2_divVol(_mm256_mullo_epi32(_mm256_cvtepi16_epi32(in0), vol));
+		__m256i hi = avx2_divVol(_mm256_mullo_epi32(_mm256_cvtepi16_epi32(in1), vol));
+
+		if (outStereo) {
+			avx2_mixOut(outBuffer, lo);
+			avx2_mixOut(outBuffer + 8, hi);
+			outBuffer += 16;
+		} else {
+			// Add the left and right channel of each frame, then undo the
+			// lane interleaving of the horizontal add
+			__m256i sum = _mm256_permute4x64_epi64(_mm256_hadd_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+			avx2_mixOut(outBuffer, avx2_half(sum));
+			outBuffer += 8;
+		}
+	}
+
+	rateMixGeneric<inStereo, outStereo, reverseStereo>(outBuffer, inBuffer, numFrames, volL, volR);
+}
+
+const RateMixFuncs rateMixFuncsAVX2 = {{
+	{
+		{ rateMixAVX2<false, false, false>, rateMixAVX2<false, false, true> },
+		{ rateMixAVX2<false, true, false>, rateMixAVX2<false, true, true> }
+	},
+	{
+		{ rateMixAVX2<true, false, false>, rateMixAVX2<true, false, true> },
+		{ rateMixAVX2<true, true, false>, rateMixAVX2<true, true, true> }
+	}
+}};
+
+} // End of namespace Audio
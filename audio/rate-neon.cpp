@@ -0,0 +1,96 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+#include <arm_neon.h>
+
+#include "audio/rate_intern.h"
+
+namespace Audio {
+
+// Divide by kMaxMixerVolume, rounding towards zero like the C division does
+static FORCEINLINE int32x4_t neon_divVol(int32x4_t p) {
+	return vshrq_n_s32(vaddq_s32(p, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p, 31)), 24))), 8);
+}
+
+// Divide by two, rounding towards zero like the C division does
+static FORCEINLINE int32x4_t neon_half(int32x4_t s) {
+	return vshrq_n_s32(vaddq_s32(s, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(s), 31))), 1);
+}
+
+// Saturate-add four 32-bit values to four samples
+static FORCEINLINE int16x4_t neon_mix(int16x4_t out, int32x4_t v) {
+	return vqmovn_s32(vaddq_s32(vmovl_s16(out), v));
+}
+
+/**
+ * Mixes four frames at a time. The stereo loads and stores deinterleave the
+ * channels, so the left and right channel are processed in separate vectors.
+ */
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void rateMixNEON(st_sample_t *outBuffer, const st_sample_t *inBuffer, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	for (; numFrames >= 4; numFrames -= 4) {
+		int16x4_t inL, inR;
+		if (inStereo) {
+			int16x4x2_t in = vld2_s16(inBuffer);
+			inL = in.val[0];
+			inR = in.val[1];
+			inBuffer += 8;
+		} else {
+			inL = inR = vld1_s16(inBuffer);
+			inBuffer += 4;
+		}
+
+		int32x4_t outL = neon_divVol(vmull_n_s16(inL, (int16)volL));
+		int32x4_t outR = neon_divVol(vmull_n_s16(inR, (int16)volR));
+
+		if (outStereo) {
+			int16x4x2_t out = vld2_s16(outBuffer);
+			out.val[reverseStereo    ] = neon_mix(out.val[reverseStereo    ], outL);
+			out.val[reverseStereo ^ 1] = neon_mix(out.val[reverseStereo ^ 1], outR);
+			vst2_s16(outBuffer, out);
+			outBuffer += 8;
+		} else {
+			int16x4_t out = vld1_s16(outBuffer);
+			vst1_s16(outBuffer, neon_mix(out, neon_half(vaddq_s32(outL, outR))));
+			outBuffer += 4;
+		}
+	}
+
+	rateMixGeneric<inStereo, outStereo, reverseStereo>(outBuffer, inBuffer, numFrames, volL, volR);
+}
+
+const RateMixFuncs rateMixFuncsNEON = {{
+	{
+		{ rateMixNEON<false, false, false>, rateMixNEON<false, false, true> },
+		{ rateMixNEON<false, true, false>, rateMixNEON<false, true, true> }
+	},
+	{
+		{ rateMixNEON<true, false, false>, rateMixNEON<true, false, true> },
+		{ rateMixNEON<true, true, false>, rateMixNEON<true, true, true> }
+	}
+}};
+
+} // End of namespace Audio
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include <immintrin.h>
+
+#include "audio/rate_intern.h"
+
+namespace Audio {
+
+// Divide by kMaxMixerVolume, rounding towards zero like the C division does
+static FORCEINLINE __m128i sse2_divVol(__m128i p) {
+	return _mm_srai_epi32(_mm_add_epi32(p, _mm_srli_epi32(_mm_srai_epi32(p, 31), 24)), 8);
+}
+
+// Divide by two, rounding towards zero like the C division does
+static FORCEINLINE __m128i sse2_half(__m128i s) {
+	return _mm_srai_epi32(_mm_add_epi32(s, _mm_srli_epi32(s, 31)), 1);
+}
+
+// Multiply eight samples by the matching volumes, giving 32-bit results
+static FORCEINLINE void sse2_scale(__m128i in, __m128i vol, __m128i &lo, __m128i &hi) {
+	__m128i pl = _mm_mullo_epi16(in, vol);
+	__m128i ph = _mm_mulhi_epi16(in, vol);
+	lo = sse2_divVol(_mm_unpacklo_epi16(pl, ph));
+	hi = sse2_divVol(_mm_unpackhi_epi16(pl, ph));
+}
+
+// Sign extend the low/high four samples to 32 bits
+static FORCEINLINE __m128i sse2_extendLo(__m128i v) {
+	return _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+}
+
+static FORCEINLINE __m128i sse2_extendHi(__m128i v) {
+	return _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+}
+
+/**
+ * Mixes four frames at a time. Mono input is duplicated into both channels
+ * first, so that every combination can share the stereo code.
+ */
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static void rateMixSSE2(st_sample_t *outBuffer, const st_sample_t *inBuffer, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	const __m128i vol = reverseStereo ? _mm_set1_epi32(volR | (volL << 16)) : _mm_set1_epi32(volL | (volR << 16));
+
+	for (; numFrames >= 4; numFrames -= 4) {
+		__m128i in;
+		if (inStereo) {
+			in = _mm_loadu_si128((const __m128i *)inBuffer);
+			if (reverseStereo)
+				in = _mm_shufflehi_epi16(_mm_shufflelo_epi16(in, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+			inBuffer += 8;
+		} else {
+			in = _mm_loadl_epi64((const __m128i *)inBuffer);
+			in = _mm_unpacklo_epi16(in, in);
+			inBuffer += 4;
+		}
+
+		__m128i lo, hi;
+		sse2_scale(in, vol, lo, hi);
+
+		if (outStereo) {
+			__m128i out = _mm_loadu_si128((const __m128i *)outBuffer);
+			lo = _mm_add_epi32(lo, sse2_extendLo(out));
+			hi = _mm_add_epi32(hi, sse2_extendHi(out));
+			_mm_storeu_si128((__m128i *)outBuffer, _mm_packs_epi32(lo, hi));
+			outBuffer += 8;
+		} else {
+			// Add the left and right channel of each frame
+			lo = _mm_add_epi32(lo, _mm_srli_si128(lo, 4));
+			hi = _mm_add_epi32(hi, _mm_srli_si128(hi, 4));
+			lo = _mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 1, 2, 0));
+			hi = _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 1, 2, 0));
+			__m128i sum = sse2_half(_mm_unpacklo_epi64(lo, hi));
+
+			__m128i out = _mm_loadl_epi64((const __m128i *)outBuffer);
+			sum = _mm_add_epi32(sum, sse2_extendLo(out));
+			_mm_storel_epi64((__m128i *)outBuffer, _mm_packs_epi32(sum, sum));
+			outBuffer += 4;
+		}
+	}
+
+	rateMixGeneric<inStereo, outStereo, reverseStereo>(outBuffer, inBuffer, numFrames, volL, volR);
+}
+
+const RateMixFuncs rateMixFuncsSSE2 = {{
+	{
+		{ rateMixSSE2<false, false, false>, rateMixSSE2<false, false, true> },
+		{ rateMixSSE2<false, true, false>, rateMixSSE2<false, true, true> }
+	},
+	{
+		{ rateMixSSE2<true, false, false>, rateMixSSE2<true, false, true> },
+		{ rateMixSSE2<true, true, false>, rateMixSSE2<true, true, true> }
+	}
+}};
+
+} // End of namespace Audio
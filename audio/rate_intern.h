@@ -0,0 +1,108 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "common/scummsys.h"
+#include "audio/rate.h"
+#include "audio/mixer.h"
+
+namespace Audio {
+
+/**
+ * Applies the channel volumes to @p numFrames frames of (already resampled)
+ * input and mixes them into @p outBuffer with saturation.
+ *
+ * The input is laid out like the source stream (mono or interleaved stereo),
+ * the output like the mixer buffer.
+ */
+typedef void (*RateMixFunc)(st_sample_t *outBuffer, const st_sample_t *inBuffer, st_size_t numFrames, st_volume_t volL, st_volume_t volR);
+
+/**
+ * A set of mixing kernels, indexed by [inStereo][outStereo][reverseStereo].
+ */
+struct RateMixFuncs {
+	RateMixFunc mix[2][2][2];
+};
+
+extern const RateMixFuncs rateMixFuncsGeneric;
+#ifdef SCUMMVM_NEON
+extern const RateMixFuncs rateMixFuncsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+extern const RateMixFuncs rateMixFuncsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+extern const RateMixFuncs rateMixFuncsAVX2;
+#endif
+
+/**
+ * The kernels used by the rate converters. This is selected at runtime
+ * depending on the CPU features on first use, and is only exposed here
+ * so that the unit tests can compare the implementations.
+ */
+extern const RateMixFuncs *rateMixFuncs;
+
+/**
+ * The reference implementation all the SIMD kernels have to match exactly.
+ * They use it for the frames that do not fill a whole vector.
+ */
+template<bool inStereo, bool outStereo, bool reverseStereo>
+static inline void rateMixGeneric(st_sample_t *outBuffer, const st_sample_t *inBuffer, st_size_t numFrames, st_volume_t volL, st_volume_t volR) {
+	while (numFrames--) {
+		st_sample_t inL, inR;
+		inL = *inBuffer++;
+		inR = (inStereo ? *inBuffer++ : inL);
+
+		st_sample_t outL, outR;
+		outL = (inL * (int)volL) / Audio::Mixer::kMaxMixerVolume;
+		outR = (inR * (int)volR) / Audio::Mixer::kMaxMixerVolume;
+
+		if (outStereo) {
+			// Output left channel
+			clampedAdd(outBuffer[reverseStereo    ], outL);
+
+			// Output right channel
+			clampedAdd(outBuffer[reverseStereo ^ 1], outR);
+
+			outBuffer += 2;
+		} else {
+			// Output mono channel
+			clampedAdd(outBuffer[0], (outL + outR) / 2);
+
+			outBuffer += 1;
+		}
+	}
+}
+
+/**
+ * The SIMD kernels rely on the division by kMaxMixerVolume being a shift and
+ * on the scaled samples fitting into 16 bits, so they only handle volumes the
+ * mixer can actually produce and leave anything else to the generic code.
+ */
+static inline bool rateMixCanUseSIMD(st_volume_t volL, st_volume_t volR) {
+	return Audio::Mixer::kMaxMixerVolume == 256 && volL <= Audio::Mixer::kMaxMixerVolume && volR <= Audio::Mixer::kMaxMixerVolume;
+}
+
+} // End of namespace Audio
+
+#endif
@@ -25,6 +25,7 @@
 
 #include "common/system.h"
 #include "common/config-manager.h"
+#include "common/profiler.h"
 #include "common/translation.h"
 #include "backends/events/default/default-events.h"
 #include "backends/keymapper/action.h"
@@ -82,6 +83,10 @@ void DefaultEventManager::init() {
 bool DefaultEventManager::pollEvent(Common::Event &event) {
 	_dispatcher.dispatch();
 
+	// Drain the profiler on backends which never end a frame
+	if (Common::Profiler::isEnabled())
+		Common::Profiler::instance().collectZones();
+
 	if (g_engine)
 		// Handle autosaves if enabled
 		g_engine->handleAutoSave();
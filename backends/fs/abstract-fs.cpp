@@ -39,3 +39,11 @@ const char *AbstractFSNode::lastPathComponent(const Common::String &str, const c
 Common::SeekableReadStream *AbstractFSNode::createReadStreamForAltStream(Common::AltStreamType altStreamType) {
 	return nullptr;
 }
+
+Common::MappedReadStream *AbstractFSNode::createMappedReadStream() {
+	return nullptr;
+}
+
+bool AbstractFSNode::getFileStats(int64 &size, int64 &modificationTime) const {
+	return false;
+}
@@ -192,6 +192,25 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStreamForAltStream(Common::AltStreamType altStreamType);
 
+	/**
+	 * Creates a MappedReadStream instance corresponding to the file
+	 * referred by this node, by mapping the file into memory. This
+	 * assumes that the node actually refers to a readable file. If this
+	 * is not the case, or the backend can't map files, 0 is returned.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::MappedReadStream *createMappedReadStream();
+
+	/**
+	 * Retrieves the size and the time of the last modification of the file
+	 * referred by this node, as reported by the file system. The time is
+	 * only meant to be compared with other values returned by this method.
+	 *
+	 * @return true if the information is available, false otherwise
+	 */
+	virtual bool getFileStats(int64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -72,6 +72,17 @@ public:
 	 * root.
 	 */
 	virtual Common::String getSystemFullPath(const Common::String& path) const { return path; }
+
+	/**
+	 * Returns whether the nodes may be used from several threads at the same
+	 * time, provided each node is only used by a single thread. This covers
+	 * listing directories and reading files, and implies that doing so never
+	 * logs or otherwise calls into the backend.
+	 *
+	 * Since most implementations have not been checked for this, the default
+	 * is to only access the file system from the main thread.
+	 */
+	virtual bool supportsThreadedAccess() const { return false; }
 };
 
 #endif /*FILESYSTEM_FACTORY_H*/
@@ -34,6 +34,10 @@ protected:
 	AbstractFSNode *makeRootFileNode() const override;
 	AbstractFSNode *makeCurrentDirectoryFileNode() const override;
 	AbstractFSNode *makeFileNodePath(const Common::String &path) const override;
+
+public:
+	// The nodes only use reentrant system calls, and keep no shared state
+	bool supportsThreadedAccess() const override { return true; }
 };
 
 #endif /*POSIX_FILESYSTEM_FACTORY_H*/
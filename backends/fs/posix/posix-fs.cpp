@@ -34,6 +34,7 @@
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/posix/posix-iostream.h"
 #include "common/algorithm.h"
+#include "common/memstream.h"
 
 #include <sys/param.h>
 #include <sys/stat.h>
@@ -49,6 +50,9 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
+#ifdef HAS_MMAP
+#include <sys/mman.h>
+#endif
 
 #ifdef __OS2__
 #define INCL_DOS
@@ -280,6 +284,54 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStreamForAltStream(Co
 	return nullptr;
 }
 
+#ifdef HAS_MMAP
+namespace {
+
+struct MunmapDeleter {
+	size_t size;
+
+	void operator()(byte *data) {
+		munmap(data, size);
+	}
+};
+
+} // End of anonymous namespace
+
+Common::MappedReadStream *POSIXFilesystemNode::createMappedReadStream() {
+	int fd = open(_path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	// Empty files can't be mapped, and memory streams can't address
+	// more than 4 GB
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_size <= 0 || (uint64)st.st_size > 0xFFFFFFFF) {
+		close(fd);
+		return nullptr;
+	}
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after the file is closed
+	close(fd);
+	if (data == MAP_FAILED)
+		return nullptr;
+
+	MunmapDeleter deleter;
+	deleter.size = st.st_size;
+	return new Common::MappedReadStream(Common::SharedPtr<byte>((byte *)data, deleter), (uint32)st.st_size);
+}
+#endif
+
+bool POSIXFilesystemNode::getFileStats(int64 &size, int64 &modificationTime) const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+		return false;
+
+	size = st.st_size;
+	modificationTime = st.st_mtime;
+	return true;
+}
+
 Common::SeekableWriteStream *POSIXFilesystemNode::createWriteStream() {
 	return PosixIoStream::makeFromPath(getPath(), true);
 }
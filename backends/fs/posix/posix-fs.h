@@ -67,6 +67,10 @@ public:
 
 	Common::SeekableReadStream *createReadStream() override;
 	Common::SeekableReadStream *createReadStreamForAltStream(Common::AltStreamType altStreamType) override;
+#ifdef HAS_MMAP
+	Common::MappedReadStream *createMappedReadStream() override;
+#endif
+	bool getFileStats(int64 &size, int64 &modificationTime) const override;
 	Common::SeekableWriteStream *createWriteStream() override;
 	bool createDirectory() override;
 
@@ -685,6 +685,7 @@ void ScaledTexture::setScaler(uint scalerIndex, int scaleFactor) {
 		_scaler = scalerPlugin.createInstance(_format);
 	}
 	_scaler->setFactor(scaleFactor);
+	_scaler->setThreadCount(scalerPlugin.isBandSafe() ? ScalerMan.getThreadCount() : 1);
 
 	_scalerIndex = scalerIndex;
 	_scaleFactor = _scaler->getFactor();
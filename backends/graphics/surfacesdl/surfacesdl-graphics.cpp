@@ -25,6 +25,7 @@
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #include "backends/events/sdl/sdl-events.h"
 #include "common/config-manager.h"
+#include "common/debug.h"
 #include "common/mutex.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
@@ -136,7 +137,7 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 #endif
 	_transactionMode(kTransactionNone),
 	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
-	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _numPrevDirtyRects(0),
+	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false),
 	_prevCursorNeedsRedraw(false),
 	_mouseKeyColor(0) {
 
@@ -158,6 +159,8 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_mouseLastRect.x = _mouseLastRect.y = _mouseLastRect.w = _mouseLastRect.h = 0;
 	_mouseNextRect.x = _mouseNextRect.y = _mouseNextRect.w = _mouseNextRect.h = 0;
 
+	_dirtyStats.dirtyPixels = _dirtyStats.scaledPixels = _dirtyStats.numRects = 0;
+
 #ifdef USE_SDL_DEBUG_FOCUSRECT
 	if (ConfMan.hasKey("use_sdl_debug_focusrect"))
 		_enableFocusRectDebugCode = ConfMan.getBool("use_sdl_debug_focusrect");
@@ -368,6 +371,7 @@ OSystem::TransactionError SurfaceSdlGraphicsManager::endGFXTransaction() {
 
 			_videoMode.scalerIndex = _oldVideoMode.scalerIndex;
 			_videoMode.scaleFactor = _oldVideoMode.scaleFactor;
+			_videoMode.scalerThreads = _oldVideoMode.scalerThreads;
 		}
 
 #if SDL_VERSION_ATLEAST(2, 0, 0)
@@ -641,7 +645,8 @@ bool SurfaceSdlGraphicsManager::setScaler(uint mode, int factor) {
 
 	assert(_transactionMode == kTransactionActive);
 
-	if (_oldVideoMode.setup && _oldVideoMode.scalerIndex == mode && _oldVideoMode.scaleFactor == factor)
+	uint threads = ScalerMan.getThreadCount();
+	if (_oldVideoMode.setup && _oldVideoMode.scalerIndex == mode && _oldVideoMode.scaleFactor == factor && _oldVideoMode.scalerThreads == threads)
 		return true;
 
 	int newFactor;
@@ -661,6 +666,7 @@ bool SurfaceSdlGraphicsManager::setScaler(uint mode, int factor) {
 
 	_videoMode.scalerIndex = mode;
 	_videoMode.scaleFactor = newFactor;
+	_videoMode.scalerThreads = threads;
 
 	return true;
 }
@@ -686,6 +692,7 @@ void SurfaceSdlGraphicsManager::setGraphicsModeIntern() {
 	}
 
 	_scaler->setFactor(_videoMode.scaleFactor);
+	_scaler->setThreadCount(_scalerPlugin->isBandSafe() ? _videoMode.scalerThreads : 1);
 	_extraPixels = _scalerPlugin->extraPixels();
 	_useOldSrc = _scalerPlugin->useOldSource();
 	if (_useOldSrc) {
@@ -925,6 +932,11 @@ bool SurfaceSdlGraphicsManager::loadGFXMode() {
 
 	setupHardwareSize();
 
+	// The dirty areas are tracked in the coordinates of whichever of the
+	// game screen and the overlay is visible
+	_dirtyRegion.setSize(MAX(_videoMode.screenWidth, _videoMode.overlayWidth), MAX(_videoMode.screenHeight, _videoMode.overlayHeight));
+	_realDirtyRects.clear();
+
 	//
 	// Create the surface that contains the game data
 	//
@@ -1306,40 +1318,73 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 	// In case of double buferring partially good version may be on another page,
 	// so we need to fully redraw
-	if (_isDoubleBuf && _numDirtyRects)
+	if (_isDoubleBuf && (!_dirtyRegion.isEmpty() || !_realDirtyRects.empty()))
 		_forceRedraw = true;
 
 	bool doRedraw = _forceRedraw || (_prevForceRedraw && _isDoubleBuf);
-	int actualDirtyRects = _numDirtyRects;
-	if (_isDoubleBuf && _numPrevDirtyRects > 0) {
-		memcpy(_dirtyRectList + _numDirtyRects, _prevDirtyRectList, _numPrevDirtyRects * sizeof(_dirtyRectList[0]));
-		actualDirtyRects += _numPrevDirtyRects;
-	}
 
 	// Force a full redraw if requested.
 	// If _useOldSrc, the scaler will do its own partial updates.
+	_dirtyRects.clear();
+	uint numStretchableRects;
 	if (doRedraw) {
-		actualDirtyRects = 1;
-		_dirtyRectList[0].x = 0;
-		_dirtyRectList[0].y = 0;
-		_dirtyRectList[0].w = width;
-		_dirtyRectList[0].h = height;
+		_dirtyStats.dirtyPixels = width * height;
+		_dirtyRects.push_back(Common::Rect(width, height));
+		numStretchableRects = 1;
+	} else {
+		_dirtyStats.dirtyPixels = _dirtyRegion.getAddedPixels();
+		_dirtyRegion.getRects(_dirtyRects);
+		numStretchableRects = _dirtyRects.size();
+
+		for (uint i = 0; i < _realDirtyRects.size(); i++) {
+			_dirtyStats.dirtyPixels += _realDirtyRects[i].width() * _realDirtyRects[i].height();
+			_dirtyRects.push_back(_realDirtyRects[i]);
+		}
 	}
 
 	_prevForceRedraw = _forceRedraw;
-	if (!_prevForceRedraw && _numDirtyRects && _isDoubleBuf) {
-		memcpy(_prevDirtyRectList, _dirtyRectList, _numDirtyRects * sizeof(_dirtyRectList[0]));
-		_numPrevDirtyRects = _numDirtyRects;
+
+	// The tiles may cover parts of the overlay outside of the game screen,
+	// and their edges need to be moved to lines that survive the aspect
+	// ratio correction. Rects in real coordinates are left as they are.
+	_dirtyRectList.clear();
+	_dirtyStats.scaledPixels = 0;
+	for (uint i = 0; i < _dirtyRects.size(); i++) {
+		int x = _dirtyRects[i].left;
+		int y = _dirtyRects[i].top;
+		int w = MIN<int>(_dirtyRects[i].right, width) - x;
+		int h = MIN<int>(_dirtyRects[i].bottom, height) - y;
+
+#ifdef USE_ASPECT
+		if (_videoMode.aspectRatioCorrection && !_overlayInGUI && i < numStretchableRects)
+			makeRectStretchable(x, y, w, h, _videoMode.filtering);
+#endif
+
+		if (w <= 0 || h <= 0)
+			continue;
+
+		SDL_Rect r;
+		r.x = x;
+		r.y = y;
+		r.w = w;
+		r.h = h;
+		_dirtyRectList.push_back(r);
+		_dirtyStats.scaledPixels += w * h;
 	}
+	_dirtyStats.numRects = _dirtyRectList.size();
+
+	int actualDirtyRects = _dirtyRectList.size();
 
 	// Only draw anything if necessary
 	if (actualDirtyRects > 0 || _cursorNeedsRedraw) {
 		SDL_Rect *r;
 		SDL_Rect dst;
 		uint32 bpp, srcPitch, dstPitch;
-		SDL_Rect *lastRect = _dirtyRectList + actualDirtyRects;
+		SDL_Rect *lastRect = _dirtyRectList.data() + actualDirtyRects;
+
+		debug(9, "SurfaceSdlGraphicsManager: Dirty %u pixels, scaled %u pixels in %u rects", _dirtyStats.dirtyPixels, _dirtyStats.scaledPixels, _dirtyStats.numRects);
 
-		for (r = _dirtyRectList; r != lastRect; ++r) {
+		for (r = _dirtyRectList.data(); r != lastRect; ++r) {
 			dst = *r;
 			dst.x += _maxExtraPixels;	// Shift rect since some scalers need to access the data around
 			dst.y += _maxExtraPixels;	// any pixel to scale it, and we want to avoid mem access crashes.
@@ -1355,7 +1400,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		srcPitch = srcSurf->pitch;
 		dstPitch = _hwScreen->pitch;
 
-		for (r = _dirtyRectList; r != lastRect; ++r) {
+		for (r = _dirtyRectList.data(); r != lastRect; ++r) {
 			int src_x = r->x;
 			int src_y = r->y;
 			int dst_x = r->x;
@@ -1510,14 +1555,15 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 		// Finally, blit all our changes to the screen
 		if (!_displayDisabled) {
-			updateScreen(_dirtyRectList, actualDirtyRects);
+			updateScreen(_dirtyRectList.data(), actualDirtyRects);
 		}
 	}
 
 	// Set up the old scale factor
 	_scaler->setFactor(oldScaleFactor);
 
-	_numDirtyRects = 0;
+	_dirtyRegion.clear();
+	_realDirtyRects.clear();
 	_forceRedraw = false;
 	_cursorNeedsRedraw = false;
 #if !SDL_VERSION_ATLEAST(2, 0, 0)
@@ -1723,11 +1769,6 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool in
 	if (_forceRedraw)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
-		_forceRedraw = true;
-		return;
-	}
-
 	int height, width;
 
 	if (!inOverlay && !realCoordinates) {
@@ -1768,23 +1809,19 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool in
 		h = height - y;
 	}
 
-#ifdef USE_ASPECT
-	if (_videoMode.aspectRatioCorrection && !_overlayInGUI && !realCoordinates)
-		makeRectStretchable(x, y, w, h, _videoMode.filtering);
-#endif
-
 	if (w == width && h == height) {
 		_forceRedraw = true;
 		return;
 	}
 
+	// The rects are only made stretchable for the aspect ratio correction
+	// once the tiles are turned back into rects. Rects in real coordinates
+	// are kept apart, since they must not be made stretchable.
 	if (w > 0 && h > 0) {
-		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
-
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
+		if (realCoordinates)
+			_realDirtyRects.push_back(Common::Rect(x, y, x + w, y + h));
+		else
+			_dirtyRegion.addRect(Common::Rect(x, y, x + w, y + h));
 	}
 }
 
@@ -2877,7 +2914,16 @@ SDL_Surface *SurfaceSdlGraphicsManager::SDL_SetVideoMode(int width, int height,
 }
 
 void SurfaceSdlGraphicsManager::SDL_UpdateRects(SDL_Surface *screen, int numrects, SDL_Rect *rects) {
-	SDL_UpdateTexture(_screenTexture, nullptr, screen->pixels, screen->pitch);
+	// Only upload the parts of the screen that were scaled again
+	const SDL_Rect bounds = { 0, 0, screen->w, screen->h };
+	if (numrects == 0)
+		SDL_UpdateTexture(_screenTexture, nullptr, screen->pixels, screen->pitch);
+
+	for (int i = 0; i < numrects; i++) {
+		SDL_Rect r;
+		if (SDL_IntersectRect(&rects[i], &bounds, &r))
+			SDL_UpdateTexture(_screenTexture, &r, (const byte *)screen->pixels + r.y * screen->pitch + r.x * screen->format->BytesPerPixel, screen->pitch);
+	}
 
 	SDL_Rect viewport;
 
@@ -24,6 +24,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "graphics/dirty_region.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
@@ -128,6 +129,18 @@ public:
 	void notifyVideoExpose() override;
 	void notifyResize(const int width, const int height) override;
 
+	/** Statistics about the last screen update, in unscaled pixels. */
+	struct DirtyStats {
+		/** The pixels updating each dirty rectangle on its own would have scaled. */
+		uint32 dirtyPixels;
+		/** The pixels that were actually scaled. */
+		uint32 scaledPixels;
+		/** The number of rectangles the scaled pixels were split into. */
+		uint numRects;
+	};
+
+	const DirtyStats &getDirtyStats() const { return _dirtyStats; }
+
 protected:
 #ifdef USE_OSD
 	/** Surface containing the OSD message */
@@ -271,6 +284,7 @@ protected:
 
 		uint scalerIndex;
 		int scaleFactor;
+		uint scalerThreads;
 
 		int screenWidth, screenHeight;
 		int overlayWidth, overlayHeight;
@@ -294,6 +308,7 @@ protected:
 
 			scalerIndex = 0;
 			scaleFactor = 0;
+			scalerThreads = 1;
 
 			screenWidth = 0;
 			screenHeight = 0;
@@ -342,19 +357,20 @@ protected:
 	int _screenChangeCount;
 
 	enum {
-		NUM_DIRTY_RECT = 100,
 		MAX_SCALING = 3
 	};
 
 	// Dirty rect management
-	// When double-buffering we need to redraw both updates from
-	// current frame and previous frame. For convenience we copy
-	// them here before traversing the list.
-	SDL_Rect _dirtyRectList[2 * NUM_DIRTY_RECT];
-	int _numDirtyRects;
-
-	SDL_Rect _prevDirtyRectList[NUM_DIRTY_RECT];
-	int _numPrevDirtyRects;
+	// The dirty areas are collected as tiles, so that overlapping areas are
+	// only scaled once. When updating the screen, the tiles are turned into
+	// rectangles, which are then converted to hardware coordinates in place.
+	// Rectangles in real coordinates are not made stretchable for the aspect
+	// ratio correction, so they are not merged into the tiles.
+	Graphics::DirtyRegion _dirtyRegion;
+	Common::Array<Common::Rect> _realDirtyRects;
+	Common::Array<Common::Rect> _dirtyRects;
+	Common::Array<SDL_Rect> _dirtyRectList;
+	DirtyStats _dirtyStats;
 
 	struct MousePos {
 		// The size and hotspot of the original cursor image.
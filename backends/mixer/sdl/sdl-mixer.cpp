@@ -121,7 +121,13 @@ void SdlMixerManager::init() {
 	if (_obtained.channels != 1 && _obtained.channels != 2)
 		error("SDL mixer output requires mono or stereo output device");
 
-	_mixer = new Audio::MixerImpl(_obtained.freq, _obtained.channels >= 2, desired.samples);
+	// Optionally keep the audio callback from ever waiting for the engine.
+	// See MixerImpl for the caveats.
+	bool lockFree = ConfMan.hasKey("audio_lock_free") && ConfMan.getBool("audio_lock_free");
+	if (lockFree)
+		debug(1, "Using lock-free mixer");
+
+	_mixer = new Audio::MixerImpl(_obtained.freq, _obtained.channels >= 2, desired.samples, lockFree);
 	assert(_mixer);
 	_mixer->setReady(true);
 
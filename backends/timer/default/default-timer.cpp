@@ -21,6 +21,7 @@
 
 #include "common/scummsys.h"
 #include "backends/timer/default/default-timer.h"
+#include "common/profiler.h"
 #include "common/util.h"
 #include "common/system.h"
 
@@ -80,6 +81,7 @@ DefaultTimerManager::~DefaultTimerManager() {
 }
 
 void DefaultTimerManager::handler() {
+	PROFILE_ZONE("TimerManager::handler");
 	Common::StackLock lock(_mutex);
 
 	uint32 curTime = g_system->getMillis(true);
@@ -38,6 +38,7 @@
 #include "common/savefile.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 #include "common/tokenizer.h"
 
 #include "gui/ThemeEngine.h"
@@ -96,6 +97,9 @@ static const char HELP_STRING1[] =
 	"  --auto-detect            Display a list of games from current or specified directory\n"
 	"                           and start the first one. Use --path=PATH to specify a directory.\n"
 	"  --recursive              In combination with --add or --detect recurse down all subdirectories\n"
+	"  --rebuild-detection-cache\n"
+	"                           Discard the cached MD5s of game files and compute them again\n"
+	"                           when detecting games\n"
 	"  --no-exit                In combination with commands that exit after running, like --add or --list-engines,\n"
 	"                           open the launcher instead of exiting\n"
 #if defined(WIN32)
@@ -194,7 +198,7 @@ static const char HELP_STRING4[] =
 	"                           atari, macintosh, macintoshbw)\n"
 #ifdef ENABLE_EVENTRECORDER
 	"  --record-mode=MODE       Specify record mode for event recorder (record, playback,\n"
-	"                           info, update, passthrough [default])\n"
+	"                           benchmark, info, update, passthrough [default])\n"
 	"  --record-file-name=FILE  Specify record file name\n"
 	"  --disable-display        Disable any gfx output. Used for headless events\n"
 	"                           playback by Event Recorder\n"
@@ -298,6 +302,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("stretch_mode", "default");
 	ConfMan.registerDefault("scaler", "default");
 	ConfMan.registerDefault("scale_factor", -1);
+	ConfMan.registerDefault("scaler_threads", 0);
 	ConfMan.registerDefault("shader", Common::Path("default", Common::Path::kNoSeparator));
 	ConfMan.registerDefault("show_fps", false);
 	ConfMan.registerDefault("dirtyrects", true);
@@ -388,6 +393,10 @@ void registerDefaults() {
 	ConfMan.registerDefault("gui_list_max_scan_entries", -1);
 	ConfMan.registerDefault("game", "");
 
+	// Keep the MD5s computed during detection on disk
+	ConfMan.registerDefault("detection_cache", true);
+	ConfMan.registerDefault("rebuild_detection_cache", false);
+
 #ifdef USE_FLUIDSYNTH
 	// The settings are deliberately stored the same way as in Qsynth. The
 	// FluidSynth music driver is responsible for transforming them into
@@ -924,6 +933,9 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_BOOL("recursive")
 			END_OPTION
 
+			DO_LONG_OPTION_BOOL("rebuild-detection-cache")
+			END_OPTION
+
 			DO_LONG_OPTION_BOOL("exit")
 			END_OPTION
 
@@ -1449,17 +1461,54 @@ static void dumpAllDetectionEntries() {
 }
 
 /** Display all games in the given directory, or current directory if empty */
-static DetectedGames getGameList(const Common::FSNode &dir) {
+/** A directory and all files in it. */
+struct DirectoryListing {
+	DirectoryListing() : listed(false) {}
+	explicit DirectoryListing(const Common::FSNode &node) : dir(node), listed(false) {}
+
+	Common::FSNode dir;
 	Common::FSList files;
+	bool listed;
+};
+
+/**
+ * Collect all files from the given directories. This is done in parallel if
+ * the filesystem allows it, so that the subdirectories are ready by the time
+ * they are searched.
+ */
+static void listDirectories(Common::Array<DirectoryListing> &dirs) {
+	auto listDirectory = [&dirs](uint i) {
+		dirs[i].listed = dirs[i].dir.getChildren(dirs[i].files, Common::FSNode::kListAll);
+	};
+
+	if (Common::FSNode::supportsThreadedAccess()) {
+		Common::ThreadPool::instance().parallelFor(dirs.size(), listDirectory);
+	} else {
+		for (uint i = 0; i < dirs.size(); i++)
+			listDirectory(i);
+	}
+}
 
-	// Collect all files from directory
-	if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-		printf("Path %s does not exist or is not a directory.\n", dir.getPath().toString(Common::Path::kNativeSeparator).c_str());
+/** List the subdirectories of an already listed directory. */
+static Common::Array<DirectoryListing> listSubdirectories(const DirectoryListing &parent) {
+	Common::Array<DirectoryListing> subdirs;
+	for (Common::FSList::const_iterator file = parent.files.begin(); file != parent.files.end(); ++file) {
+		if (file->isDirectory())
+			subdirs.push_back(DirectoryListing(*file));
+	}
+
+	listDirectories(subdirs);
+	return subdirs;
+}
+
+static DetectedGames getGameList(const DirectoryListing &listing) {
+	if (!listing.listed) {
+		printf("Path %s does not exist or is not a directory.\n", listing.dir.getPath().toString(Common::Path::kNativeSeparator).c_str());
 		return DetectedGames();
 	}
 
 	// detect Games
-	DetectionResults detectionResults = EngineMan.detectGames(files);
+	DetectionResults detectionResults = EngineMan.detectGames(listing.files);
 
 	if (detectionResults.foundUnknownGames()) {
 		Common::U32String report = detectionResults.generateUnknownGameReport(false, 80);
@@ -1469,14 +1518,13 @@ static DetectedGames getGameList(const Common::FSNode &dir) {
 	return detectionResults.listRecognizedGames();
 }
 
-static DetectedGames recListGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
-	DetectedGames list = getGameList(dir);
+static DetectedGames recListGames(const DirectoryListing &listing, const Common::String &engineId, const Common::String &gameId, bool recursive) {
+	DetectedGames list = getGameList(listing);
 
 	if (recursive) {
-		Common::FSList files;
-		dir.getChildren(files, Common::FSNode::kListDirectoriesOnly);
-		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			DetectedGames rec = recListGames(*file, engineId, gameId, recursive);
+		Common::Array<DirectoryListing> subdirs = listSubdirectories(listing);
+		for (Common::Array<DirectoryListing>::const_iterator subdir = subdirs.begin(); subdir != subdirs.end(); ++subdir) {
+			DetectedGames rec = recListGames(*subdir, engineId, gameId, recursive);
 			for (DetectedGames::const_iterator game = rec.begin(); game != rec.end(); ++game) {
 				if ((game->engineId == engineId && game->gameId == gameId)
 				    || gameId.empty())
@@ -1492,8 +1540,10 @@ static DetectedGames recListGames(const Common::FSNode &dir, const Common::Strin
 static Common::String detectGames(const Common::Path &path, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	bool noPath = path.empty();
 	//Current directory
-	Common::FSNode dir(path);
-	DetectedGames candidates = recListGames(dir, engineId, gameId, recursive);
+	Common::Array<DirectoryListing> listing(1, DirectoryListing(Common::FSNode(path)));
+	listDirectories(listing);
+	const Common::FSNode &dir = listing[0].dir;
+	DetectedGames candidates = recListGames(listing[0], engineId, gameId, recursive);
 
 	if (candidates.empty()) {
 		printf("WARNING: ScummVM could not find any game in %s\n", dir.getPath().toString(Common::Path::kNativeSeparator).c_str());
@@ -1518,9 +1568,9 @@ static Common::String detectGames(const Common::Path &path, const Common::String
 	return buildQualifiedGameName(candidates[0].engineId, candidates[0].gameId);
 }
 
-static int recAddGames(const Common::FSNode &dir, const Common::String &engineId, const Common::String &gameId, bool recursive) {
+static int recAddGames(const DirectoryListing &listing, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	int count = 0;
-	DetectedGames list = getGameList(dir);
+	DetectedGames list = getGameList(listing);
 	for (DetectedGames::const_iterator v = list.begin(); v != list.end(); ++v) {
 		if ((v->engineId != engineId || v->gameId != gameId)
 		    && !gameId.empty()) {
@@ -1547,11 +1597,9 @@ static int recAddGames(const Common::FSNode &dir, const Common::String &engineId
 	}
 
 	if (recursive) {
-		Common::FSList files;
-		if (dir.getChildren(files, Common::FSNode::kListDirectoriesOnly)) {
-			for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-				count += recAddGames(*file, engineId, gameId, recursive);
-			}
+		Common::Array<DirectoryListing> subdirs = listSubdirectories(listing);
+		for (Common::Array<DirectoryListing>::const_iterator subdir = subdirs.begin(); subdir != subdirs.end(); ++subdir) {
+			count += recAddGames(*subdir, engineId, gameId, recursive);
 		}
 	}
 
@@ -1635,8 +1683,9 @@ static void calcMD5Mac(Common::Path &filePath, int32 length) {
 
 static bool addGames(const Common::Path &path, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	//Current directory
-	Common::FSNode dir(path);
-	int added = recAddGames(dir, engineId, gameId, recursive);
+	Common::Array<DirectoryListing> listing(1, DirectoryListing(Common::FSNode(path)));
+	listDirectories(listing);
+	int added = recAddGames(listing[0], engineId, gameId, recursive);
 	printf("Added %d games\n", added);
 	if (added == 0 && !recursive) {
 		printf("Consider using --recursive to search inside subdirectories\n");
@@ -25,6 +25,7 @@
 #include "common/debug.h"
 #include "common/debug-channels.h"
 #include "common/config-manager.h"
+#include "common/threadpool.h"
 
 #ifdef DYNAMIC_MODULES
 #include "common/fs.h"
@@ -744,6 +745,9 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 	// Close all archives that were opened during detection
 	ADCacheMan.clearArchives();
 
+	// Store the newly computed MD5s for the next time
+	ADCacheMan.flushDiskCache();
+
 	return DetectionResults(candidates);
 }
 
@@ -1130,3 +1134,10 @@ void ScalerManager::updateOldSettings() {
 		}
 	}
 }
+
+uint ScalerManager::getThreadCount() const {
+	int threads = ConfMan.getInt("scaler_threads");
+	if (threads <= 0)
+		return Common::ThreadPool::instance().getThreadCount();
+	return threads;
+}
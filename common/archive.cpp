@@ -20,6 +20,7 @@
  */
 
 #include "common/archive.h"
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/system.h"
@@ -176,6 +177,31 @@ char Archive::getPathSeparator() const {
 	return '/';
 }
 
+List<MemcachingCaseInsensitiveArchive::LRUEntry> MemcachingCaseInsensitiveArchive::_lru;
+uint32 MemcachingCaseInsensitiveArchive::_cachedSize = 0;
+uint32 MemcachingCaseInsensitiveArchive::_cacheBudget = 4 * 1024 * 1024;
+
+MemcachingCaseInsensitiveArchive::MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize) :
+	_maxStronglyCachedSize(maxStronglyCachedSize) {
+	_cacheStats.hits = 0;
+	_cacheStats.misses = 0;
+	_cacheStats.evictions = 0;
+	_cacheStats.cachedSize = 0;
+
+	if (ConfMan.hasKey("archive_cache_budget"))
+		setCacheBudget(MAX(ConfMan.getInt("archive_cache_budget"), 0));
+}
+
+MemcachingCaseInsensitiveArchive::~MemcachingCaseInsensitiveArchive() {
+	// Give the space of the contents in the shared cache back
+	for (CacheMap::iterator it = _cache.begin(); it != _cache.end(); ++it) {
+		if (it->_value.inLRU) {
+			_lru.erase(it->_value.lruPos);
+			_cachedSize -= it->_value.contents.getSize();
+		}
+	}
+}
+
 SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMember(const Path &path) const {
 	return createReadStreamForMemberImpl(path, false, Common::AltStreamType::Invalid);
 }
@@ -190,55 +216,111 @@ SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMemberA
 	return createReadStreamForMemberImpl(path, true, altStreamType);
 }
 
+void MemcachingCaseInsensitiveArchive::prefetchMember(const Path &path) const {
+	CacheKey cacheKey;
+	cacheKey.path = translatePath(path);
+
+	SeekableReadStream *bypass = nullptr;
+	CacheEntry *entry = lookupContents(cacheKey, false, bypass);
+	// Contents which bypass the cache can't be read ahead
+	delete bypass;
+
+	if (entry && !entry->contents.isFileMissing())
+		touchContents(cacheKey, *entry);
+}
+
+void MemcachingCaseInsensitiveArchive::setCacheBudget(uint32 cacheBudget) {
+	_cacheBudget = cacheBudget;
+	trimCache();
+}
+
 SeekableReadStream *MemcachingCaseInsensitiveArchive::createReadStreamForMemberImpl(const Path &path, bool isAltStream, Common::AltStreamType altStreamType) const {
 	CacheKey cacheKey;
 	cacheKey.path = translatePath(path);
 	cacheKey.altStreamType = isAltStream ? altStreamType : AltStreamType::Invalid;
 
-	bool isNew = false;
-	if (!_cache.contains(cacheKey)) {
-		SharedArchiveContents readResult = isAltStream ? readContentsForPathAltStream(cacheKey.path, altStreamType) : readContentsForPath(cacheKey.path);
-		if (readResult._bypass)
-			return readResult._bypass;
-		_cache[cacheKey] = readResult;
-		isNew = true;
-	}
-
-	SharedArchiveContents* entry = &_cache[cacheKey];
+	SeekableReadStream *bypass = nullptr;
+	CacheEntry *entry = lookupContents(cacheKey, isAltStream, bypass);
+	if (bypass)
+		return bypass;
 
 	// Errors and missing files. Just return nullptr,
 	// no need to create stream.
-	if (entry->isFileMissing())
+	if (entry->contents.isFileMissing())
 		return nullptr;
 
+	// Now we have a valid contents reference. Make stream for it.
+	Common::MemoryReadStream *memStream = new Common::MemoryReadStream(entry->contents.getContents(), entry->contents.getSize());
+
+	touchContents(cacheKey, *entry);
+
+	return memStream;
+}
+
+MemcachingCaseInsensitiveArchive::CacheEntry *MemcachingCaseInsensitiveArchive::lookupContents(const CacheKey &cacheKey, bool isAltStream, SeekableReadStream *&bypass) const {
 	// Check whether the entry is still valid as WeakPtr might have expired.
-	if (!entry->makeStrong()) {
-		// If it's expired, recreate the entry.
-		SharedArchiveContents readResult = isAltStream ? readContentsForPathAltStream(cacheKey.path, altStreamType) : readContentsForPath(cacheKey.path);
-		if (readResult._bypass)
-			return readResult._bypass;
-		_cache[cacheKey] = readResult;
-		entry = &_cache[cacheKey];
-		isNew = true;
+	CacheMap::iterator it = _cache.find(cacheKey);
+	if (it != _cache.end() && it->_value.contents.makeStrong()) {
+		_cacheStats.hits++;
+		return &it->_value;
 	}
 
-	// It's possible that recreation failed in case of e.g. network
-	// share going offline.
-	if (entry->isFileMissing())
+	// If it's new or expired, (re)create the entry. Expired entries
+	// are weak, so they are never in the LRU list.
+	_cacheStats.misses++;
+	SharedArchiveContents readResult = isAltStream ? readContentsForPathAltStream(cacheKey.path, cacheKey.altStreamType) : readContentsForPath(cacheKey.path);
+	if (readResult._bypass) {
+		bypass = readResult._bypass;
 		return nullptr;
+	}
 
-	// Now we have a valid contents reference. Make stream for it.
-	Common::MemoryReadStream *memStream = new Common::MemoryReadStream(entry->getContents(), entry->getSize());
+	CacheEntry &entry = _cache[cacheKey];
+	entry.contents = readResult;
+	return &entry;
+}
+
+void MemcachingCaseInsensitiveArchive::touchContents(const CacheKey &cacheKey, CacheEntry &entry) const {
+	uint32 size = entry.contents.getSize();
+	if (size <= _maxStronglyCachedSize)
+		return;
 
-	// If the entry was just created and it's too big for strong caching,
-	// mark the copy in cache as weak
-	if (isNew && entry->getSize() > _maxStronglyCachedSize) {
-		entry->makeWeak();
+	if (entry.inLRU) {
+		_lru.erase(entry.lruPos);
+		_cacheStats.cachedSize -= size;
+		_cachedSize -= size;
+		entry.inLRU = false;
 	}
 
-	return memStream;
-}
+	// Contents which can never fit are only kept alive by their streams
+	if (size > _cacheBudget) {
+		entry.contents.makeWeak();
+		return;
+	}
 
+	LRUEntry lruEntry;
+	lruEntry.archive = this;
+	lruEntry.key = cacheKey;
+	_lru.push_front(lruEntry);
+	entry.lruPos = _lru.begin();
+	entry.inLRU = true;
+	_cacheStats.cachedSize += size;
+	_cachedSize += size;
+
+	trimCache();
+}
+
+void MemcachingCaseInsensitiveArchive::trimCache() {
+	while (_cachedSize > _cacheBudget && !_lru.empty()) {
+		const MemcachingCaseInsensitiveArchive *archive = _lru.back().archive;
+		CacheEntry &entry = archive->_cache[_lru.back().key];
+		_lru.pop_back();
+		entry.inLRU = false;
+		entry.contents.makeWeak();
+		archive->_cacheStats.cachedSize -= entry.contents.getSize();
+		archive->_cacheStats.evictions++;
+		_cachedSize -= entry.contents.getSize();
+	}
+}
 SharedArchiveContents MemcachingCaseInsensitiveArchive::readContentsForPathAltStream(const Path &translatedPath, AltStreamType altStreamType) const {
 	return SharedArchiveContents();
 }
@@ -520,6 +602,19 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	return nullptr;
 }
 
+void SearchSet::prefetchMember(const Path &path) const {
+	if (path.empty())
+		return;
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		if (it->_arc->hasFile(path)) {
+			it->_arc->prefetchMember(path);
+			return;
+		}
+	}
+}
+
 SeekableReadStream *SearchSet::createReadStreamForMemberAltStream(const Path &path, AltStreamType altStreamType) const {
 	if (path.empty())
 		return nullptr;
@@ -202,6 +202,13 @@ public:
 		return createReadStreamForMember(path);
 	}
 
+	/**
+	 * Hint that the member with the specified name is going to be read
+	 * soon, so that archives which have to unpack their members can do it
+	 * ahead of time. The default implementation does nothing.
+	 */
+	virtual void prefetchMember(const Path &path) const {}
+
 	/**
 	 * Dump all files from the archive to the given directory
 	 */
@@ -226,6 +233,9 @@ public:
 	SharedArchiveContents(byte *contents, uint32 contentSize) :
 		_strongRef(contents, ArrayDeleter<byte>()), _weakRef(_strongRef),
 		_contentSize(contentSize), _missingFile(false), _bypass(nullptr) {}
+	SharedArchiveContents(SharedPtr<byte> contents, uint32 contentSize) :
+		_strongRef(contents), _weakRef(_strongRef),
+		_contentSize(contentSize), _missingFile(false), _bypass(nullptr) {}
 	SharedArchiveContents() : _strongRef(nullptr), _weakRef(nullptr), _contentSize(0), _missingFile(true), _bypass(nullptr) {}
 	static SharedArchiveContents bypass(SeekableReadStream *stream) {
 		return SharedArchiveContents(stream);
@@ -265,12 +275,41 @@ private:
 
 /**
  * An archive that caches the resulting contents.
+ *
+ * Contents up to maxStronglyCachedSize bytes are always kept in memory.
+ * Larger contents stay in memory as long as streams reading them exist,
+ * and the most recently used of them are kept beyond that, as long as
+ * they fit into the cache budget. The budget is shared by all archives,
+ * and is set by the "archive_cache_budget" configuration key.
  */
 class MemcachingCaseInsensitiveArchive : public Archive {
 public:
-	MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize = 512) : _maxStronglyCachedSize(maxStronglyCachedSize) {}
+	/** Statistics about the contents cache, see getCacheStats(). */
+	struct CacheStats {
+		uint32 hits;		///< Members which were still in memory
+		uint32 misses;		///< Members which had to be read from the archive
+		uint32 evictions;	///< Members dropped to stay within the cache budget
+		uint32 cachedSize;	///< Bytes of this archive currently kept in the cache
+	};
+
+	MemcachingCaseInsensitiveArchive(uint32 maxStronglyCachedSize = 512);
+	~MemcachingCaseInsensitiveArchive();
 	SeekableReadStream *createReadStreamForMember(const Path &path) const;
 	SeekableReadStream *createReadStreamForMemberAltStream(const Path &path, Common::AltStreamType altStreamType) const;
+	void prefetchMember(const Path &path) const override;
+
+	/**
+	 * Set the number of bytes of contents larger than maxStronglyCachedSize
+	 * which all archives keep in memory after they have been read. The least
+	 * recently used contents are dropped first.
+	 *
+	 * This overrides the "archive_cache_budget" configuration key until it
+	 * is read again, when the next archive is created.
+	 */
+	static void setCacheBudget(uint32 cacheBudget);
+	static uint32 getCacheBudget() { return _cacheBudget; }
+
+	const CacheStats &getCacheStats() const { return _cacheStats; }
 
 	virtual Path translatePath(const Path &path) const {
 		return path.normalize();
@@ -295,10 +334,35 @@ private:
 		uint operator()(const CacheKey &x) const;
 	};
 
+	struct LRUEntry {
+		const MemcachingCaseInsensitiveArchive *archive;
+		CacheKey key;
+	};
+
+	struct CacheEntry {
+		CacheEntry() : inLRU(false) {}
+
+		SharedArchiveContents contents;
+		bool inLRU;
+		List<LRUEntry>::iterator lruPos;
+	};
+
 	SeekableReadStream *createReadStreamForMemberImpl(const Path &path, bool isAltStream, Common::AltStreamType altStreamType) const;
+	CacheEntry *lookupContents(const CacheKey &cacheKey, bool isAltStream, SeekableReadStream *&bypass) const;
+	void touchContents(const CacheKey &cacheKey, CacheEntry &entry) const;
+	static void trimCache();
 
-	mutable HashMap<CacheKey, SharedArchiveContents, CacheKey_Hash, CacheKey_EqualTo> _cache;
+	typedef HashMap<CacheKey, CacheEntry, CacheKey_Hash, CacheKey_EqualTo> CacheMap;
+
+	mutable CacheMap _cache;
+	mutable CacheStats _cacheStats;
 	uint32 _maxStronglyCachedSize;
+
+	// Large contents of all archives which are kept strong, most recently
+	// used first. Like the archives, this is not thread safe.
+	static List<LRUEntry> _lru;
+	static uint32 _cachedSize;
+	static uint32 _cacheBudget;
 };
 
 /**
@@ -450,6 +514,11 @@ public:
 	 */
 	SeekableReadStream *createReadStreamForMemberNext(const Path &path, const Archive *starting) const override;
 
+	/**
+	 * Pass the hint on to the first archive containing the member.
+	 */
+	void prefetchMember(const Path &path) const override;
+
 	/**
 	 * Ignore clashes when adding directories. For more details, see the corresponding parameter
 	 * in @ref FSDirectory documentation.
@@ -0,0 +1,150 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#ifdef USE_THREADS
+#include <atomic>
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic variables
+ * @ingroup common
+ *
+ * @brief Variables which can be accessed by several threads without locking.
+ *
+ * These map to std::atomic when USE_THREADS is defined. Without it the
+ * toolchain may not provide \<atomic\>, and they are plain variables. Code
+ * which passes data between threads through them, without also holding a
+ * Common::Mutex, therefore has to check ATOMICS_ARE_LOCK_FREE and fall back
+ * to a mutex when it is not defined.
+ * @{
+ */
+
+#ifdef USE_THREADS
+
+#define ATOMICS_ARE_LOCK_FREE
+
+enum MemoryOrder {
+	kMemoryOrderRelaxed = std::memory_order_relaxed,
+	kMemoryOrderAcquire = std::memory_order_acquire,
+	kMemoryOrderRelease = std::memory_order_release,
+	kMemoryOrderAcqRel = std::memory_order_acq_rel,
+	kMemoryOrderSeqCst = std::memory_order_seq_cst
+};
+
+/** Variable of the integer, boolean or pointer type T with atomic accesses. */
+template<class T>
+class Atomic {
+public:
+	constexpr Atomic() : _value(T()) {}
+	constexpr explicit Atomic(T value) : _value(value) {}
+
+	T load(MemoryOrder order = kMemoryOrderSeqCst) const { return _value.load((std::memory_order)order); }
+	void store(T value, MemoryOrder order = kMemoryOrderSeqCst) { _value.store(value, (std::memory_order)order); }
+	T exchange(T value, MemoryOrder order = kMemoryOrderSeqCst) { return _value.exchange(value, (std::memory_order)order); }
+	T fetchAdd(T value, MemoryOrder order = kMemoryOrderSeqCst) { return _value.fetch_add(value, (std::memory_order)order); }
+
+	/**
+	 * Replace the value with @p desired if it is @p expected. This may
+	 * spuriously fail, so it is meant to be called in a loop.
+	 *
+	 * @return False if the value was not replaced, @p expected is then set to the current value.
+	 */
+	bool compareExchangeWeak(T &expected, T desired, MemoryOrder success, MemoryOrder failure) {
+		return _value.compare_exchange_weak(expected, desired, (std::memory_order)success, (std::memory_order)failure);
+	}
+
+	operator T() const { return load(); }
+	Atomic &operator=(T value) { store(value); return *this; }
+
+private:
+	std::atomic<T> _value;
+};
+
+/** Order the memory accesses around it like std::atomic_thread_fence(). */
+inline void atomicThreadFence(MemoryOrder order) {
+	std::atomic_thread_fence((std::memory_order)order);
+}
+
+#else
+
+enum MemoryOrder {
+	kMemoryOrderRelaxed,
+	kMemoryOrderAcquire,
+	kMemoryOrderRelease,
+	kMemoryOrderAcqRel,
+	kMemoryOrderSeqCst
+};
+
+template<class T>
+class Atomic {
+public:
+	constexpr Atomic() : _value(T()) {}
+	constexpr explicit Atomic(T value) : _value(value) {}
+
+	T load(MemoryOrder = kMemoryOrderSeqCst) const { return _value; }
+	void store(T value, MemoryOrder = kMemoryOrderSeqCst) { _value = value; }
+
+	T exchange(T value, MemoryOrder = kMemoryOrderSeqCst) {
+		T old = _value;
+		_value = value;
+		return old;
+	}
+
+	T fetchAdd(T value, MemoryOrder = kMemoryOrderSeqCst) {
+		T old = _value;
+		_value += value;
+		return old;
+	}
+
+	bool compareExchangeWeak(T &expected, T desired, MemoryOrder, MemoryOrder) {
+		if (_value != expected) {
+			expected = _value;
+			return false;
+		}
+
+		_value = desired;
+		return true;
+	}
+
+	operator T() const { return load(); }
+	Atomic &operator=(T value) { store(value); return *this; }
+
+private:
+	T _value;
+};
+
+inline void atomicThreadFence(MemoryOrder) {
+}
+
+#endif
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
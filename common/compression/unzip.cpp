@@ -117,6 +117,10 @@ typedef voidp unzFile;
 #define UNZ_INTERNALERROR               (-104)
 #define UNZ_CRCERROR                    (-105)
 
+/* deflated files at least this large are decompressed on the fly
+   when the zip file is memory mapped */
+#define UNZ_STREAMING_THRESHOLD (1024 * 1024)
+
 /* tm_unz contain date/time info */
 typedef struct {
        uInt tm_sec;            /* seconds after the minute - [0,59] */
@@ -982,40 +986,62 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 	}
 
 	uint32 crc32_wait = s->cur_file_info.crc;
+	uint32 dataOffset = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+
+	// If the zip file is mapped into memory, the compressed data is used in
+	// place, and stored files aren't copied at all
+	Common::SharedPtr<byte> compressedData;
+	Common::MappedReadStream *mappedStream = dynamic_cast<Common::MappedReadStream *>(s->_stream);
 
-	byte *compressedBuffer = new byte[s->cur_file_info.compressed_size];
-	s->_stream->seek(s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar);
-	s->_stream->read(compressedBuffer, s->cur_file_info.compressed_size);
-	byte *uncompressedBuffer = nullptr;
+#ifdef USE_ZLIB
+	// Large deflated files are decompressed while they are read instead of
+	// all at once. The span stream keeps the mapping alive for as long as
+	// the returned stream exists. Note that the CRC isn't checked then.
+	if (mappedStream && s->cur_file_info.compression_method == Z_DEFLATED &&
+			s->cur_file_info.uncompressed_size >= UNZ_STREAMING_THRESHOLD) {
+		Common::SeekableReadStream *spanStream = mappedStream->createSpanStream(dataOffset, s->cur_file_info.compressed_size);
+		if (spanStream)
+			return Common::SharedArchiveContents::bypass(Common::wrapDeflateReadStream(spanStream, DisposeAfterUse::YES, s->cur_file_info.uncompressed_size));
+	}
+#endif
+
+	if (mappedStream)
+		compressedData = mappedStream->getSpan(dataOffset, s->cur_file_info.compressed_size);
+
+	if (!compressedData) {
+		byte *compressedBuffer = new byte[s->cur_file_info.compressed_size];
+		s->_stream->seek(dataOffset);
+		s->_stream->read(compressedBuffer, s->cur_file_info.compressed_size);
+		compressedData = Common::SharedPtr<byte>(compressedBuffer, Common::ArrayDeleter<byte>());
+	}
+	Common::SharedPtr<byte> uncompressedData;
 
 	switch (s->cur_file_info.compression_method) {
 	case 0: // Store
-		uncompressedBuffer = compressedBuffer;
+		uncompressedData = compressedData;
 		break;
-	case Z_DEFLATED:
-		uncompressedBuffer = new byte[s->cur_file_info.uncompressed_size];
+	case Z_DEFLATED: {
+		byte *uncompressedBuffer = new byte[s->cur_file_info.uncompressed_size];
 		assert(s->cur_file_info.uncompressed_size == 0 || uncompressedBuffer != nullptr);
-		Common::inflateZlibHeaderless(uncompressedBuffer, s->cur_file_info.uncompressed_size, compressedBuffer, s->cur_file_info.compressed_size);
-		delete[] compressedBuffer;
-		compressedBuffer = nullptr;
+		Common::inflateZlibHeaderless(uncompressedBuffer, s->cur_file_info.uncompressed_size, compressedData.get(), s->cur_file_info.compressed_size);
+		uncompressedData = Common::SharedPtr<byte>(uncompressedBuffer, Common::ArrayDeleter<byte>());
 		break;
+	}
 	default:
 		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
-		delete[] compressedBuffer;
 		return Common::SharedArchiveContents();
 	}
 #ifndef USE_ZLIB
-	uint32 crc32_data = crc.crcFast(uncompressedBuffer, s->cur_file_info.uncompressed_size);
+	uint32 crc32_data = crc.crcFast(uncompressedData.get(), s->cur_file_info.uncompressed_size);
 #else
-	uint32 crc32_data = crc32(0, uncompressedBuffer, s->cur_file_info.uncompressed_size);
+	uint32 crc32_data = crc32(0, uncompressedData.get(), s->cur_file_info.uncompressed_size);
 #endif
 	if (crc32_data != crc32_wait) {
-		delete[] uncompressedBuffer;
 		warning("CRC32 mismatch: %08x, %08x", crc32_data, crc32_wait);
 		return Common::SharedArchiveContents();
 	}
 
-	return Common::SharedArchiveContents(uncompressedBuffer, s->cur_file_info.uncompressed_size);
+	return Common::SharedArchiveContents(uncompressedData, s->cur_file_info.uncompressed_size);
 }
 
 
@@ -1121,7 +1147,7 @@ Archive *makeZipArchive(const Path &name, bool flattenTree) {
 }
 
 Archive *makeZipArchive(const FSNode &node, bool flattenTree) {
-	return makeZipArchive(node.createReadStream(), flattenTree);
+	return makeZipArchive(node.createMappedReadStream(), flattenTree);
 }
 
 Archive *makeZipArchive(SeekableReadStream *stream, bool flattenTree) {
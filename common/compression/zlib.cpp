@@ -38,6 +38,7 @@
 #include "common/stream.h"
 #include "common/debug.h"
 #include "common/textconsole.h"
+#include "common/array.h"
 
 
 namespace Common {
@@ -87,15 +88,34 @@ bool inflateZlibHeaderless(byte *dst, uint *dstLen, const byte *src, uint srcLen
 static bool _shownBackwardSeekingWarning = false;
 #endif
 
+// inflateGetDictionary() is needed to save the window of a checkpoint
+#if ZLIB_VERNUM >= 0x1271
+#define GZIP_SEEK_CHECKPOINTS
+#endif
+
 /**
  * A simple wrapper class which can be used to wrap around an arbitrary
  * other SeekableReadStream and will then provide on-the-fly decompression support.
  * Assumes the compressed data to be in gzip format.
+ *
+ * While decompressing, the state of the decompressor is saved every
+ * CHECKPOINT_INTERVAL bytes, so seeking only has to decompress from the
+ * closest checkpoint instead of from the start of the stream.
  */
 class GZipReadStream : public SeekableReadStream {
 protected:
 	enum {
-		BUFSIZE = 16384		// 1 << MAX_WBITS
+		BUFSIZE = 16384,		// 1 << MAX_WBITS
+		WINDOWSIZE = 32768,
+		CHECKPOINT_INTERVAL = 1024 * 1024
+	};
+
+	struct Checkpoint {
+		uint32 out;			// Position in the decompressed data
+		uint32 in;			// Position in the compressed data
+		int bits;			// Bits of the byte before in which are still unused
+		uint windowSize;
+		byte *window;		// The last decompressed bytes, up to WINDOWSIZE
 	};
 
 	byte	_buf[BUFSIZE];
@@ -103,14 +123,67 @@ protected:
 	DisposablePtr<SeekableReadStream> _wrapped;
 	z_stream _stream;
 	int _zlibErr;
+	int _windowBits;
 	uint64 _parentPos;
+	uint32 _inBase;
 	uint32 _pos;
 	uint32 _origSize;
 	bool _eos;
+	Array<Checkpoint> _checkpoints;
+
+#ifdef GZIP_SEEK_CHECKPOINTS
+	void addCheckpoint() {
+		// Checkpoints can only be made between two deflate blocks, and
+		// there is no point in keeping one after the last block
+		if (!(_stream.data_type & 128) || (_stream.data_type & 64))
+			return;
+
+		uint32 lastOut = _checkpoints.empty() ? 0 : _checkpoints.back().out;
+		if (_pos < lastOut + CHECKPOINT_INTERVAL)
+			return;
+
+		Checkpoint checkpoint;
+		checkpoint.out = _pos;
+		checkpoint.in = _inBase + _stream.total_in;
+		checkpoint.bits = _stream.data_type & 7;
+		checkpoint.window = new byte[WINDOWSIZE];
+		checkpoint.windowSize = WINDOWSIZE;
+		if (inflateGetDictionary(&_stream, checkpoint.window, &checkpoint.windowSize) != Z_OK) {
+			delete[] checkpoint.window;
+			return;
+		}
+		_checkpoints.push_back(checkpoint);
+	}
+
+	bool restoreCheckpoint(const Checkpoint &checkpoint) {
+		// Resume in the middle of the stream, where there are no headers
+		_zlibErr = inflateReset2(&_stream, -MAX_WBITS);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		if (checkpoint.bits) {
+			_wrapped->seek(_parentPos + checkpoint.in - 1, SEEK_SET);
+			byte partial = _wrapped->readByte();
+			_zlibErr = inflatePrime(&_stream, checkpoint.bits, partial >> (8 - checkpoint.bits));
+		} else {
+			_wrapped->seek(_parentPos + checkpoint.in, SEEK_SET);
+		}
+		if (_zlibErr == Z_OK)
+			_zlibErr = inflateSetDictionary(&_stream, checkpoint.window, checkpoint.windowSize);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		_inBase = checkpoint.in;
+		_pos = checkpoint.out;
+		return true;
+	}
+#endif
 
 public:
 
-	GZipReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize) : _wrapped(w, disposeParent), _stream() {
+	GZipReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize) : _wrapped(w, disposeParent), _stream(), _inBase(0) {
 		assert(w != nullptr);
 
 		_parentPos = w->pos();
@@ -137,7 +210,8 @@ public:
 		// the compressed file. This feature was added in zlib 1.2.0.4,
 		// released 10 August 2003.
 		// Note: This is *crucial* for savegame compatibility, do *not* remove!
-		_zlibErr = inflateInit2(&_stream, MAX_WBITS + 32);
+		_windowBits = MAX_WBITS + 32;
+		_zlibErr = inflateInit2(&_stream, _windowBits);
 		if (_zlibErr != Z_OK)
 			return;
 
@@ -146,7 +220,7 @@ public:
 		_stream.avail_in = 0;
 	}
 
-	GZipReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize, const byte *dict, uint dictLen) : _wrapped(w, disposeParent), _stream() {
+	GZipReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize, const byte *dict, uint dictLen) : _wrapped(w, disposeParent), _stream(), _inBase(0) {
 		assert(w != nullptr);
 
 		_parentPos = w->pos();
@@ -157,7 +231,8 @@ public:
 		_pos = 0;
 		_eos = false;
 
-		_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+		_windowBits = -MAX_WBITS;
+		_zlibErr = inflateInit2(&_stream, _windowBits);
 		if (_zlibErr != Z_OK)
 			return;
 
@@ -175,6 +250,8 @@ public:
 
 	~GZipReadStream() {
 		inflateEnd(&_stream);
+		for (uint i = 0; i < _checkpoints.size(); i++)
+			delete[] _checkpoints[i].window;
 	}
 
 	bool err() const override { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
@@ -194,12 +271,20 @@ public:
 				_stream.next_in = _buf;
 				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
 			}
+#ifdef GZIP_SEEK_CHECKPOINTS
+			// Stop at the end of each block to see if a checkpoint is due
+			uint32 availOut = _stream.avail_out;
+			_zlibErr = inflate(&_stream, Z_BLOCK);
+			_pos += availOut - _stream.avail_out;
+			if (_zlibErr == Z_OK)
+				addCheckpoint();
+#else
+			uint32 availOut = _stream.avail_out;
 			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
+			_pos += availOut - _stream.avail_out;
+#endif
 		}
 
-		// Update the position counter
-		_pos += dataSize - _stream.avail_out;
-
 		if (_zlibErr == Z_STREAM_END && _stream.avail_out > 0)
 			_eos = true;
 
@@ -234,6 +319,21 @@ public:
 
 		assert(newPos >= 0);
 
+#ifdef GZIP_SEEK_CHECKPOINTS
+		// Jump to the closest checkpoint before the new position, if that
+		// is closer than the current position
+		for (int i = (int)_checkpoints.size() - 1; i >= 0; i--) {
+			const Checkpoint &checkpoint = _checkpoints[i];
+			if (checkpoint.out > (uint32)newPos)
+				continue;
+			if (checkpoint.out > _pos || (uint32)newPos < _pos) {
+				if (!restoreCheckpoint(checkpoint))
+					return false;
+			}
+			break;
+		}
+#endif
+
 		if ((uint32)newPos < _pos) {
 			// To search backward, we have to restart the whole decompression
 			// from the start of the file. A rather wasteful operation, best
@@ -250,8 +350,9 @@ public:
 #endif
 
 			_pos = 0;
+			_inBase = 0;
 			_wrapped->seek(_parentPos, SEEK_SET);
-			_zlibErr = inflateReset(&_stream);
+			_zlibErr = inflateReset2(&_stream, _windowBits);
 			if (_zlibErr != Z_OK)
 				return false; // FIXME: STREAM REWRITE
 			_stream.next_in = _buf;
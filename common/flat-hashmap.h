@@ -0,0 +1,643 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/hashmap.h"
+#include "common/util.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flat_hashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on an open addressing hash table.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in alternative to HashMap<Key,Val> which
+ * stores the key/value pairs directly in its table, instead of allocating a
+ * node for each of them. Each slot of the table holds the entry together
+ * with its hash and its distance from the slot the key hashes to, so a
+ * probe usually stays within a single cache line rather than chasing a
+ * pointer to the node.
+ *
+ * It uses Robin Hood hashing with linear probing: entries which are closer
+ * to their ideal slot make room for entries which are further away, which
+ * keeps the probe sequences short and lets lookups stop early. Keys are only
+ * compared when their hashes match, and growing the table does not need to
+ * hash them again. Erasing shifts the following entries back, so no
+ * tombstones are needed.
+ *
+ * The interface is the same as HashMap's, with one difference: since
+ * inserting and erasing moves entries around, any insertion or erasure
+ * invalidates all iterators and references into the map. In particular,
+ * entries cannot be erased while iterating over the map.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		Node(const Node &node) : _value(node._value), _key(node._key) {}
+		Node(Node &&node) : _value(Common::move(node._value)), _key(Common::move(const_cast<Key &>(node._key))) {}
+	};
+
+private:
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage of the hashmap may fill up before being
+		// increased automatically.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 2,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 3,
+
+		// Slots can't track entries further than this from their
+		// ideal slot. Only reachable with a hash function that maps tens of
+		// thousands of keys to the same value.
+		FLATHASHMAP_MAX_DISTANCE = 0xFFFF
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	/**
+	 * A slot of the table. Everything a probe needs is kept together, so
+	 * that looking up a key usually touches a single cache line.
+	 */
+	struct Slot {
+		uint32 _hash; ///< Hash of the entry, as returned by hashOf().
+		uint16 _dist; ///< Distance + 1 of the entry from its ideal slot, 0 if free.
+		alignas(Node) byte _node[sizeof(Node)]; ///< Entry, only constructed if _dist is non-zero.
+	};
+
+	Slot *_slots;
+	size_type _mask;  ///< Capacity of the FlatHashMap minus one; capacity is a power of two.
+	size_type _shift; ///< How far to shift the mixed hash to get a slot index.
+	size_type _size;
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/**
+	 * Spread the bits of the hash over the top bits, which select the slot,
+	 * since linear probing is sensitive to hash functions which leave the
+	 * low bits unused.
+	 */
+	uint32 hashOf(const Key &key) const {
+		return (uint32)_hash(key) * 2654435769U;
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const FHM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void eraseSlot(size_type ctr);
+	void expandStorage(size_type newCapacity);
+
+	Node *nodeAt(size_type ctr) const {
+		return (Node *)_slots[ctr]._node;
+	}
+
+	static void moveSlot(Slot &dst, Slot &src) {
+		new ((void *)dst._node) Node(Common::move(*(Node *)src._node));
+		((Node *)src._node)->~Node();
+		dst._hash = src._hash;
+	}
+
+	template<class T> friend class IteratorImpl;
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(_hashmap->_slots[_idx]._dist != 0);
+			return _hashmap->nodeAt(_idx);
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && _hashmap->_slots[_idx]._dist == 0);
+			if (_idx > _hashmap->_mask)
+				_idx = (size_type)-1;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (_slots[ctr]._dist)
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (_slots[ctr]._dist)
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		size_type ctr = lookup(key);
+		if (ctr <= _mask)
+			return iterator(ctr, this);
+		return end();
+	}
+
+	const_iterator	find(const Key &key) const {
+		size_type ctr = lookup(key);
+		if (ctr <= _mask)
+			return const_iterator(ctr, this);
+		return end();
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for allocating empty storage for @p capacity entries.
+ *
+ * @note The previous storage is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	assert((capacity & (capacity - 1)) == 0);
+
+	_mask = capacity - 1;
+	_shift = 32;
+	for (size_type c = capacity; c > 1; c >>= 1)
+		_shift--;
+	_size = 0;
+
+	_slots = new Slot[capacity];
+	for (size_type ctr = 0; ctr < capacity; ++ctr)
+		_slots[ctr]._dist = 0;
+}
+
+/**
+ * Internal method for destroying all entries and freeing the storage.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (_slots[ctr]._dist)
+			nodeAt(ctr)->~Node();
+	}
+
+	delete[] _slots;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// Both maps use the same layout, so we can simply clone the entries
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		_slots[ctr]._hash = map._slots[ctr]._hash;
+		_slots[ctr]._dist = map._slots[ctr]._dist;
+		if (_slots[ctr]._dist)
+			new ((void *)_slots[ctr]._node) Node(*map.nodeAt(ctr));
+	}
+	_size = map._size;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (_slots[ctr]._dist) {
+			nodeAt(ctr)->~Node();
+			_slots[ctr]._dist = 0;
+		}
+	}
+
+	_size = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::expandStorage(size_type newCapacity) {
+	assert(newCapacity > _mask + 1);
+
+	const size_type old_size = _size;
+	const size_type old_mask = _mask;
+	Slot *old_slots = _slots;
+
+	allocStorage(newCapacity);
+
+	// Reinsert all the old elements. Since we know that no key exists twice
+	// in the old table, we don't have to call _equal(), only find a slot,
+	// and the stored hashes save us from hashing the keys again.
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (!old_slots[ctr]._dist)
+			continue;
+
+		const uint32 hash = old_slots[ctr]._hash;
+		size_type idx = hash >> _shift;
+		size_type dist = 1;
+		while (_slots[idx]._dist >= dist) {
+			idx = (idx + 1) & _mask;
+			dist++;
+		}
+
+		// Make room by moving the rest of the cluster back by one
+		size_type last = idx;
+		while (_slots[last]._dist)
+			last = (last + 1) & _mask;
+		while (last != idx) {
+			const size_type prev = (last - 1) & _mask;
+			assert(_slots[prev]._dist < FLATHASHMAP_MAX_DISTANCE);
+			moveSlot(_slots[last], _slots[prev]);
+			_slots[last]._dist = _slots[prev]._dist + 1;
+			last = prev;
+		}
+
+		moveSlot(_slots[idx], old_slots[ctr]);
+		_slots[idx]._dist = dist;
+		_size++;
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	// This check will fail if some previous operation corrupted this hashmap.
+	assert(_size == old_size);
+	(void)old_size;
+
+	delete[] old_slots;
+}
+
+/**
+ * Find the slot of @p key, or return a value larger than the mask if the
+ * key is not in the map.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const uint32 hash = hashOf(key);
+	size_type ctr = hash >> _shift;
+
+	// Once we pass an entry closer to its ideal slot than we are to ours,
+	// the key can't be in the table: it would have taken that slot.
+	for (size_type dist = 1; dist <= _slots[ctr]._dist; dist++) {
+		if (_slots[ctr]._hash == hash && _equal(nodeAt(ctr)->_key, key))
+			return ctr;
+
+		ctr = (ctr + 1) & _mask;
+	}
+
+	return _mask + 1;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const uint32 hash = hashOf(key);
+	size_type ctr = hash >> _shift;
+	size_type dist = 1;
+	for (; dist <= _slots[ctr]._dist; dist++) {
+		if (_slots[ctr]._hash == hash && _equal(nodeAt(ctr)->_key, key))
+			return ctr;
+
+		ctr = (ctr + 1) & _mask;
+	}
+
+	// Keep the load factor below a certain threshold.
+	size_type capacity = _mask + 1;
+	if ((_size + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		capacity = capacity < 500 ? (capacity * 4) : (capacity * 2);
+		expandStorage(capacity);
+		return lookupAndCreateIfMissing(key);
+	}
+
+	// The new entry goes to the slot where the probe stopped. Move all
+	// following entries in the cluster back by one to make room for it,
+	// which keeps them ordered by their ideal slot.
+	size_type last = ctr;
+	while (_slots[last]._dist)
+		last = (last + 1) & _mask;
+	while (last != ctr) {
+		const size_type prev = (last - 1) & _mask;
+		assert(_slots[prev]._dist < FLATHASHMAP_MAX_DISTANCE);
+		moveSlot(_slots[last], _slots[prev]);
+		_slots[last]._dist = _slots[prev]._dist + 1;
+		last = prev;
+	}
+
+	assert(dist <= FLATHASHMAP_MAX_DISTANCE);
+	new ((void *)_slots[ctr]._node) Node(key);
+	_slots[ctr]._dist = dist;
+	_slots[ctr]._hash = hash;
+	_size++;
+
+	return ctr;
+}
+
+/**
+ * Remove the entry in slot @p ctr, moving the following entries of its
+ * cluster one slot closer to their ideal slot.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type ctr) {
+	assert(ctr <= _mask && _slots[ctr]._dist);
+
+	nodeAt(ctr)->~Node();
+
+	size_type next = (ctr + 1) & _mask;
+	while (_slots[next]._dist > 1) {
+		moveSlot(_slots[ctr], _slots[next]);
+		_slots[ctr]._dist = _slots[next]._dist - 1;
+		ctr = next;
+		next = (next + 1) & _mask;
+	}
+
+	_slots[ctr]._dist = 0;
+	_size--;
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) <= _mask;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// The lookup may reallocate the storage, so it has to happen before
+	// _slots is read.
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return nodeAt(ctr)->_value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return nodeAt(ctr)->_value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return nodeAt(ctr)->_value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return nodeAt(ctr)->_value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask) {
+		out = nodeAt(ctr)->_value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	nodeAt(ctr)->_value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	eraseSlot(entry._idx);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr > _mask)
+		return;
+
+	eraseSlot(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
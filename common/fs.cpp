@@ -21,6 +21,7 @@
 
 #include "common/system.h"
 #include "common/debug.h"
+#include "common/memstream.h"
 #include "common/punycode.h"
 #include "common/textconsole.h"
 #include "backends/fs/abstract-fs.h"
@@ -263,6 +264,32 @@ SeekableReadStream *FSNode::createReadStreamForAltStream(AltStreamType altStream
 	return _realNode->createReadStreamForAltStream(altStreamType);
 }
 
+SeekableReadStream *FSNode::createMappedReadStream() const {
+	if (_realNode == nullptr)
+		return nullptr;
+
+	if (!_realNode->exists()) {
+		warning("FSNode::createMappedReadStream: '%s' does not exist", getName().c_str());
+		return nullptr;
+	} else if (_realNode->isDirectory()) {
+		warning("FSNode::createMappedReadStream: '%s' is a directory", getName().c_str());
+		return nullptr;
+	}
+
+	SeekableReadStream *stream = _realNode->createMappedReadStream();
+	if (stream)
+		return stream;
+
+	return _realNode->createReadStream();
+}
+
+bool FSNode::getFileStats(int64 &size, int64 &modificationTime) const {
+	if (_realNode == nullptr)
+		return false;
+
+	return _realNode->getFileStats(size, modificationTime);
+}
+
 SeekableWriteStream *FSNode::createWriteStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -291,6 +318,11 @@ bool FSNode::createDirectory() const {
 	return _realNode->createDirectory();
 }
 
+bool FSNode::supportsThreadedAccess() {
+	assert(g_system);
+	return g_system->getFilesystemFactory()->supportsThreadedAccess();
+}
+
 FSDirectory::FSDirectory(const FSNode &node, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
   : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
 	_includeDirectories(includeDirectories) {
@@ -45,6 +45,7 @@ namespace Common {
 
 class FSNode;
 class FSDirectory;
+class MappedReadStream;
 class SeekableReadStream;
 class WriteStream;
 class SeekableWriteStream;
@@ -271,6 +272,31 @@ public:
 	 */
 	SeekableReadStream *createReadStreamForAltStream(AltStreamType altStreamType) const override;
 
+	/**
+	 * Create a SeekableReadStream instance corresponding to the file
+	 * referred by this node, preferably by mapping the file into memory.
+	 * The result is then a MappedReadStream, parts of which can be read
+	 * without copying them. If the backend can't map the file, this is the
+	 * same as createReadStream().
+	 *
+	 * Mapping is meant for large files which are kept open for a long time,
+	 * like archives.
+	 *
+	 * @return Pointer to the stream object, nullptr in case of a failure.
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
+	/**
+	 * Retrieve the size and the time of the last modification of the file
+	 * referred by this node, without opening it. The time is only meant to
+	 * be compared with other values returned by this method, to tell whether
+	 * the file has changed.
+	 *
+	 * @return True if the information is available, false if the node does
+	 *         not refer to a file or the backend does not support it.
+	 */
+	bool getFileStats(int64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Create a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -288,6 +314,13 @@ public:
 	 * @return True if the directory was created, false otherwise.
 	 */
 	bool createDirectory() const;
+
+	/**
+	 * Indicate whether nodes may be listed and read from threads other than
+	 * the main thread, provided each node is only used by a single thread.
+	 * If not, the filesystem must only be accessed from the main thread.
+	 */
+	static bool supportsThreadedAccess();
 };
 
 /**
@@ -95,6 +95,50 @@ public:
 	bool seek(int64 offs, int whence = SEEK_SET);
 };
 
+/**
+ * A MemoryReadStream over a shared read-only memory span, usually a
+ * memory mapped file. Parts of the span can be handed out as spans or
+ * streams of their own without copying any data; they keep the whole
+ * span alive for as long as they exist.
+ *
+ * @see FSNode::createMappedReadStream
+ */
+class MappedReadStream : public MemoryReadStream {
+public:
+	MappedReadStream(SharedPtr<byte> span, uint32 spanSize) :
+		MemoryReadStream(span, spanSize), _span(span), _spanSize(spanSize) {}
+
+	/** Return the start of the memory span. */
+	const byte *getData() const { return _span.get(); }
+
+	/**
+	 * Return a part of the memory span, sharing its ownership.
+	 *
+	 * @return The part of the span, nullptr if it is out of bounds.
+	 */
+	SharedPtr<byte> getSpan(uint32 offset, uint32 size) const {
+		if (offset > _spanSize || size > _spanSize - offset)
+			return SharedPtr<byte>();
+		return SharedPtr<byte>(_span, _span.get() + offset);
+	}
+
+	/**
+	 * Create a stream reading a part of the memory span, sharing its
+	 * ownership.
+	 *
+	 * @return The new stream, nullptr if the part is out of bounds.
+	 */
+	MappedReadStream *createSpanStream(uint32 offset, uint32 size) const {
+		if (offset > _spanSize || size > _spanSize - offset)
+			return nullptr;
+		return new MappedReadStream(getSpan(offset, size), size);
+	}
+
+private:
+	SharedPtr<byte> _span;
+	uint32 _spanSize;
+};
+
 
 /**
  * This is a MemoryReadStream subclass which adds non-endian
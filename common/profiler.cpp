@@ -0,0 +1,237 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/profiler.h"
+#include "common/file.h"
+#include "common/spsc-queue.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+#ifdef USE_THREADS
+#include <chrono>
+#endif
+
+namespace Common {
+
+DECLARE_SINGLETON(Profiler);
+
+enum {
+	// Zones a thread can record between two calls to endFrame()
+	kThreadBufferSize = 4096,
+	// Zones kept in memory while tracing, about 32 MB
+	kMaxTraceZones = 1024 * 1024
+};
+
+class Profiler::ThreadBuffer {
+public:
+	explicit ThreadBuffer(uint idx) : index(idx), next(nullptr), dropped(0) {}
+
+	SPSCQueue<Zone, kThreadBufferSize> zones;
+	uint index;
+	ThreadBuffer *next;
+	Atomic<uint32> dropped;
+};
+
+Atomic<bool> Profiler::_enabled(false);
+// Buffers are never freed, since the collecting thread can't know when a
+// thread has exited
+Atomic<Profiler::ThreadBuffer *> Profiler::_threadBuffers(nullptr);
+#ifdef ATOMICS_ARE_LOCK_FREE
+thread_local Profiler::ThreadBuffer *Profiler::_currentThreadBuffer = nullptr;
+static Atomic<uint> s_threadCount(0);
+#endif
+
+Profiler::Profiler() : _frameCount(0), _droppedCount(0), _frameStart(0) {
+}
+
+Profiler::~Profiler() {
+	_enabled = false;
+	stopTrace();
+}
+
+void Profiler::setEnabled(bool enabled) {
+	_frameStart = 0;
+	_enabled = enabled;
+}
+
+uint64 Profiler::getMicros() {
+#ifdef USE_THREADS
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+	return (uint64)g_system->getMillis(true) * 1000;
+#endif
+}
+
+void Profiler::addZone(const char *name, uint64 start, uint64 end) {
+	Zone zone;
+	zone.name = name;
+	zone.start = start;
+	zone.end = end;
+
+#ifdef ATOMICS_ARE_LOCK_FREE
+	ThreadBuffer *buffer = _currentThreadBuffer;
+	if (!buffer) {
+		buffer = new ThreadBuffer(s_threadCount.fetchAdd(1));
+		buffer->next = _threadBuffers.load(kMemoryOrderRelaxed);
+		while (!_threadBuffers.compareExchangeWeak(buffer->next, buffer, kMemoryOrderRelease, kMemoryOrderRelaxed))
+			;
+		_currentThreadBuffer = buffer;
+	}
+
+	if (!buffer->zones.push(zone))
+		buffer->dropped.fetchAdd(1, kMemoryOrderRelaxed);
+#else
+	// The profiler was created when it got enabled, so this does not create
+	// it from another thread
+	StackLock lock(instance()._bufferMutex);
+	ThreadBuffer *buffer = _threadBuffers.load();
+	if (!buffer) {
+		buffer = new ThreadBuffer(0);
+		_threadBuffers.store(buffer);
+	}
+
+	if (!buffer->zones.push(zone))
+		buffer->dropped.fetchAdd(1);
+#endif
+}
+
+void Profiler::endFrame() {
+	if (!isEnabled())
+		return;
+
+	const uint64 now = getMicros();
+	if (_frameStart) {
+		addZone("Frame", _frameStart, now);
+		_frameCount++;
+	}
+	_frameStart = now;
+
+	collect();
+}
+
+void Profiler::collectZones() {
+	if (isEnabled())
+		collect();
+}
+
+void Profiler::reset() {
+	collect();
+
+	_stats.clear();
+	_frameCount = 0;
+	_droppedCount = 0;
+}
+
+const Profiler::StatsMap &Profiler::getStats() {
+	collect();
+	return _stats;
+}
+
+void Profiler::collect() {
+#ifndef ATOMICS_ARE_LOCK_FREE
+	StackLock lock(_bufferMutex);
+#endif
+	for (ThreadBuffer *buffer = _threadBuffers.load(kMemoryOrderAcquire); buffer; buffer = buffer->next) {
+		Zone zone;
+		while (buffer->zones.pop(zone)) {
+			addStats(zone.name, zone.end - zone.start);
+
+			if (!isTracing())
+				continue;
+
+			if (_trace.size() < kMaxTraceZones) {
+				TraceZone traceZone;
+				traceZone.zone = zone;
+				traceZone.thread = buffer->index;
+				_trace.push_back(traceZone);
+			} else {
+				_droppedCount++;
+			}
+		}
+
+		_droppedCount += buffer->dropped.exchange(0, kMemoryOrderRelaxed);
+	}
+}
+
+void Profiler::addStats(const char *name, uint64 duration) {
+	ProfileZoneStats &stats = _stats[name];
+	if (!stats.count || duration < stats.min)
+		stats.min = duration;
+	if (duration > stats.max)
+		stats.max = duration;
+	stats.total += duration;
+	stats.count++;
+}
+
+void Profiler::startTrace(const Path &fileName) {
+	collect();
+
+	_traceFile = fileName;
+	_trace.clear();
+}
+
+bool Profiler::stopTrace() {
+	if (!isTracing())
+		return false;
+
+	collect();
+
+	const Path fileName = _traceFile;
+	_traceFile.clear();
+
+	DumpFile file;
+	if (!file.open(fileName)) {
+		warning("Profiler: Could not write trace to '%s'", fileName.toString(Path::kNativeSeparator).c_str());
+		_trace.clear();
+		return false;
+	}
+
+	// Complete ("X") events of the Trace Event Format. The timestamps and
+	// durations are in microseconds, relative to the earliest zone.
+	uint64 base = _trace.empty() ? 0 : _trace[0].zone.start;
+	for (uint i = 1; i < _trace.size(); i++)
+		base = MIN(base, _trace[i].zone.start);
+
+	file.writeString("{\"traceEvents\":[\n");
+	for (uint i = 0; i < _trace.size(); i++) {
+		const TraceZone &traceZone = _trace[i];
+
+		String name;
+		for (const char *c = traceZone.zone.name; *c; c++) {
+			if (*c == '"' || *c == '\\')
+				name += '\\';
+			name += *c;
+		}
+
+		file.writeString(String::format("%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lld,\"dur\":%lld}\n",
+			i ? "," : "", name.c_str(), traceZone.thread,
+			(long long)(traceZone.zone.start - base), (long long)(traceZone.zone.end - traceZone.zone.start)));
+	}
+	file.writeString("]}\n");
+
+	_trace.clear();
+	return file.flush() && !file.err();
+}
+
+} // End of namespace Common
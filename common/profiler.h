@@ -0,0 +1,195 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_PROFILER_H
+#define COMMON_PROFILER_H
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/mutex.h"
+#include "common/path.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_profiler Profiler
+ * @ingroup common
+ *
+ * @brief Timing of code sections ("zones"), for finding slow frames.
+ * @{
+ */
+
+/**
+ * Mark the rest of the current scope as a profiler zone with the given name.
+ * The name must be a string literal, or otherwise stay valid forever.
+ */
+#define PROFILE_ZONE(name) Common::ProfileZone PROFILE_ZONE_VAR(__LINE__)(name)
+#define PROFILE_ZONE_VAR(line) PROFILE_ZONE_VAR2(line)
+#define PROFILE_ZONE_VAR2(line) profileZone##line
+
+/** Timings of a zone, in microseconds. */
+struct ProfileZoneStats {
+	ProfileZoneStats() : count(0), total(0), min(0), max(0) {}
+
+	uint32 count;
+	uint64 total;
+	uint64 min;
+	uint64 max;
+};
+
+/**
+ * Collects the timings of the zones marked with PROFILE_ZONE.
+ *
+ * Profiling is off by default, and a zone then only costs a check of a
+ * flag. When it is on, each thread writes the zones it leaves into its own
+ * lock-free ring buffer. Without ATOMICS_ARE_LOCK_FREE, all threads share a
+ * single buffer guarded by a mutex instead.
+ *
+ * The buffers are drained by endFrame(), which the modular graphics backend
+ * calls on every screen update, by collectZones(), which the event manager
+ * calls whenever it polls for events, and by the functions that query the
+ * results. All of those must be called from the main thread.
+ */
+class Profiler : public Singleton<Profiler> {
+public:
+	typedef HashMap<String, ProfileZoneStats> StatsMap;
+
+	Profiler();
+	~Profiler();
+
+	/** Whether zones are currently being recorded. */
+	static bool isEnabled() { return _enabled.load(kMemoryOrderRelaxed); }
+
+	/** Start or stop recording zones. Recorded timings are kept. */
+	void setEnabled(bool enabled);
+
+	/** Microseconds since an arbitrary point in time, with the best available precision. */
+	static uint64 getMicros();
+
+	/** Record a zone that has been left. Called by ProfileZone, from any thread. */
+	static void addZone(const char *name, uint64 start, uint64 end);
+
+	/** Mark the end of a frame and collect the zones recorded since the last call. */
+	void endFrame();
+
+	/**
+	 * Collect the zones recorded so far, without marking the end of a frame.
+	 * This keeps the buffers from filling up on backends which do not call
+	 * endFrame(), although no frame timings are recorded there.
+	 */
+	void collectZones();
+
+	/** Forget all timings recorded so far. */
+	void reset();
+
+	/** Timings of all zones recorded since the last reset. */
+	const StatsMap &getStats();
+
+	/** Number of frames since the last reset. */
+	uint32 getFrameCount() const { return _frameCount; }
+
+	/** Number of zones that were lost since the last reset, because a thread recorded too many of them per frame. */
+	uint32 getDroppedCount() const { return _droppedCount; }
+
+	/**
+	 * Keep all recorded zones in memory until stopTrace() is called, which
+	 * then writes them to @p fileName as JSON for Chrome's trace viewer
+	 * (chrome://tracing) or compatible tools.
+	 */
+	void startTrace(const Path &fileName);
+
+	/**
+	 * Write the zones recorded since startTrace() to the trace file.
+	 *
+	 * @return False if no trace was running or the file could not be written.
+	 */
+	bool stopTrace();
+
+	/** Whether a trace is being recorded. */
+	bool isTracing() const { return !_traceFile.empty(); }
+
+private:
+	struct Zone {
+		const char *name;
+		uint64 start;
+		uint64 end;
+	};
+
+	struct TraceZone {
+		Zone zone;
+		uint thread;
+	};
+
+	class ThreadBuffer;
+
+	void collect();
+	void addStats(const char *name, uint64 duration);
+
+	static Atomic<bool> _enabled;
+	static Atomic<ThreadBuffer *> _threadBuffers;
+#ifdef ATOMICS_ARE_LOCK_FREE
+	static thread_local ThreadBuffer *_currentThreadBuffer;
+#else
+	Mutex _bufferMutex; ///< Guards the single buffer shared by all threads
+#endif
+
+	StatsMap _stats;
+	uint32 _frameCount;
+	uint32 _droppedCount;
+	uint64 _frameStart;
+
+	Path _traceFile;
+	Array<TraceZone> _trace;
+};
+
+/**
+ * Records the time from its construction to its destruction as a zone of
+ * the profiler. Usually created through PROFILE_ZONE.
+ */
+class ProfileZone {
+public:
+	explicit ProfileZone(const char *name) : _name(nullptr), _start(0) {
+		if (Profiler::isEnabled()) {
+			_name = name;
+			_start = Profiler::getMicros();
+		}
+	}
+
+	~ProfileZone() {
+		if (_name)
+			Profiler::addZone(_name, _start, Profiler::getMicros());
+	}
+
+private:
+	const char *_name;
+	uint64 _start;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -197,6 +197,17 @@ public:
 			_tracker->incStrong();
 	}
 
+	/**
+	 * Creates a SharedPtr which shares the ownership of r, but points to p.
+	 * p is usually a part of the object managed by r, e.g. a member or a
+	 * position inside a buffer, and stays valid as long as r's object lives.
+	 */
+	template<class T2>
+	SharedPtr(const SharedPtr<T2> &r, T *p) : _pointer(p), _tracker(r._tracker) {
+		if (_tracker)
+			_tracker->incStrong();
+	}
+
 	template<class T2>
 	explicit SharedPtr(const WeakPtr<T2> &r) : _pointer(nullptr), _tracker(nullptr) {
 		if (r._tracker && r._tracker->isAlive()) {
@@ -0,0 +1,112 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_SPSC_QUEUE_H
+#define COMMON_SPSC_QUEUE_H
+
+#include "common/atomic.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_spsc_queue Lock-free queue
+ * @ingroup common
+ *
+ * @brief Bounded queue for passing data between two threads without locking.
+ * @{
+ */
+
+/**
+ * Fixed size ring buffer that one thread can push to while another thread
+ * pops from it, without either of them having to take a lock.
+ *
+ * Only a single producer and a single consumer are supported at a time. If
+ * several threads need to push, they have to serialize among themselves
+ * (e.g. with a Common::Mutex that the consumer never touches).
+ *
+ * Without ATOMICS_ARE_LOCK_FREE, the queue is only safe to use from a single
+ * thread, or with both sides holding the same Common::Mutex.
+ *
+ * @tparam T    Type of the elements. It is copied in and out of the queue.
+ * @tparam SIZE Capacity of the queue. It must be a power of two.
+ */
+template<class T, uint SIZE>
+class SPSCQueue {
+public:
+	SPSCQueue() : _head(0), _tail(0) {
+		static_assert((SIZE & (SIZE - 1)) == 0, "SPSCQueue size must be a power of two");
+	}
+
+	/**
+	 * Append an element to the queue. Must only be called by the producer.
+	 *
+	 * @return False if the queue is full and the element was not added.
+	 */
+	bool push(const T &x) {
+		const uint32 tail = _tail.load(kMemoryOrderRelaxed);
+		if (tail - _head.load(kMemoryOrderAcquire) == SIZE)
+			return false;
+
+		_storage[tail & (SIZE - 1)] = x;
+		_tail.store(tail + 1, kMemoryOrderRelease);
+		return true;
+	}
+
+	/**
+	 * Remove the oldest element from the queue. Must only be called by the
+	 * consumer.
+	 *
+	 * @return False if the queue is empty and @p x was left untouched.
+	 */
+	bool pop(T &x) {
+		const uint32 head = _head.load(kMemoryOrderRelaxed);
+		if (head == _tail.load(kMemoryOrderAcquire))
+			return false;
+
+		x = _storage[head & (SIZE - 1)];
+		_head.store(head + 1, kMemoryOrderRelease);
+		return true;
+	}
+
+	/** Whether the queue is empty, as currently seen from the calling thread. */
+	bool empty() const {
+		return _head.load(kMemoryOrderAcquire) == _tail.load(kMemoryOrderAcquire);
+	}
+
+	/** Whether the queue is full, as currently seen from the calling thread. */
+	bool full() const {
+		return _tail.load(kMemoryOrderAcquire) - _head.load(kMemoryOrderAcquire) == SIZE;
+	}
+
+	/** The maximum number of elements the queue can hold. */
+	uint capacity() const { return SIZE; }
+
+private:
+	T _storage[SIZE];
+	Atomic<uint32> _head;
+	Atomic<uint32> _tail;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,193 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/threadpool.h"
+#include "common/util.h"
+
+#ifdef USE_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Common {
+
+DECLARE_SINGLETON(ThreadPool);
+
+#ifdef USE_THREADS
+
+class ThreadPoolImpl {
+public:
+	explicit ThreadPoolImpl(uint numWorkers);
+	~ThreadPoolImpl();
+
+	uint getWorkerCount() const { return _numWorkers; }
+
+	bool tryRun(ThreadPool::TaskFunc func, void *data, uint count);
+
+private:
+	void workerMain();
+	void work();
+
+	std::thread *_workers;
+	uint _numWorkers;
+	std::atomic<bool> _busy;
+
+	std::mutex _mutex;
+	std::condition_variable _jobCond;
+	std::condition_variable _doneCond;
+	uint32 _generation;
+	uint _activeWorkers;
+	bool _quit;
+
+	// The current job. It is only changed while no worker is active.
+	ThreadPool::TaskFunc _func;
+	void *_data;
+	uint _count;
+	std::atomic<uint> _next;
+};
+
+ThreadPoolImpl::ThreadPoolImpl(uint numWorkers)
+	: _workers(new std::thread[numWorkers]), _numWorkers(numWorkers), _busy(false),
+	  _generation(0), _activeWorkers(0), _quit(false),
+	  _func(nullptr), _data(nullptr), _count(0), _next(0) {
+	for (uint i = 0; i < _numWorkers; i++)
+		_workers[i] = std::thread(&ThreadPoolImpl::workerMain, this);
+}
+
+ThreadPoolImpl::~ThreadPoolImpl() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+	_jobCond.notify_all();
+
+	for (uint i = 0; i < _numWorkers; i++)
+		_workers[i].join();
+	delete[] _workers;
+}
+
+bool ThreadPoolImpl::tryRun(ThreadPool::TaskFunc func, void *data, uint count) {
+	if (_busy.exchange(true))
+		return false;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_func = func;
+		_data = data;
+		_count = count;
+		_next = 0;
+		_activeWorkers = _numWorkers;
+		_generation++;
+	}
+	_jobCond.notify_all();
+
+	work();
+
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_doneCond.wait(lock, [this] { return _activeWorkers == 0; });
+	}
+
+	_busy = false;
+	return true;
+}
+
+void ThreadPoolImpl::workerMain() {
+	uint32 generation = 0;
+
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_jobCond.wait(lock, [this, generation] { return _quit || _generation != generation; });
+			if (_quit)
+				return;
+			generation = _generation;
+		}
+
+		work();
+
+		bool done;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			done = (--_activeWorkers == 0);
+		}
+		if (done)
+			_doneCond.notify_one();
+	}
+}
+
+void ThreadPoolImpl::work() {
+	for (uint i = _next++; i < _count; i = _next++)
+		_func(_data, i);
+}
+
+static uint getDefaultThreadCount() {
+	// Some implementations report 0 if they cannot tell. Limit the count as
+	// well, since the tasks are rarely worth more threads than that.
+	return CLIP<uint>(std::thread::hardware_concurrency(), 1, 16);
+}
+
+ThreadPool::ThreadPool(uint numThreads) {
+	if (numThreads == 0)
+		numThreads = getDefaultThreadCount();
+	_impl = new ThreadPoolImpl(numThreads - 1);
+}
+
+ThreadPool::~ThreadPool() {
+	delete _impl;
+}
+
+uint ThreadPool::getThreadCount() const {
+	return _impl->getWorkerCount() + 1;
+}
+
+void ThreadPool::run(TaskFunc func, void *data, uint count) {
+	if (count > 1 && _impl->getWorkerCount() > 0 && _impl->tryRun(func, data, count))
+		return;
+
+	for (uint i = 0; i < count; i++)
+		func(data, i);
+}
+
+#else
+
+ThreadPool::ThreadPool(uint numThreads) : _impl(nullptr) {
+}
+
+ThreadPool::~ThreadPool() {
+}
+
+uint ThreadPool::getThreadCount() const {
+	return 1;
+}
+
+void ThreadPool::run(TaskFunc func, void *data, uint count) {
+	for (uint i = 0; i < count; i++)
+		func(data, i);
+}
+
+#endif
+
+} // End of namespace Common
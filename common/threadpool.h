@@ -0,0 +1,97 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include "common/scummsys.h"
+#include "common/singleton.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_threadpool Thread pool
+ * @ingroup common
+ *
+ * @brief Worker threads for running independent tasks in parallel.
+ * @{
+ */
+
+class ThreadPoolImpl;
+
+/**
+ * A fixed set of worker threads that run the iterations of a loop in parallel.
+ *
+ * The calling thread takes part in the work, so a pool of a single thread
+ * has no workers at all and just runs the loop in place. This is also what
+ * happens when ScummVM is built without thread support.
+ *
+ * Tasks must not touch state that other tasks or the rest of ScummVM use at
+ * the same time. Note that Common::String and Common::SharedPtr do not count
+ * their references atomically, so even handing copies of the same string to
+ * several tasks is not safe.
+ *
+ * A pool shared by the whole application is available through instance().
+ */
+class ThreadPool : public Singleton<ThreadPool> {
+public:
+	/** Function called for each index of a loop run by the pool. */
+	typedef void (*TaskFunc)(void *data, uint index);
+
+	/**
+	 * @param numThreads Number of threads working on a loop, including the
+	 *                   calling thread. With 0, one thread per CPU core is used.
+	 */
+	explicit ThreadPool(uint numThreads = 0);
+	~ThreadPool();
+
+	/** The number of threads working on a loop, including the calling thread. */
+	uint getThreadCount() const;
+
+	/**
+	 * Call @p func once for every index in [0, count) and return once all
+	 * calls have finished. The calls are made in no particular order.
+	 *
+	 * If the pool is busy already, e.g. because run() is called from within
+	 * a task, the loop runs serially on the calling thread instead.
+	 */
+	void run(TaskFunc func, void *data, uint count);
+
+	/** Call @p func(index) for every index in [0, count), like run() does. */
+	template<class F>
+	void parallelFor(uint count, const F &func) {
+		run(&callFunctor<F>, const_cast<F *>(&func), count);
+	}
+
+private:
+	template<class F>
+	static void callFunctor(void *data, uint index) {
+		(*(const F *)data)(index);
+	}
+
+	ThreadPoolImpl *_impl;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -30,6 +30,7 @@
 #include "common/punycode.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
 #include "common/compression/installshield_cab.h"
@@ -517,6 +518,198 @@ namespace Common {
 	DECLARE_SINGLETON(AdvancedDetectorCacheManager);
 }
 
+/**
+ * Split @p line at the first @p count - 1 tabs. The last field receives the
+ * rest of the line, so that it may contain tabs itself.
+ */
+static bool splitDiskCacheLine(const Common::String &line, Common::String *fields, uint count) {
+	uint start = 0;
+	for (uint i = 0; i < count - 1; i++) {
+		size_t tab = line.findFirstOf('\t', start);
+		if (tab == Common::String::npos)
+			return false;
+		fields[i] = Common::String(line.c_str() + start, tab - start);
+		start = tab + 1;
+	}
+	fields[count - 1] = Common::String(line.c_str() + start);
+	return !fields[count - 1].empty();
+}
+
+bool AdvancedDetectorCacheManager::isDiskCacheEnabled() const {
+	return ConfMan.getBool("detection_cache") && !getDiskCachePath().empty();
+}
+
+Common::Path AdvancedDetectorCacheManager::getDiskCachePath() const {
+	Common::Path configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+	if (configFile.empty())
+		return Common::Path();
+
+	return configFile.getParent().appendComponent("scummvm-detection.cache");
+}
+
+uint32 AdvancedDetectorCacheManager::getDiskCacheDay() {
+	TimeDate td;
+	g_system->getTimeAndDate(td, true);
+
+	// Days since 1900-03-01, which is all we need to age the entries
+	int year = td.tm_year, month = td.tm_mon + 1;
+	if (month <= 2) {
+		year--;
+		month += 12;
+	}
+	return year * 365 + year / 4 - year / 100 + (year + 300) / 400 + (153 * (month - 3) + 2) / 5 + td.tm_mday - 1;
+}
+
+void AdvancedDetectorCacheManager::loadDiskCache() {
+	diskCacheLoaded = true;
+	diskCacheMap.clear();
+
+	if (!isDiskCacheEnabled())
+		return;
+
+	// --rebuild-detection-cache: start from scratch, which overwrites the
+	// old cache on the next flush
+	if (ConfMan.getBool("rebuild_detection_cache")) {
+		diskCacheDirty = true;
+		return;
+	}
+
+	Common::FSNode node(getDiskCachePath());
+	Common::File file;
+	if (!node.exists() || !file.open(node))
+		return;
+
+	if (file.readLine() != Common::String::format("# ScummVM detection cache, version %d", kDiskCacheVersion)) {
+		debugC(2, kDebugGlobalDetection, "Discarding detection cache with unknown version");
+		diskCacheDirty = true;
+		return;
+	}
+
+	DiskCacheEntry *entry = nullptr;
+	Common::String fields[4];
+	while (!file.eos() && !file.err()) {
+		Common::String line = file.readLine();
+		if (line.empty())
+			continue;
+
+		if (line.hasPrefix("F\t") && splitDiskCacheLine(line.c_str() + 2, fields, 4)) {
+			entry = &diskCacheMap[fields[3]];
+			entry->modificationTime = atoll(fields[0].c_str());
+			entry->size = atoll(fields[1].c_str());
+			entry->lastUsed = atol(fields[2].c_str());
+		} else if (line.hasPrefix("P\t") && entry && splitDiskCacheLine(line.c_str() + 2, fields, 4)) {
+			FileProperties &props = entry->properties[fields[3]];
+			props.md5prop = (MD5Properties)atol(fields[0].c_str());
+			props.size = atoll(fields[1].c_str());
+			props.md5 = fields[2];
+		} else {
+			warning("Ignoring malformed line in detection cache: '%s'", line.c_str());
+			entry = nullptr;
+		}
+	}
+
+	debugC(2, kDebugGlobalDetection, "Loaded %u files from the detection cache", diskCacheMap.size());
+}
+
+void AdvancedDetectorCacheManager::saveDiskCache() {
+	const Common::Path path = getDiskCachePath();
+	Common::DumpFile file;
+	if (!file.open(path, !path.getParent().empty())) {
+		warning("Unable to write detection cache '%s'", path.toString(Common::Path::kNativeSeparator).c_str());
+		return;
+	}
+
+	const uint32 today = getDiskCacheDay();
+	file.writeString(Common::String::format("# ScummVM detection cache, version %d\n", kDiskCacheVersion));
+
+	for (DiskCacheMap::iterator i = diskCacheMap.begin(); i != diskCacheMap.end(); ++i) {
+		const DiskCacheEntry &entry = i->_value;
+		if (entry.lastUsed + kDiskCacheMaxAge < today)
+			continue;
+
+		file.writeString(Common::String::format("F\t%lld\t%lld\t%u\t%s\n", (long long)entry.modificationTime, (long long)entry.size, entry.lastUsed, i->_key.c_str()));
+		for (Common::HashMap<Common::String, FileProperties>::const_iterator j = entry.properties.begin(); j != entry.properties.end(); ++j)
+			file.writeString(Common::String::format("P\t%d\t%lld\t%s\t%s\n", (int)j->_value.md5prop, (long long)j->_value.size, j->_value.md5.c_str(), j->_key.c_str()));
+	}
+
+	if (!file.flush() || file.err())
+		warning("Failed to write detection cache '%s'", path.toString(Common::Path::kNativeSeparator).c_str());
+	file.close();
+}
+
+bool AdvancedDetectorCacheManager::getDiskCachedProperties(const Common::FSNode &node, const Common::String &key, FileProperties &fileProps) {
+	if (!diskCacheLoaded)
+		loadDiskCache();
+
+	if (diskCacheMap.empty())
+		return false;
+
+	DiskCacheMap::iterator i = diskCacheMap.find(node.getPath().toString(Common::Path::kNativeSeparator));
+	if (i == diskCacheMap.end() || !i->_value.properties.contains(key))
+		return false;
+
+	int64 size, modificationTime;
+	if (!node.getFileStats(size, modificationTime) || size != i->_value.size || modificationTime != i->_value.modificationTime) {
+		// The file changed, so all its entries are stale
+		diskCacheMap.erase(i);
+		diskCacheDirty = true;
+		return false;
+	}
+
+	const uint32 today = getDiskCacheDay();
+	if (i->_value.lastUsed != today) {
+		i->_value.lastUsed = today;
+		diskCacheDirty = true;
+	}
+
+	fileProps = i->_value.properties[key];
+	return true;
+}
+
+void AdvancedDetectorCacheManager::setDiskCachedProperties(const Common::FSNode &node, const Common::String &key, const FileProperties &fileProps) {
+	if (!diskCacheLoaded)
+		loadDiskCache();
+
+	if (!isDiskCacheEnabled())
+		return;
+
+	// Only files whose changes we can detect are cached
+	int64 size, modificationTime;
+	if (!node.getFileStats(size, modificationTime))
+		return;
+
+	Common::String path = node.getPath().toString(Common::Path::kNativeSeparator);
+	if (path.contains('\n') || key.contains('\t') || key.contains('\n'))
+		return;
+
+	DiskCacheEntry &entry = diskCacheMap[path];
+	if (entry.size != size || entry.modificationTime != modificationTime) {
+		entry.properties.clear();
+		entry.size = size;
+		entry.modificationTime = modificationTime;
+	}
+	entry.lastUsed = getDiskCacheDay();
+	entry.properties[key] = fileProps;
+	diskCacheDirty = true;
+}
+
+void AdvancedDetectorCacheManager::flushDiskCache(bool force) {
+	if (!diskCacheDirty)
+		return;
+
+	const uint32 now = g_system->getMillis();
+	if (!force && now - diskCacheLastFlush < kDiskCacheFlushInterval)
+		return;
+
+	if (isDiskCacheEnabled())
+		saveDiskCache();
+
+	diskCacheDirty = false;
+	diskCacheLastFlush = now;
+}
+
 
 static MD5Properties gameFileToMD5Props(const ADGameFileDescription *fileEntry, uint32 gameFlags) {
 	MD5Properties ret = kMD5Head;
@@ -580,13 +773,19 @@ Common::String md5PropToGameFile(MD5Properties flags) {
 }
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps);
+static bool getFilePropertiesDiskCached(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps);
+
+static Common::String getPropertiesCacheKey(MD5Properties md5prop, const Common::String &fname, uint md5Bytes) {
+	Common::String key = md5PropToCachePrefix(md5prop);
+	key += ':';
+	key += fname;
+	key += ':';
+	key += Common::String::format("%d", md5Bytes);
+	return key;
+}
 
 bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
-	Common::String hashname = md5PropToCachePrefix(md5prop);
-		hashname += ':';
-		hashname += fname.toString('/');
-		hashname += ':';
-		hashname += Common::String::format("%d", _md5Bytes);
+	Common::String hashname = getPropertiesCacheKey(md5prop, fname.toString('/'), _md5Bytes);
 
 	if (ADCacheMan.containsMD5(hashname)) {
 		fileProps.md5 = ADCacheMan.getMD5(hashname);
@@ -594,7 +793,7 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, MD5
 		return true;
 	}
 
-	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, md5prop, fname, fileProps);
+	bool res = getFilePropertiesDiskCached(_md5Bytes, allFiles, md5prop, fname, fileProps);
 
 	if (res) {
 		ADCacheMan.setMD5(hashname, fileProps.md5);
@@ -605,7 +804,151 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, MD5
 }
 
 bool AdvancedMetaEngine::getFilePropertiesExtern(uint md5Bytes, const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const {
-	return getFilePropertiesIntern(md5Bytes, allFiles, md5prop, fname, fileProps);
+	return getFilePropertiesDiskCached(md5Bytes, allFiles, md5prop, fname, fileProps);
+}
+
+static bool getFilePropertiesDiskCached(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) {
+	// Mac forks may come from one of several files, depending on how the
+	// game was copied, so their changes can't be tracked reliably
+	if (md5prop & (kMD5MacResFork | kMD5MacDataFork))
+		return getFilePropertiesIntern(md5Bytes, allFiles, md5prop, fname, fileProps);
+
+	// Find the file the properties are computed from. For archive members,
+	// this is the archive.
+	Common::Path path = fname;
+	Common::String member;
+	if (md5prop & kMD5Archive) {
+		Common::StringTokenizer tok(fname.toString(), ":");
+		tok.nextToken();
+		path = Common::Path(tok.nextToken());
+		member = fname.toString('/');
+	}
+	Common::String key = getPropertiesCacheKey(md5prop, member, md5Bytes);
+
+	if (!allFiles.contains(path))
+		return false;
+
+	const Common::FSNode &node = allFiles[path];
+	if (ADCacheMan.getDiskCachedProperties(node, key, fileProps))
+		return true;
+
+	if (!getFilePropertiesIntern(md5Bytes, allFiles, md5prop, fname, fileProps))
+		return false;
+
+	ADCacheMan.setDiskCachedProperties(node, key, fileProps);
+	return true;
+}
+
+namespace {
+
+// A file that getFilesProperties() reads on the thread pool, together with
+// all the requests it answers
+struct FileHashJob {
+	FileHashJob() : md5Bytes(0), allFiles(nullptr), requests(nullptr) {}
+
+	uint md5Bytes;
+	const AdvancedMetaEngine::FileMap *allFiles;
+	Common::Array<AdvancedMetaEngineDetection::FilePropertiesRequest> *requests;
+	Common::Array<uint> indices;
+};
+
+// Unlike getFilePropertiesIntern(), this reads the node directly instead of
+// through Common::File, so that nothing is logged from the worker threads
+bool getPlainFileProperties(uint md5Bytes, const Common::FSNode &node, MD5Properties md5prop, FileProperties &fileProps) {
+	if (!node.exists() || node.isDirectory())
+		return false;
+
+	Common::ScopedPtr<Common::SeekableReadStream> testFile(node.createReadStream());
+	if (!testFile)
+		return false;
+
+	if (md5prop & kMD5Tail) {
+		if (testFile->size() > md5Bytes)
+			testFile->seek(-(int64)md5Bytes, SEEK_END);
+	}
+
+	fileProps.size = testFile->size();
+	fileProps.md5 = Common::computeStreamMD5AsString(*testFile.get(), md5Bytes);
+	fileProps.md5prop = (MD5Properties) (md5prop & kMD5Tail);
+	return true;
+}
+
+void runFileHashJob(void *data, uint index) {
+	FileHashJob &job = ((FileHashJob *)data)[index];
+
+	for (uint i = 0; i < job.indices.size(); i++) {
+		AdvancedMetaEngineDetection::FilePropertiesRequest &request = (*job.requests)[job.indices[i]];
+		request.found = getPlainFileProperties(job.md5Bytes, (*job.allFiles)[request.fname], request.md5prop, request.fileProps);
+	}
+}
+
+} // End of anonymous namespace
+
+void AdvancedMetaEngineDetection::getFilesProperties(const FileMap &allFiles, Common::Array<FilePropertiesRequest> &requests) const {
+	// Requests that can't be answered from the caches are collected, grouped
+	// by the file they read, since a file may be requested under several
+	// names or with different MD5 properties. The files are then hashed on
+	// the thread pool, if the filesystem can be accessed from other threads.
+	// Everything else, including the caches and archives, is not thread-safe
+	// and is only touched from this thread.
+	Common::Array<FileHashJob> jobs;
+	Common::HashMap<Common::Path, uint, Common::Path::Hash, Common::Path::EqualTo> jobIndices;
+
+	for (uint i = 0; i < requests.size(); i++) {
+		FilePropertiesRequest &request = requests[i];
+		request.found = false;
+
+		// Only plain files which are not cached yet are read in parallel
+		Common::String hashname = getPropertiesCacheKey(request.md5prop, request.fname.toString('/'), _md5Bytes);
+		if ((request.md5prop & (kMD5MacResFork | kMD5MacDataFork | kMD5Archive)) || ADCacheMan.containsMD5(hashname)) {
+			request.found = getFileProperties(allFiles, request.md5prop, request.fname, request.fileProps);
+			continue;
+		}
+
+		if (!allFiles.contains(request.fname))
+			continue;
+
+		const Common::FSNode &node = allFiles[request.fname];
+		if (ADCacheMan.getDiskCachedProperties(node, getPropertiesCacheKey(request.md5prop, Common::String(), _md5Bytes), request.fileProps)) {
+			ADCacheMan.setMD5(hashname, request.fileProps.md5);
+			ADCacheMan.setSize(hashname, request.fileProps.size);
+			request.found = true;
+			continue;
+		}
+
+		Common::Path path = node.getPath();
+		uint jobIndex;
+		if (jobIndices.tryGetVal(path, jobIndex)) {
+			jobs[jobIndex].indices.push_back(i);
+		} else {
+			jobIndices[path] = jobs.size();
+			jobs.push_back(FileHashJob());
+			jobs.back().md5Bytes = _md5Bytes;
+			jobs.back().allFiles = &allFiles;
+			jobs.back().requests = &requests;
+			jobs.back().indices.push_back(i);
+		}
+	}
+
+	if (Common::FSNode::supportsThreadedAccess()) {
+		Common::ThreadPool::instance().run(runFileHashJob, jobs.data(), jobs.size());
+	} else {
+		for (uint j = 0; j < jobs.size(); j++)
+			runFileHashJob(jobs.data(), j);
+	}
+
+	for (uint j = 0; j < jobs.size(); j++) {
+		for (uint i = 0; i < jobs[j].indices.size(); i++) {
+			const FilePropertiesRequest &request = requests[jobs[j].indices[i]];
+			if (!request.found)
+				continue;
+
+			Common::String hashname = getPropertiesCacheKey(request.md5prop, request.fname.toString('/'), _md5Bytes);
+			ADCacheMan.setMD5(hashname, request.fileProps.md5);
+			ADCacheMan.setSize(hashname, request.fileProps.size);
+			ADCacheMan.setDiskCachedProperties(allFiles[request.fname], getPropertiesCacheKey(request.md5prop, Common::String(), _md5Bytes), request.fileProps);
+		}
+	}
 }
 
 static bool getFilePropertiesIntern(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) {
@@ -777,28 +1120,40 @@ ADDetectedGames AdvancedMetaEngineDetection::detectGame(const Common::FSNode &pa
 
 	// Check which files are included in some ADGameDescription *and* whether
 	// they are present. Compute MD5s and file sizes for the available files.
+	Common::Array<FilePropertiesRequest> requests;
+	Common::StringArray requestKeys;
+
 	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameId != nullptr; descPtr += _descItemSize) {
 		g = (const ADGameDescription *)descPtr;
 
 		for (fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
 			MD5Properties md5prop = gameFileToMD5Props(fileDesc, g->flags);
-			Common::String fname = fileDesc->fileName;
 			Common::String key = md5PropToCachePrefix(md5prop);
 				key += ':';
-				key += fname;
+				key += fileDesc->fileName;
 
 			if (filesProps.contains(key))
 				continue;
 
-			FileProperties tmp;
-			if (getFileProperties(allFiles, md5prop, Common::Path(fname), tmp)) {
-				debugC(3, kDebugGlobalDetection, "> '%s': '%s' %ld", key.c_str(), tmp.md5.c_str(), long(tmp.size));
-			}
-
 			// Both positive and negative results are cached to avoid
 			// repeatedly checking for files.
-			filesProps[key] = tmp;
+			filesProps[key] = FileProperties();
+			requests.push_back(FilePropertiesRequest());
+			requests.back().md5prop = md5prop;
+			requests.back().fname = Common::Path(fileDesc->fileName);
+			requestKeys.push_back(key);
+		}
+	}
+
+	getFilesProperties(allFiles, requests);
+
+	for (uint r = 0; r < requests.size(); r++) {
+		const FileProperties &tmp = requests[r].fileProps;
+		if (requests[r].found) {
+			debugC(3, kDebugGlobalDetection, "> '%s': '%s' %ld", requestKeys[r].c_str(), tmp.md5.c_str(), long(tmp.size));
 		}
+
+		filesProps[requestKeys[r]] = tmp;
 	}
 
 	int maxFilesMatched = 0;
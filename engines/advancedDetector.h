@@ -405,6 +405,16 @@ public:
 
 	void dumpDetectionEntries() const override final;
 
+	/** A file whose properties are queried with @ref getFilesProperties. */
+	struct FilePropertiesRequest {
+		FilePropertiesRequest() : md5prop(kMD5Head), found(false) {}
+
+		MD5Properties md5prop;
+		Common::Path fname;
+		FileProperties fileProps; ///< The properties, filled in if the file was found.
+		bool found;
+	};
+
 protected:
 	/**
 	 * A hashmap of files and their MD5 checksums.
@@ -472,6 +482,13 @@ protected:
 	/** Get the properties (size and MD5) of this file. */
 	bool getFileProperties(const FileMap &allFiles, MD5Properties md5prop, const Common::Path &fname, FileProperties &fileProps) const;
 
+	/**
+	 * Get the properties of several files, like @ref getFileProperties does.
+	 *
+	 * The files that are not cached yet are read in parallel.
+	 */
+	void getFilesProperties(const FileMap &allFiles, Common::Array<FilePropertiesRequest> &requests) const;
+
 	/** Convert an AD game description into the shared game description format. */
 	virtual DetectedGame toDetectedGame(const ADDetectedGame &adGame, ADDetectedGameExtraInfo *extraInfo = nullptr) const;
 
@@ -572,6 +589,13 @@ protected:
 
 /**
  * Singleton Cache Storage for Computed MD5s and Open Archives
+ *
+ * The computed MD5s are also kept in an on-disk detection cache, stored
+ * next to the configuration file, so that detecting the same games again
+ * (e.g. with mass add) only needs to read the files which changed. Entries
+ * are keyed by the path of the file and only used while its size and
+ * modification time match the recorded ones. Entries which have not been
+ * used for kDiskCacheMaxAge days are dropped when the cache is written.
  */
 class AdvancedDetectorCacheManager : public Common::Singleton<AdvancedDetectorCacheManager> {
 public:
@@ -612,10 +636,31 @@ public:
 		return archiveHashMap.getValOrDefault(node.getPath(), nullptr);
 	}
 
-	AdvancedDetectorCacheManager() {
+	AdvancedDetectorCacheManager() : diskCacheLoaded(false), diskCacheDirty(false), diskCacheLastFlush(0) {
 		clear();
 	}
 
+	/**
+	 * Look up the properties of @p node computed for @p key in the on-disk
+	 * detection cache.
+	 *
+	 * @return False if there is no entry, or if the file has changed since.
+	 */
+	bool getDiskCachedProperties(const Common::FSNode &node, const Common::String &key, FileProperties &fileProps);
+
+	/**
+	 * Record the properties of @p node computed for @p key in the on-disk
+	 * detection cache.
+	 */
+	void setDiskCachedProperties(const Common::FSNode &node, const Common::String &key, const FileProperties &fileProps);
+
+	/**
+	 * Write the on-disk detection cache if it has changed. To avoid rewriting
+	 * it for every directory during a mass add, this only happens every
+	 * few seconds unless @p force is set.
+	 */
+	void flushDiskCache(bool force = false);
+
 	void clearArchives() {
 		for (auto &entry : archiveHashMap) {
 			delete entry._value;
@@ -632,12 +677,40 @@ public:
 private:
 	friend class Common::Singleton<AdvancedDetectorCacheManager>;
 
+	enum {
+		kDiskCacheVersion = 1,
+		kDiskCacheMaxAge = 90,           ///< In days
+		kDiskCacheFlushInterval = 10000  ///< In milliseconds
+	};
+
+	struct DiskCacheEntry {
+		DiskCacheEntry() : size(-1), modificationTime(0), lastUsed(0) {}
+
+		int64 size;
+		int64 modificationTime;
+		uint32 lastUsed;                 ///< In days, as returned by getDiskCacheDay()
+		Common::HashMap<Common::String, FileProperties> properties;
+	};
+
+	typedef Common::HashMap<Common::String, DiskCacheEntry> DiskCacheMap;
+
+	bool isDiskCacheEnabled() const;
+	Common::Path getDiskCachePath() const;
+	static uint32 getDiskCacheDay();
+	void loadDiskCache();
+	void saveDiskCache();
+
 	typedef Common::HashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileHashMap;
 	typedef Common::HashMap<Common::String, int64, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SizeHashMap;
 	typedef Common::HashMap<Common::Path, Common::Archive *, Common::Path::IgnoreCase_Hash, Common::Path::IgnoreCase_EqualTo> ArchiveHashMap;
 	FileHashMap md5HashMap;
 	SizeHashMap sizeHashMap;
 	ArchiveHashMap archiveHashMap;
+
+	DiskCacheMap diskCacheMap;
+	bool diskCacheLoaded;
+	bool diskCacheDirty;
+	uint32 diskCacheLastFlush;
 };
 
 /** Convenience shortcut for accessing the MD5CacheManager. */
@@ -69,6 +69,7 @@
 #include "ags/engine/script/script_runtime.h"
 #include "ags/events.h"
 #include "ags/globals.h"
+#include "common/profiler.h"
 
 namespace AGS3 {
 
@@ -774,6 +775,7 @@ void set_loop_counter(unsigned int new_counter) {
 }
 
 void UpdateGameOnce(bool checkControls, IDriverDependantBitmap *extraBitmap, int extraX, int extraY) {
+	PROFILE_ZONE("AGS::UpdateGameOnce");
 
 	int res;
 
@@ -460,88 +460,114 @@ int ccInstance::Run(int32_t curpc) {
 		if (_G(abort_engine))
 			return -1;
 
-		/*
-		if (!codeInst->ReadOperation(codeOp, pc))
-		{
-		    return -1;
-		}
-		*/
-		/* ReadOperation */
-		//=====================================================================
-		codeOp.Instruction.Code         = codeInst->code[pc];
-		codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-		codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-		if (codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS) {
-			cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
-			return -1;
-		}
+		const ScriptOperation *op = &codeOp;
+		PreparedCode *prepared = codeInst->prepared_code.get();
+		int32_t op_index = (prepared && pc >= 0 && pc < codeInst->codesize) ? prepared->OpIndex[pc] : -1;
+		if (op_index >= 0) {
+			// The operation was decoded when the script was loaded
+			PreparedOperation *prep = &prepared->Ops[op_index];
+			if (prep->ImportArgs && prepared->ImportsVersion != _GP(simp).GetVersion())
+				codeInst->ResolvePreparedImports();
+
+			if ((prep->StackArgs | prep->UnresolvedArgs) == 0) {
+				op = &prep->Op;
+			} else {
+				codeOp = prep->Op;
+				int pc_at = pc + 1;
+				for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at) {
+					if (prep->StackArgs & (1 << i)) {
+						codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
+					} else if (prep->UnresolvedArgs & (1 << i)) {
+						cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+						return -1;
+					}
+				}
+			}
+		} else {
+			/*
+			if (!codeInst->ReadOperation(codeOp, pc))
+			{
+			    return -1;
+			}
+			*/
+			/* ReadOperation */
+			//=====================================================================
+			codeOp.Instruction.Code         = codeInst->code[pc];
+			codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+			codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
+
+			if (codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS) {
+				cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
+				return -1;
+			}
 
-		codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
-		if (pc + codeOp.ArgCount >= codeInst->codesize) {
-			cc_error("unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
-			return -1;
-		}
+			codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
+			if (pc + codeOp.ArgCount >= codeInst->codesize) {
+				cc_error("unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
+				return -1;
+			}
 
-		int pc_at = pc + 1;
-		for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at) {
-			char fixup = codeInst->code_fixups[pc_at];
-			if (fixup > 0) {
-				// could be relative pointer or import address
-				/*
-				if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
-				{
-				    return -1;
-				}
-				*/
-				/* FixupArgument */
-				//=====================================================================
-				switch (fixup) {
-				case FIXUP_GLOBALDATA: {
-					ScriptVariable *gl_var = (ScriptVariable *)codeInst->code[pc_at];
-					codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
-				}
-				break;
-				case FIXUP_FUNCTION:
-					// originally commented -- CHECKME: could this be used in very old versions of AGS?
-					//      code[fixup] += (long)&code[0];
-					// This is a program counter value, presumably will be used as SCMD_CALL argument
-					codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
+			int pc_at = pc + 1;
+			for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at) {
+				char fixup = codeInst->code_fixups[pc_at];
+				if (fixup > 0) {
+					// could be relative pointer or import address
+					/*
+					if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
+					{
+					    return -1;
+					}
+					*/
+					/* FixupArgument */
+					//=====================================================================
+					switch (fixup) {
+					case FIXUP_GLOBALDATA: {
+						ScriptVariable *gl_var = (ScriptVariable *)codeInst->code[pc_at];
+						codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
+					}
 					break;
-				case FIXUP_STRING:
-					codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
+					case FIXUP_FUNCTION:
+						// originally commented -- CHECKME: could this be used in very old versions of AGS?
+						//      code[fixup] += (long)&code[0];
+						// This is a program counter value, presumably will be used as SCMD_CALL argument
+						codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
+						break;
+					case FIXUP_STRING:
+						codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
+						break;
+					case FIXUP_IMPORT: {
+						const ScriptImport *import = _GP(simp).getByIndex(static_cast<uint32_t>(codeInst->code[pc_at]));
+						if (import) {
+							codeOp.Args[i] = import->Value;
+						} else {
+							cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+							return -1;
+						}
+					}
 					break;
-				case FIXUP_IMPORT: {
-					const ScriptImport *import = _GP(simp).getByIndex(static_cast<uint32_t>(codeInst->code[pc_at]));
-					if (import) {
-						codeOp.Args[i] = import->Value;
-					} else {
-						cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+					case FIXUP_STACK:
+						codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
+						break;
+					default:
+						cc_error("internal fixup type error: %d", fixup);
 						return -1;
 					}
+					/* End FixupArgument */
+					//=====================================================================
+				} else {
+					// should be a numeric literal (int32 or float)
+					codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
 				}
-				break;
-				case FIXUP_STACK:
-					codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
-					break;
-				default:
-					cc_error("internal fixup type error: %d", fixup);
-					return -1;
-				}
-				/* End FixupArgument */
-				//=====================================================================
-			} else {
-				// should be a numeric literal (int32 or float)
-				codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
 			}
+			/* End ReadOperation */
+			//=====================================================================
 		}
-		/* End ReadOperation */
-		//=====================================================================
 
 		// save the arguments for quick access
-		RuntimeScriptValue &arg1 = codeOp.Args[0];
-		RuntimeScriptValue &arg2 = codeOp.Args[1];
-		RuntimeScriptValue &arg3 = codeOp.Args[2];
+		const int32_t arg_count = op->ArgCount;
+		const RuntimeScriptValue &arg1 = op->Args[0];
+		const RuntimeScriptValue &arg2 = op->Args[1];
+		const RuntimeScriptValue &arg3 = op->Args[2];
 		RuntimeScriptValue &reg1 =
 		    registers[arg1.IValue >= 0 && arg1.IValue < CC_NUM_REGISTERS ? arg1.IValue : 0];
 		RuntimeScriptValue &reg2 =
@@ -551,10 +577,10 @@ int ccInstance::Run(int32_t curpc) {
 		const char *direct_ptr2;
 
 		if (write_debug_dump) {
-			DumpInstruction(codeOp);
+			DumpInstruction(*op);
 		}
 
-		switch (codeOp.Instruction.Code) {
+		switch (op->Instruction.Code) {
 		case SCMD_LINENUM:
 			line_number = arg1.IValue;
 			_G(currentline) = arg1.IValue;
@@ -732,7 +758,7 @@ int ccInstance::Run(int32_t curpc) {
 			PUSH_CALL_STACK;
 
 			ASSERT_STACK_SPACE_AVAILABLE(1);
-			PushValueToStack(RuntimeScriptValue().SetInt32(pc + codeOp.ArgCount + 1));
+			PushValueToStack(RuntimeScriptValue().SetInt32(pc + arg_count + 1));
 
 			if (thisbase[curnest] == 0)
 				pc = reg1.IValue;
@@ -975,7 +1001,7 @@ int ccInstance::Run(int32_t curpc) {
 			ccInstance *wasRunning = runningInst;
 
 			// extract the instance ID
-			int32_t instId = codeOp.Instruction.InstanceId;
+			int32_t instId = op->Instruction.InstanceId;
 			// determine the offset into the code of the instance we want
 			runningInst = _G(loadedInstances)[instId];
 			intptr_t callAddr = reg1.Ptr - (char *)&runningInst->code[0];
@@ -1234,11 +1260,11 @@ int ccInstance::Run(int32_t curpc) {
 				loopIterationCheckDisabled++;
 			break;
 		default:
-			cc_error("instruction %d is not implemented", codeOp.Instruction.Code);
+			cc_error("instruction %d is not implemented", op->Instruction.Code);
 			return -1;
 		}
 
-		pc += codeOp.ArgCount + 1;
+		pc += arg_count + 1;
 	}
 	return 0;
 }
@@ -1427,6 +1453,7 @@ bool ccInstance::_Create(PScript scri, ccInstance *joined) {
 	if (joined) {
 		resolved_imports = joined->resolved_imports;
 		code_fixups = joined->code_fixups;
+		prepared_code = joined->prepared_code;
 	} else {
 		if (!CreateGlobalVars(scri.get())) {
 			return false;
@@ -1512,6 +1539,7 @@ void ccInstance::Free() {
 	}
 	resolved_imports = nullptr;
 	code_fixups = nullptr;
+	prepared_code.reset();
 }
 
 bool ccInstance::ResolveScriptImports(const ccScript *scri) {
@@ -1717,9 +1745,100 @@ bool ccInstance::ResolveImportFixups(const ccScript *scri) {
 		if (import->InstancePtr != nullptr && (code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT)
 			code[fixup + 1] = SCMD_CALLAS | (import->InstancePtr->loadedInstanceId << INSTANCE_ID_SHIFT);
 	}
+
+	PrepareCode();
 	return true;
 }
 
+void ccInstance::PrepareCode() {
+	std::shared_ptr<PreparedCode> prepared(new PreparedCode());
+	prepared->OpIndex.resize(codesize, -1);
+
+	// The operations follow each other in the code stream; if something
+	// cannot be decoded, the rest is decoded when run, which reports the error
+	int32_t at_pc = 0;
+	while (at_pc < codesize) {
+		PreparedOperation prep;
+		ScriptOperation &op = prep.Op;
+		op.Instruction.Code       = code[at_pc];
+		op.Instruction.InstanceId = (op.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+		op.Instruction.Code      &= INSTANCE_ID_REMOVEMASK;
+		if (op.Instruction.Code < 0 || op.Instruction.Code >= CC_NUM_SCCMDS)
+			break;
+
+		op.ArgCount = (*g_commands)[op.Instruction.Code].ArgCount;
+		if (at_pc + op.ArgCount >= codesize)
+			break;
+
+		bool decoded = true;
+		for (int i = 0; i < op.ArgCount && decoded; ++i) {
+			int32_t pc_at = at_pc + 1 + i;
+			char fixup = code_fixups[pc_at];
+			if (fixup <= 0) {
+				// should be a numeric literal (int32 or float)
+				op.Args[i].SetInt32((int32_t)code[pc_at]);
+				continue;
+			}
+
+			switch (fixup) {
+			case FIXUP_GLOBALDATA: {
+				ScriptVariable *gl_var = (ScriptVariable *)code[pc_at];
+				op.Args[i].SetGlobalVar(&gl_var->RValue);
+			}
+			break;
+			case FIXUP_STRING:
+				op.Args[i].SetStringLiteral(&strings[0] + code[pc_at]);
+				break;
+			case FIXUP_IMPORT:
+				prep.ImportArgs |= 1 << i;
+				break;
+			case FIXUP_STACK:
+				prep.StackArgs |= 1 << i;
+				break;
+			case FIXUP_FUNCTION:
+				op.Args[i].SetInt32((int32_t)code[pc_at]);
+				break;
+			default:
+				decoded = false;
+				break;
+			}
+		}
+		if (!decoded)
+			break;
+
+		prepared->OpIndex[at_pc] = prepared->Ops.size();
+		prepared->Ops.push_back(prep);
+		at_pc += op.ArgCount + 1;
+	}
+
+	prepared_code = prepared;
+	ResolvePreparedImports();
+}
+
+void ccInstance::ResolvePreparedImports() {
+	PreparedCode &prepared = *prepared_code;
+	for (int32_t at_pc = 0; at_pc < codesize; ++at_pc) {
+		if (prepared.OpIndex[at_pc] < 0)
+			continue;
+
+		PreparedOperation &prep = prepared.Ops[prepared.OpIndex[at_pc]];
+		for (int i = 0; i < prep.Op.ArgCount; ++i) {
+			if ((prep.ImportArgs & (1 << i)) == 0)
+				continue;
+
+			const ScriptImport *import = _GP(simp).getByIndex(static_cast<uint32_t>(code[at_pc + 1 + i]));
+			if (import) {
+				prep.Op.Args[i] = import->Value;
+				prep.UnresolvedArgs &= ~(1 << i);
+			} else {
+				prep.Op.Args[i].Invalidate();
+				prep.UnresolvedArgs |= 1 << i;
+			}
+		}
+	}
+	prepared.ImportsVersion = _GP(simp).GetVersion();
+}
+
 /*
 bool ccInstance::ReadOperation(ScriptOperation &op, int32_t at_pc)
 {
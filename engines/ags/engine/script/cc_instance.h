@@ -24,6 +24,7 @@
 
 #include "ags/lib/std/memory.h"
 #include "ags/lib/std/map.h"
+#include "ags/lib/std/vector.h"
 #include "ags/engine/ac/timer.h"
 #include "ags/shared/script/cc_internal.h"
 #include "ags/shared/script/cc_script.h"  // ccScript
@@ -69,6 +70,35 @@ struct ScriptOperation {
 	int                 ArgCount;
 };
 
+// An operation decoded when the script is loaded, with the arguments that
+// do not depend on the execution state already fixed up
+struct PreparedOperation {
+	PreparedOperation() {
+		StackArgs = 0;
+		ImportArgs = 0;
+		UnresolvedArgs = 0;
+	}
+
+	ScriptOperation     Op;
+	uint8_t             StackArgs;      // arguments with FIXUP_STACK, fixed up when run
+	uint8_t             ImportArgs;     // arguments with FIXUP_IMPORT
+	uint8_t             UnresolvedArgs; // imports that could not be resolved, reported when run
+};
+
+// The byte-code of a script in the decoded form, shared by its forks
+struct PreparedCode {
+	PreparedCode() {
+		ImportsVersion = 0;
+	}
+
+	std::vector<PreparedOperation> Ops;
+	// Index in Ops of the operation at each code position, or -1 if there
+	// is none, in which case the operation is decoded when run
+	std::vector<int32_t> OpIndex;
+	// Version of the system imports that the import arguments come from
+	uint32_t ImportsVersion;
+};
+
 struct ScriptVariable {
 	ScriptVariable() {
 		ScAddress = -1; // address = 0 is valid one, -1 means undefined
@@ -140,6 +170,9 @@ public:
 
 	char *code_fixups;
 
+	// byte-code decoded ahead of time, if it was prepared
+	std::shared_ptr<PreparedCode> prepared_code;
+
 	// returns the currently executing instance, or NULL if none
 	static ccInstance *GetCurrentInstance(void);
 	// create a runnable instance of the supplied script
@@ -178,6 +211,7 @@ public:
 
 	// Using resolved_imports[], resolve the IMPORT fixups
 	// Also change CALLEXT op-codes to CALLAS when they pertain to a script instance 
+	// Then prepare the byte-code for running
 	bool    ResolveImportFixups(const ccScript *scri);
 
 private:
@@ -189,6 +223,11 @@ private:
 	bool    AddGlobalVar(const ScriptVariable &glvar);
 	ScriptVariable *FindGlobalVar(int32_t var_addr);
 	bool    CreateRuntimeCodeFixups(const ccScript *scri);
+	// Decode the byte-code once, resolving all the fixups that can be resolved
+	// before running it
+	void    PrepareCode();
+	// Get the import arguments of the prepared code from the current system imports
+	void    ResolvePreparedImports();
 	//bool    ReadOperation(ScriptOperation &op, int32_t at_pc);
 
 	// Begin executing script starting from the given bytecode index
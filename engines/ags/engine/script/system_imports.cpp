@@ -25,6 +25,7 @@ namespace AGS3 {
 
 uint32_t SystemImports::add(const String &name, const RuntimeScriptValue &value, ccInstance *anotherscr) {
 	uint32_t ixof = get_index_of(name);
+	version++;
 	// Check if symbol already exists
 	if (ixof != UINT32_MAX) {
 		// Only allow override if not a script-exported function
@@ -56,6 +57,7 @@ void SystemImports::remove(const String &name) {
 	uint32_t idx = get_index_of(name);
 	if (idx == UINT32_MAX)
 		return;
+	version++;
 	btree.erase(imports[idx].Name);
 	imports[idx].Name = nullptr;
 	imports[idx].Value.Invalidate();
@@ -119,6 +121,7 @@ void SystemImports::RemoveScriptExports(ccInstance *inst) {
 			continue;
 
 		if (import.InstancePtr == inst) {
+			version++;
 			btree.erase(import.Name);
 			import.Name = nullptr;
 			import.Value.Invalidate();
@@ -130,6 +133,7 @@ void SystemImports::RemoveScriptExports(ccInstance *inst) {
 void SystemImports::clear() {
 	btree.clear();
 	imports.clear();
+	version++;
 }
 
 } // namespace AGS3
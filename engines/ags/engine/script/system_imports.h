@@ -50,8 +50,12 @@ private:
 
 	std::vector<ScriptImport> imports;
 	IndexMap btree;
+	// Changed every time an import is added, changed or removed
+	uint32_t version;
 
 public:
+	SystemImports() : version(0) {}
+
 	uint32_t add(const String &name, const RuntimeScriptValue &value, ccInstance *inst);
 	void remove(const String &name);
 	const ScriptImport *getByName(const String &name);
@@ -60,6 +64,7 @@ public:
 	String findName(const RuntimeScriptValue &value);
 	void RemoveScriptExports(ccInstance *inst);
 	void clear();
+	uint32_t GetVersion() const { return version; }
 };
 
 } // namespace AGS3
@@ -0,0 +1,138 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/debug.h"
+#include "common/str.h"
+#include "ags/shared/core/platform.h"
+#include "ags/shared/script/cc_internal.h"
+#include "ags/shared/script/cc_script.h"
+#include "ags/engine/script/cc_instance.h"
+#include "ags/engine/script/script_runtime.h"
+#include "ags/lib/std/chrono.h"
+
+namespace AGS3 {
+
+static RuntimeScriptValue Test_ScriptDouble(const RuntimeScriptValue *params, int32_t param_count) {
+	return RuntimeScriptValue().SetInt32(params[0].IValue * 2);
+}
+
+static RuntimeScriptValue Test_ScriptTriple(const RuntimeScriptValue *params, int32_t param_count) {
+	return RuntimeScriptValue().SetInt32(params[0].IValue * 3);
+}
+
+// Creates a script which returns the sum of Test_ScriptDouble(i) for i
+// from 1 to the given count, calling the imported function in a loop
+static PScript Test_CreateScript(int32_t count) {
+	const int32_t code[] = {
+		SCMD_LITTOREG, SREG_CX, count,  // 0
+		SCMD_LITTOREG, SREG_DX, 0,      // 3
+		SCMD_PUSHREAL, SREG_CX,         // 6
+		SCMD_LITTOREG, SREG_BX, 0,      // 8, import 0
+		SCMD_CALLEXT, SREG_BX,          // 11
+		SCMD_SUBREALSTACK, 1,           // 13
+		SCMD_ADDREG, SREG_DX, SREG_AX,  // 15
+		SCMD_SUB, SREG_CX, 1,           // 18
+		SCMD_REGTOREG, SREG_CX, SREG_AX, // 21
+		SCMD_JNZ, -20,                  // 24, back to 6
+		SCMD_REGTOREG, SREG_DX, SREG_AX, // 26
+		SCMD_RET                        // 29
+	};
+
+	ccScript *scri = new ccScript();
+	scri->codesize = ARRAYSIZE(code);
+	scri->code = (int32_t *)malloc(sizeof(code));
+	memcpy(scri->code, code, sizeof(code));
+
+	scri->numfixups = 1;
+	scri->fixuptypes = (char *)malloc(1);
+	scri->fixuptypes[0] = FIXUP_IMPORT;
+	scri->fixups = (int32_t *)malloc(sizeof(int32_t));
+	scri->fixups[0] = 10;
+
+	scri->numimports = 1;
+	scri->imports = (char **)malloc(sizeof(char *));
+	scri->imports[0] = scumm_strdup("Test_ScriptDouble");
+
+	scri->numexports = 1;
+	scri->exports = (char **)malloc(sizeof(char *));
+	scri->exports[0] = scumm_strdup("Test_ScriptSum");
+	scri->export_addr = (int32_t *)malloc(sizeof(int32_t));
+	scri->export_addr[0] = EXPORT_FUNCTION << 24;
+
+	return PScript(scri);
+}
+
+static int Test_RunScript(ccInstance *inst, int runs) {
+	for (int i = 0; i < runs; i++) {
+		if (inst->CallScriptFunction("Test_ScriptSum", 0, nullptr) != 0)
+			return -1;
+	}
+	return inst->returnValue;
+}
+
+void Test_Script() {
+	const int32_t count = 1000;
+	const int runs = 1000;
+
+	ccAddExternalStaticFunction("Test_ScriptDouble", Test_ScriptDouble);
+
+	PScript scri = Test_CreateScript(count);
+	ccInstance *inst = ccInstance::CreateFromScript(scri);
+	assert(inst);
+	bool resolved = inst->ResolveScriptImports(scri.get()) && inst->ResolveImportFixups(scri.get());
+	assert(resolved);
+	assert(inst->prepared_code);
+
+	// The prepared code must give the same result as decoding it when run
+	uint32 start = std::chrono::high_resolution_clock::now();
+	int result = Test_RunScript(inst, runs);
+	uint32 preparedTime = std::chrono::high_resolution_clock::now() - start;
+	assert(result == count * (count + 1));
+
+	std::shared_ptr<PreparedCode> prepared = inst->prepared_code;
+	inst->prepared_code.reset();
+	start = std::chrono::high_resolution_clock::now();
+	result = Test_RunScript(inst, runs);
+	uint32 decodedTime = std::chrono::high_resolution_clock::now() - start;
+	assert(result == count * (count + 1));
+	inst->prepared_code = prepared;
+
+	// The forks must share the prepared code
+	ccInstance *fork = inst->Fork();
+	assert(fork);
+	assert(fork->prepared_code == inst->prepared_code);
+	assert(Test_RunScript(fork, 1) == count * (count + 1));
+
+	// Changing the imports must be picked up by the prepared code
+	ccAddExternalStaticFunction("Test_ScriptDouble", Test_ScriptTriple);
+	assert(Test_RunScript(inst, 1) == count * (count + 1) / 2 * 3);
+	assert(Test_RunScript(fork, 1) == count * (count + 1) / 2 * 3);
+
+	debug("Script throughput: %d calls of %d loop iterations, prepared code %u ms, decoded when run %u ms",
+		runs, count, preparedTime, decodedTime);
+
+	delete fork;
+	delete inst;
+	ccRemoveExternalSymbol("Test_ScriptDouble");
+}
+
+} // namespace AGS3
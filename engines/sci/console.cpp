@@ -33,6 +33,7 @@
 #include "sci/engine/selector.h"
 #include "sci/engine/savegame.h"
 #include "sci/engine/gc.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/features.h"
 #include "sci/engine/scriptdebug.h"
 #include "sci/sound/midiparser_sci.h"
@@ -163,6 +164,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -244,6 +246,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("vm_vars",			WRAP_METHOD(Console, cmdVMVars));
 	registerCmd("vmvars",				WRAP_METHOD(Console, cmdVMVars));					// alias
 	registerCmd("vv",					WRAP_METHOD(Console, cmdVMVars));					// alias
+	registerCmd("send_cache",			WRAP_METHOD(Console, cmdSendCache));
+	registerCmd("avoidpath_bench",	WRAP_METHOD(Console, cmdAvoidPathBench));
 	registerCmd("locals",				WRAP_METHOD(Console, cmdLocalVars));
 	registerCmd("l",					WRAP_METHOD(Console, cmdLocalVars));				// alias
 	registerCmd("stack",				WRAP_METHOD(Console, cmdStack));
@@ -398,6 +402,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows how long the garbage collections took\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -452,6 +457,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" script_said - Shows all said - strings inside a specified script\n");
 	debugPrintf(" vm_varlist / vmvarlist / vl - Shows the addresses of variables in the VM\n");
 	debugPrintf(" vm_vars / vmvars / vv - Displays or changes variables in the VM\n");
+	debugPrintf(" send_cache - Shows the hit rate of the selector lookup cache of the VM\n");
+	debugPrintf(" avoidpath_bench - Records kAvoidPath calls and times them with and without the visibility graph cache\n");
 	debugPrintf(" locals / l - Displays or changes local variables in the VM\n");
 	debugPrintf(" stack / st - Lists the specified number of stack elements\n");
 	debugPrintf(" value_type - Determines the type of a value\n");
@@ -2938,6 +2945,34 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GCStats &stats = _engine->_gamestate->_gcStats;
+
+	if (argc > 2 || (argc == 2 && scumm_stricmp(argv[1], "reset"))) {
+		debugPrintf("Shows how long the garbage collections took.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		debugPrintf("Pass \"reset\" to start counting again.\n");
+		return true;
+	}
+
+	if (argc == 2) {
+		stats.reset();
+		debugPrintf("Reset the garbage collection statistics\n");
+		return true;
+	}
+
+	debugPrintf("Collections: %u, runs every %d kernel calls\n", stats.collections, _engine->_gamestate->scriptGCInterval);
+	if (!stats.collections)
+		return true;
+
+	debugPrintf("Pauses: last %.3f ms, max %.3f ms, average %.3f ms\n", stats.lastPause / 1000.0, stats.maxPause / 1000.0,
+		stats.totalPause / 1000.0 / stats.collections);
+	debugPrintf("Last collection: %u referenced addresses, %u freed\n", stats.lastMarked, stats.lastFreed);
+	debugPrintf("Freed in total: %u\n", stats.totalFreed);
+
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
@@ -3051,6 +3086,101 @@ bool Console::cmdVMVars(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSendCache(int argc, const char **argv) {
+	SendCache &cache = _engine->_gamestate->_sendCache;
+
+	if (argc > 2 || (argc == 2 && scumm_stricmp(argv[1], "reset"))) {
+		debugPrintf("Shows how often the selector lookups of the sends are served from the cache.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		debugPrintf("Pass \"reset\" to start counting again.\n");
+		return true;
+	}
+
+	if (argc == 2) {
+		cache.resetStats();
+		debugPrintf("Reset the send cache statistics\n");
+		return true;
+	}
+
+	const SendCache::Stats &stats = cache.getStats();
+	const uint32 lookups = stats.hits + stats.misses;
+	debugPrintf("Lookups: %u, hits: %u (%.1f%%), misses: %u\n", lookups, stats.hits,
+		lookups ? stats.hits * 100.0 / lookups : 0.0, stats.misses);
+	debugPrintf("Flushes after scripts were loaded or unloaded: %u\n", stats.flushes);
+	debugPrintf("Call sites evicted by other call sites: %u\n", stats.conflicts);
+
+	uint monomorphic, polymorphic, megamorphic;
+	cache.countCallSites(monomorphic, polymorphic, megamorphic);
+	debugPrintf("Cached call sites: %u monomorphic, %u polymorphic, %u megamorphic\n",
+		monomorphic, polymorphic, megamorphic);
+
+	return true;
+}
+
+bool Console::cmdAvoidPathBench(int argc, const char **argv) {
+	AvoidPathCache &cache = *_engine->_gamestate->_avoidPathCache;
+
+	if (argc != 2) {
+		debugPrintf("Records the pathfinding calls of kAvoidPath, and replays them with and\n");
+		debugPrintf("without the visibility graph cache.\n");
+		debugPrintf("Usage: %s <record|stop|replay|clear>\n", argv[0]);
+		debugPrintf("Recorded calls: %u%s, cache hits: %u, misses: %u\n", cache.recordedCalls.size(),
+			cache.recording ? " (recording)" : "", cache.hits, cache.misses);
+		return true;
+	}
+
+	if (!scumm_stricmp(argv[1], "record")) {
+		cache.recording = true;
+		debugPrintf("Recording up to %d kAvoidPath calls\n", AvoidPathCache::kMaxRecordedCalls);
+	} else if (!scumm_stricmp(argv[1], "stop")) {
+		cache.recording = false;
+		debugPrintf("Recorded %u kAvoidPath calls\n", cache.recordedCalls.size());
+	} else if (!scumm_stricmp(argv[1], "clear")) {
+		cache.recordedCalls.clear();
+		debugPrintf("Cleared the recorded kAvoidPath calls\n");
+	} else if (!scumm_stricmp(argv[1], "replay")) {
+		if (cache.recordedCalls.empty()) {
+			debugPrintf("No kAvoidPath calls have been recorded\n");
+			return true;
+		}
+
+		const bool recording = cache.recording;
+		const uint32 hits = cache.hits;
+		const uint32 misses = cache.misses;
+		Common::Array<Common::Array<Common::Point> > uncachedPaths, cachedPaths;
+
+		cache.recording = false;
+		cache.enabled = false;
+		uint32 startTime = g_system->getMillis();
+		replayAvoidPathCalls(_engine->_gamestate, uncachedPaths);
+		const uint32 uncachedTime = g_system->getMillis() - startTime;
+
+		cache.enabled = true;
+		cache.graphs.clear();
+		startTime = g_system->getMillis();
+		replayAvoidPathCalls(_engine->_gamestate, cachedPaths);
+		const uint32 cachedTime = g_system->getMillis() - startTime;
+
+		uint differences = 0;
+		for (uint i = 0; i < cachedPaths.size(); i++) {
+			if (cachedPaths[i] != uncachedPaths[i])
+				differences++;
+		}
+
+		debugPrintf("Replayed %u kAvoidPath calls\n", cachedPaths.size());
+		debugPrintf("Without the cache: %u ms, with the cache: %u ms\n", uncachedTime, cachedTime);
+		debugPrintf("Cache hits: %u, misses: %u\n", cache.hits - hits, cache.misses - misses);
+		if (differences)
+			debugPrintf("%u paths differ!\n", differences);
+
+		cache.recording = recording;
+	} else {
+		debugPrintf("Unknown command: %s\n", argv[1]);
+	}
+
+	return true;
+}
+
 bool Console::cmdLocalVars(int argc, const char **argv) {
 	if (!(2 <= argc && argc <= 4)) {
 		debugPrintf("Displays or changes local variables in the VM\n");
@@ -21,6 +21,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/profiler.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -55,10 +56,11 @@ void WorklistManager::push(reg_t reg) {
 
 	debugC(kDebugLevelGC, "[GC] Adding %04x:%04x", PRINT_REG(reg));
 
-	if (_map.contains(reg))
+	bool &known = _map.getOrCreateVal(reg);
+	if (known)
 		return; // already dealt with it
 
-	_map.setVal(reg, true);
+	known = true;
 	_worklist.push_back(reg);
 }
 
@@ -98,11 +100,9 @@ static void processWorkList(SegManager *segMan, WorklistManager &wm, const Commo
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+static void markActiveReferences(EngineState *s, WorklistManager &wm) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -174,6 +174,11 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 	if (g_sci->_gfxPorts)
 		g_sci->_gfxPorts->processEngineHunkList(wm);
+}
+
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+	markActiveReferences(s, wm);
 
 	return normalizeAddresses(s->_segMan, wm._map);
 }
@@ -190,12 +195,32 @@ void run_gc(EngineState *s) {
 	memset(segcount, 0, sizeof(segcount));
 #endif
 
+	const uint64 startTime = Common::Profiler::getMicros();
+	uint32 freed = 0;
+
 	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
+	WorklistManager wm;
+	markActiveReferences(s, wm);
+	const AddrSet &activeRefs = wm._map;
+
+	// Almost all references already are canonical addresses, like the ones of
+	// clones, lists, nodes and arrays. Instead of copying all of them into a
+	// normalized set like findAllActiveReferences() does, only collect the
+	// canonical addresses of the others, which point into scripts and locals.
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+	AddrSet canonicRefs;
+	for (AddrSet::const_iterator i = activeRefs.begin(); i != activeRefs.end(); ++i) {
+		const reg_t reg = i->_key;
+		const SegmentObj *mobj = segMan->getSegmentObj(reg.getSegment());
+		if (mobj) {
+			const reg_t canonic = mobj->findCanonicAddress(segMan, reg);
+			if (canonic != reg)
+				canonicRefs.setVal(canonic, true);
+		}
+	}
 
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
-	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
 	for (uint seg = 1; seg < heap.size(); seg++) {
 		SegmentObj *mobj = heap[seg];
 
@@ -210,9 +235,10 @@ void run_gc(EngineState *s) {
 			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
 			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
 				const reg_t addr = *it;
-				if (!activeRefs->contains(addr)) {
+				if (!activeRefs.contains(addr) && !canonicRefs.contains(addr)) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
+					freed++;
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
@@ -223,7 +249,15 @@ void run_gc(EngineState *s) {
 		}
 	}
 
-	delete activeRefs;
+	const uint32 pause = Common::Profiler::getMicros() - startTime;
+	GCStats &stats = s->_gcStats;
+	stats.collections++;
+	stats.lastPause = pause;
+	stats.maxPause = MAX(stats.maxPause, pause);
+	stats.totalPause += pause;
+	stats.lastMarked = activeRefs.size();
+	stats.lastFreed = freed;
+	stats.totalFreed += freed;
 
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
@@ -23,6 +23,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/graphics/paint16.h"
 #include "sci/graphics/palette.h"
 #include "sci/graphics/screen.h"
@@ -116,10 +117,14 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Position in the vertex index
+	int index;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = nullptr;
+		index = -1;
 	}
 };
 
@@ -262,6 +267,12 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Cached visibility graph of the polygons, or NULL. Its vertices come
+	// after the first _graphOffset ones in the vertex index, which are the
+	// start and end points if they were added as single-vertex polygons.
+	AvoidPathGraph *_graph;
+	int _graphOffset;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = nullptr;
 		vertex_end = nullptr;
@@ -269,6 +280,8 @@ struct PathfindingState {
 		_prependPoint = nullptr;
 		_appendPoint = nullptr;
 		vertices = 0;
+		_graph = nullptr;
+		_graphOffset = 0;
 	}
 
 	~PathfindingState() {
@@ -698,6 +711,39 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Determines whether a vertex is visible from another one.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex to look from
+ * @param vertex		the vertex to look at
+ * @return true if vertex is visible from vertex_cur, false otherwise
+ */
+static bool vertex_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
  * @param s				the pathfinding state
@@ -706,34 +752,31 @@ static int inside(const Common::Point &p, Vertex *vertex) {
  */
 static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	VertexList *visVerts = new VertexList();
+	const int graphIndex = vertex_cur->index - s->_graphOffset;
 
-	for (int i = 0; i < s->vertices; i++) {
-		Vertex *vertex = s->vertex_index[i];
-
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
-
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
+	if (!s->_graph || graphIndex < 0) {
+		for (int i = 0; i < s->vertices; i++) {
+			Vertex *vertex = s->vertex_index[i];
+			if (vertex_visible(s, vertex_cur, vertex))
+				visVerts->push_front(vertex);
+		}
 
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
+		return visVerts;
+	}
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
-		}
+	// The start and end points have no edges, so they do not change which
+	// vertices of the graph see each other. Only their own visibility has
+	// to be checked on every call.
+	Common::Array<bool> &visibility = s->_graph->visibility[graphIndex];
+	if (visibility.empty()) {
+		visibility.resize(s->vertices - s->_graphOffset);
+		for (int i = s->_graphOffset; i < s->vertices; i++)
+			visibility[i - s->_graphOffset] = vertex_visible(s, vertex_cur, s->vertex_index[i]);
+	}
 
-		if (j == s->vertices)
+	for (int i = 0; i < s->vertices; i++) {
+		Vertex *vertex = s->vertex_index[i];
+		if (i < s->_graphOffset ? vertex_visible(s, vertex_cur, vertex) : visibility[i - s->_graphOffset])
 			visVerts->push_front(vertex);
 	}
 
@@ -1236,40 +1279,101 @@ static void change_polygons_opt_0(PathfindingState *s) {
 }
 
 /**
- * Converts the SCI input data for pathfinding
- * Parameters: (EngineState *) s: The game state
- *             (reg_t) poly_list: Polygon list
- *             (Common::Point) start: The start point
- *             (Common::Point) end: The end point
- *             (int) opt: Optimization level (0, 1 or 2)
- * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
- *                            NULL otherwise
+ * Stores the vertices of a polygon list, in the order of their circular lists
+ * Parameters: (const PolygonList &) polygons: The polygons to store
+ *             (AvoidPathPolygons &) set: The polygon set to store them in
  */
-static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
-	SegManager *segMan = s->_segMan;
-	Polygon *polygon;
-	int count = 0;
-	PathfindingState *pf_s = new PathfindingState(width, height);
+static void store_polygon_set(const PolygonList &polygons, AvoidPathPolygons &set) {
+	for (PolygonList::const_iterator it = polygons.begin(); it != polygons.end(); ++it) {
+		Polygon *polygon = *it;
+		Vertex *vertex;
+		uint16 size = 0;
 
-	// Convert all polygons
-	if (poly_list.getSegment()) {
-		List *list = s->_segMan->lookupList(poly_list);
-		Node *node = s->_segMan->lookupNode(list->first);
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			set.points.push_back(vertex->v);
+			size++;
+		}
 
-		while (node) {
-			// The node value might be null, in which case there's no polygon to parse.
-			// Happens in LB2 floppy - refer to bug #5195
-			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : nullptr;
+		set.sizes.push_back(size);
+		set.types.push_back(polygon->type);
+	}
+}
 
-			if (polygon) {
-				pf_s->polygons.push_back(polygon);
-				count += readSelectorValue(segMan, node->value, SELECTOR(size));
-			}
+/**
+ * Rebuilds the polygons of a stored polygon set
+ * Parameters: (const AvoidPathPolygons &) set: The stored polygon set
+ *             (PolygonList &) polygons: The list to append the polygons to
+ */
+static void restore_polygon_set(const AvoidPathPolygons &set, PolygonList &polygons) {
+	uint point = 0;
 
-			node = s->_segMan->lookupNode(node->succ);
+	for (uint i = 0; i < set.sizes.size(); i++) {
+		Polygon *polygon = new Polygon(set.types[i]);
+
+		for (uint j = 0; j < set.sizes[i]; j++)
+			polygon->vertices.insertAtEnd(new Vertex(set.points[point++]));
+
+		polygons.push_back(polygon);
+	}
+}
+
+/**
+ * Finds the cached visibility graph of a polygon set, or replaces the least
+ * recently used one with an empty graph for it
+ * Parameters: (AvoidPathCache *) cache: The cache
+ *             (PolygonList &) polygons: The polygons
+ * Returns   : (AvoidPathGraph *) The graph of the polygons
+ */
+static AvoidPathGraph *lookup_graph(AvoidPathCache *cache, const PolygonList &polygons) {
+	AvoidPathPolygons set;
+	store_polygon_set(polygons, set);
+
+	cache->useCounter++;
+
+	for (uint i = 0; i < cache->graphs.size(); i++) {
+		if (cache->graphs[i].polygons == set) {
+			cache->hits++;
+			cache->graphs[i].lastUse = cache->useCounter;
+			return &cache->graphs[i];
+		}
+	}
+
+	cache->misses++;
+
+	AvoidPathGraph *graph;
+	if (cache->graphs.size() < AvoidPathCache::kMaxGraphs) {
+		cache->graphs.push_back(AvoidPathGraph());
+		graph = &cache->graphs.back();
+	} else {
+		graph = &cache->graphs[0];
+		for (uint i = 1; i < cache->graphs.size(); i++) {
+			if (cache->graphs[i].lastUse < graph->lastUse)
+				graph = &cache->graphs[i];
 		}
 	}
 
+	graph->visibility.clear();
+	graph->visibility.resize(set.points.size());
+	graph->polygons = set;
+	graph->lastUse = cache->useCounter;
+	return graph;
+}
+
+/**
+ * Sets up the pathfinding state once its polygons have been converted
+ * Parameters: (EngineState *) s: The game state
+ *             (PathfindingState *) pf_s: The pathfinding state
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ *             (AvoidPathCache *) cache: The visibility graph cache
+ * Returns   : (PathfindingState *) On success the pathfinding state,
+ *                            NULL otherwise, in which case it is deleted
+ */
+static PathfindingState *prepare_polygon_set(EngineState *s, PathfindingState *pf_s, Common::Point start, Common::Point end, int opt, AvoidPathCache *cache) {
+	Polygon *polygon;
+	int count = 0;
+
 	if (opt == 0)
 		change_polygons_opt_0(pf_s);
 
@@ -1326,6 +1430,12 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	AvoidPathGraph *graph = nullptr;
+	int graphPolygons = pf_s->polygons.size();
+
+	if (cache && cache->enabled)
+		graph = lookup_graph(cache, pf_s->polygons);
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1334,7 +1444,10 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	delete new_end;
 
 	// Allocate and build vertex index
-	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * (count + 2));
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it)
+		count += (*it)->vertices.size();
+
+	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * count);
 
 	count = 0;
 
@@ -1343,15 +1456,75 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		Vertex *vertex;
 
 		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->index = count;
 			pf_s->vertex_index[count++] = vertex;
 		}
 	}
 
 	pf_s->vertices = count;
 
+	// The graph can only be used if the start and end points were added as
+	// single-vertex polygons, which are put in front of the others. If one
+	// of them split an edge instead, the visibility of the other vertices
+	// may have changed.
+	if (graph) {
+		int newPolygons = pf_s->polygons.size() - graphPolygons;
+
+		if (count - newPolygons == (int)graph->visibility.size()) {
+			pf_s->_graph = graph;
+			pf_s->_graphOffset = newPolygons;
+		}
+	}
+
 	return pf_s;
 }
 
+/**
+ * Converts the SCI input data for pathfinding
+ * Parameters: (EngineState *) s: The game state
+ *             (reg_t) poly_list: Polygon list
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
+ *                            NULL otherwise
+ */
+static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
+	AvoidPathCache *cache = s->_avoidPathCache;
+	Polygon *polygon;
+	PathfindingState *pf_s = new PathfindingState(width, height);
+
+	// Convert all polygons
+	if (poly_list.getSegment()) {
+		List *list = s->_segMan->lookupList(poly_list);
+		Node *node = s->_segMan->lookupNode(list->first);
+
+		while (node) {
+			// The node value might be null, in which case there's no polygon to parse.
+			// Happens in LB2 floppy - refer to bug #5195
+			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : nullptr;
+
+			if (polygon)
+				pf_s->polygons.push_back(polygon);
+
+			node = s->_segMan->lookupNode(node->succ);
+		}
+	}
+
+	if (cache->recording && cache->recordedCalls.size() < AvoidPathCache::kMaxRecordedCalls) {
+		AvoidPathCall call;
+		store_polygon_set(pf_s->polygons, call.polygons);
+		call.start = start;
+		call.end = end;
+		call.width = width;
+		call.height = height;
+		call.opt = opt;
+		cache->recordedCalls.push_back(call);
+	}
+
+	return prepare_polygon_set(s, pf_s, start, end, opt, cache);
+}
+
 /**
  * Computes a shortest path from vertex_start to vertex_end. The caller can
  * construct the resulting path by following the path_prev links from
@@ -1469,83 +1642,105 @@ static reg_t allocateOutputArray(SegManager *segMan, int size) {
 }
 
 /**
- * Stores the final path in newly allocated dynmem
+ * Collects the points of the final path
  * Parameters: (PathfindingState *) p: The pathfinding state
- *             (EngineState *) s: The game state
- * Returns   : (reg_t) Pointer to dynmem containing path
+ *             (Common::Array<Common::Point> &) path: The array to store the points in
  */
-static reg_t output_path(PathfindingState *p, EngineState *s) {
-	int path_len = 0;
-	reg_t output;
+static void collect_path(PathfindingState *p, Common::Array<Common::Point> &path) {
 	Vertex *vertex = p->vertex_end;
-	int unreachable = vertex->path_prev == nullptr;
-
-	if (!unreachable) {
-		while (vertex) {
-			// Compute path length
-			path_len++;
-			vertex = vertex->path_prev;
-		}
-	}
 
-	// Allocate memory for path, plus 3 extra for appended point, prepended point and sentinel
-	output = allocateOutputArray(s->_segMan, path_len + 3);
-	SegmentRef arrayRef = s->_segMan->dereference(output);
-	assert(arrayRef.isValid() && !arrayRef.skipByte);
-
-	if (unreachable) {
+	if (vertex->path_prev == nullptr) {
 		// If pathfinding failed we only return the path up to vertex_start
 
 		if (p->_prependPoint)
-			writePoint(arrayRef, 0, *p->_prependPoint);
+			path.push_back(*p->_prependPoint);
 		else
-			writePoint(arrayRef, 0, p->vertex_start->v);
+			path.push_back(p->vertex_start->v);
 
-		writePoint(arrayRef, 1, p->vertex_start->v);
-		writePoint(arrayRef, 2, Common::Point(POLY_LAST_POINT, POLY_LAST_POINT));
-
-		return output;
+		path.push_back(p->vertex_start->v);
+		return;
 	}
 
-	int offset = 0;
+	if (p->_prependPoint)
+		path.push_back(*p->_prependPoint);
 
-	if (p->_prependPoint) {
-		writePoint(arrayRef, offset, *p->_prependPoint);
-		offset++;
+	uint path_len = 0;
+	while (vertex) {
+		// Compute path length
+		path_len++;
+		vertex = vertex->path_prev;
 	}
 
+	uint offset = path.size();
+	path.resize(offset + path_len);
+
 	vertex = p->vertex_end;
 	for (int i = path_len - 1; i >= 0; i--) {
-		writePoint(arrayRef, offset + i, vertex->v);
+		path[offset + i] = vertex->v;
 		vertex = vertex->path_prev;
 	}
-	offset += path_len;
 
 	if (p->_appendPoint)
-		writePoint(arrayRef, offset++, *p->_appendPoint);
+		path.push_back(*p->_appendPoint);
+}
+
+/**
+ * Stores the final path in newly allocated dynmem
+ * Parameters: (PathfindingState *) p: The pathfinding state
+ *             (EngineState *) s: The game state
+ * Returns   : (reg_t) Pointer to dynmem containing path
+ */
+static reg_t output_path(PathfindingState *p, EngineState *s) {
+	Common::Array<Common::Point> path;
+	collect_path(p, path);
+
+	// Allocate memory for path, plus one extra for the sentinel
+	reg_t output = allocateOutputArray(s->_segMan, path.size() + 1);
+	SegmentRef arrayRef = s->_segMan->dereference(output);
+	assert(arrayRef.isValid() && !arrayRef.skipByte);
+
+	for (uint i = 0; i < path.size(); i++)
+		writePoint(arrayRef, i, path[i]);
 
 	// Sentinel
-	writePoint(arrayRef, offset, Common::Point(POLY_LAST_POINT, POLY_LAST_POINT));
+	writePoint(arrayRef, path.size(), Common::Point(POLY_LAST_POINT, POLY_LAST_POINT));
 
-	if (DebugMan.isDebugChannelEnabled(kDebugLevelAvoidPath)) {
+	if (DebugMan.isDebugChannelEnabled(kDebugLevelAvoidPath) && p->vertex_end->path_prev) {
 		debug("\nReturning path:");
 
-		SegmentRef outputList = s->_segMan->dereference(output);
-		if (!outputList.isValid() || outputList.skipByte) {
-			warning("output_path: Polygon data pointer is invalid, skipping polygon");
-			return output;
-		}
-
-		for (int i = 0; i < offset; i++) {
-			Common::Point pt = readPoint(outputList, i);
-			debugN(-1, " (%i, %i)", pt.x, pt.y);
-		}
+		for (uint i = 0; i < path.size(); i++)
+			debugN(-1, " (%i, %i)", path[i].x, path[i].y);
 		debug(";\n");
 	}
 
 	return output;
 }
 
+void replayAvoidPathCalls(EngineState *s, Common::Array<Common::Array<Common::Point> > &paths) {
+	AvoidPathCache *cache = s->_avoidPathCache;
+
+	paths.clear();
+	paths.resize(cache->recordedCalls.size());
+
+	for (uint i = 0; i < cache->recordedCalls.size(); i++) {
+		const AvoidPathCall &call = cache->recordedCalls[i];
+		PathfindingState *p = new PathfindingState(call.width, call.height);
+
+		restore_polygon_set(call.polygons, p->polygons);
+		p = prepare_polygon_set(s, p, call.start, call.end, call.opt, cache);
+
+		if (!p) {
+			paths[i].push_back(call.start);
+			paths[i].push_back(call.end);
+			continue;
+		}
+
+		AStar(p);
+		collect_path(p, paths[i]);
+		delete p;
+	}
+}
+
 reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 	Common::Point start = Common::Point(argv[0].toSint16(), argv[1].toSint16());
 
@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCI_ENGINE_KPATHING_H
+#define SCI_ENGINE_KPATHING_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Sci {
+
+struct EngineState;
+
+/**
+ * A set of polygons, as kAvoidPath sees it after converting the SCI polygons.
+ * The vertices of all polygons are stored one after the other, in the order
+ * of their circular lists.
+ */
+struct AvoidPathPolygons {
+	Common::Array<Common::Point> points;
+	Common::Array<uint16> sizes; ///< Number of points of each polygon
+	Common::Array<int> types; ///< SCI type of each polygon
+
+	bool operator==(const AvoidPathPolygons &other) const {
+		return points == other.points && sizes == other.sizes && types == other.types;
+	}
+};
+
+/**
+ * The visibility graph of a polygon set, once the start and end points of a
+ * call had their polygons removed but before they were merged into it.
+ */
+struct AvoidPathGraph {
+	AvoidPathPolygons polygons;
+
+	/**
+	 * For each vertex, whether it can see each of the other vertices. This
+	 * is empty for the vertices the pathfinder has not expanded yet.
+	 */
+	Common::Array<Common::Array<bool> > visibility;
+
+	uint32 lastUse;
+};
+
+/** The input of a kAvoidPath call that looked for a path */
+struct AvoidPathCall {
+	AvoidPathPolygons polygons;
+	Common::Point start, end;
+	int width, height;
+	int opt;
+};
+
+/**
+ * Keeps the visibility graphs of the last few polygon sets kAvoidPath saw,
+ * since games look for paths through the same polygons over and over. As the
+ * graphs are looked up by the contents of the polygons, they do not have to
+ * be invalidated when the polygons change.
+ *
+ * This also records the pathfinding calls for the avoidpath_bench console
+ * command, while that is enabled.
+ */
+struct AvoidPathCache {
+	enum {
+		kMaxGraphs = 8,
+		kMaxRecordedCalls = 1000
+	};
+
+	Common::Array<AvoidPathGraph> graphs;
+	uint32 useCounter;
+	bool enabled;
+
+	uint32 hits;
+	uint32 misses;
+
+	bool recording;
+	Common::Array<AvoidPathCall> recordedCalls;
+
+	AvoidPathCache() : useCounter(0), enabled(true), hits(0), misses(0), recording(false) {}
+};
+
+/**
+ * Looks for the paths of the recorded kAvoidPath calls again, and returns the
+ * paths that were found. The cache is only used if it is enabled.
+ */
+void replayAvoidPathCalls(EngineState *s, Common::Array<Common::Array<Common::Point> > &paths);
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_KPATHING_H
@@ -70,6 +70,9 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_markedAsDeleted = false;
 	_objects.clear();
 
+	_instructions.clear();
+	_instructionIndex.clear();
+
 	_offsetLookupArray.clear();
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
@@ -702,6 +705,27 @@ int Script::relocateOffsetSci3(uint32 offset) const {
 }
 #endif
 
+const PMachineInstruction &Script::decodeInstruction(uint32 offset, uint &next) {
+	PMachineInstruction instruction;
+	instruction.size = readPMachineInstruction(getBuf(offset), instruction.extOpcode, instruction.opparams);
+	instruction.offset = offset;
+
+	// The index has room for 65535 instructions, which no script comes close
+	// to. Should one still have more, the rest just gets decoded every time.
+	if (_instructions.size() >= 0xFFFF) {
+		_uncachedInstruction = instruction;
+		return _uncachedInstruction;
+	}
+
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(getBufSize());
+
+	_instructions.push_back(instruction);
+	_instructionIndex[offset] = _instructions.size();
+	next = _instructions.size();
+	return _instructions.back();
+}
+
 bool Script::relocateLocal(SegmentId segment, int location, uint32 offset) {
 	if (_localsBlock)
 		return relocateBlock(_localsBlock->_locals, _localsOffset, segment, location, offset);
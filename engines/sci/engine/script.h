@@ -93,6 +93,14 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/**
+	 * The instructions decoded by getInstruction(), and the index of each of
+	 * them in this array plus one for every offset of the script.
+	 */
+	Common::Array<PMachineInstruction> _instructions;
+	Common::Array<uint16> _instructionIndex;
+	PMachineInstruction _uncachedInstruction; ///< Used once the index is full
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -126,6 +134,28 @@ public:
 	ObjMap &getObjectMap() { return _objects; }
 	const ObjMap &getObjectMap() const { return _objects; }
 
+	/**
+	 * Returns the instruction at the given offset of the script, which gets
+	 * decoded the first time it is executed. The returned reference is only
+	 * valid until the next call.
+	 *
+	 * @param offset	the offset of the instruction
+	 * @param next		index of the instruction expected at the offset, set
+	 *					to the one of the instruction after the returned one.
+	 *					Code mostly runs in the order in which it was decoded,
+	 *					so this usually avoids looking up the index.
+	 */
+	// speed optimization: inline due to frequent calling
+	const PMachineInstruction &getInstruction(uint32 offset, uint &next) {
+		if (next < _instructions.size() && _instructions[next].offset == offset)
+			return _instructions[next++];
+		if (offset < _instructionIndex.size() && _instructionIndex[offset]) {
+			next = _instructionIndex[offset];
+			return _instructions[next - 1];
+		}
+		return decodeInstruction(offset, next);
+	}
+
 	// speed optimization: inline due to frequent calling
 	bool offsetIsObject(uint32 offset) const {
 		return _buf->getUint16SEAt(offset + SCRIPT_OBJECT_MAGIC_OFFSET) == SCRIPT_OBJECT_MAGIC_NUMBER;
@@ -324,6 +354,8 @@ private:
 
 	bool relocateLocal(SegmentId segment, int location, uint32 offset);
 
+	const PMachineInstruction &decodeInstruction(uint32 offset, uint &next);
+
 #ifdef ENABLE_SCI32
 	/**
 	 * Gets a pointer to the beginning of the objects in a SCI3 script
@@ -460,6 +460,13 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * Returns a counter that changes whenever scripts are loaded (and patched)
+	 * or unloaded, so that the VM knows when to flush what it cached about
+	 * the script objects.
+	 */
+	uint32 getScriptGeneration() const { return _scriptGeneration; }
+
 private:
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
@@ -474,6 +481,8 @@ private:
 	SegmentId _nodesSegId; ///< ID of the (a) node segment
 	SegmentId _hunksSegId; ///< ID of the (a) hunk segment
 
+	uint32 _scriptGeneration; ///< See getScriptGeneration()
+
 	// Statically allocated memory for system strings
 	reg_t _saveDirPtr;
 	reg_t _parserPtr;
@@ -367,4 +367,120 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 //	return _lookupSelector_function(segMan, obj, selectorId, fptr);
 }
 
+SendCache::SendCache() : _segMan(nullptr), _scriptGeneration(0) {
+	clear();
+	resetStats();
+}
+
+void SendCache::clear() {
+	for (uint i = 0; i < kCallSiteCount; i++) {
+		_callSites[i].pc = NULL_REG;
+		_callSites[i].entryCount = 0;
+		_callSites[i].nextEntry = 0;
+		_callSites[i].megamorphic = false;
+	}
+}
+
+void SendCache::resetStats() {
+	_stats.hits = 0;
+	_stats.misses = 0;
+	_stats.flushes = 0;
+	_stats.conflicts = 0;
+}
+
+void SendCache::countCallSites(uint &monomorphic, uint &polymorphic, uint &megamorphic) const {
+	monomorphic = polymorphic = megamorphic = 0;
+
+	for (uint i = 0; i < kCallSiteCount; i++) {
+		const CallSite &site = _callSites[i];
+		if (site.megamorphic)
+			megamorphic++;
+		else if (site.entryCount > 1)
+			polymorphic++;
+		else if (site.entryCount == 1)
+			monomorphic++;
+	}
+}
+
+SelectorType SendCache::lookupSelector(SegManager *segMan, reg_t callSite, reg_t objAddr, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
+	if (callSite.isNull())
+		return Sci::lookupSelector(segMan, objAddr, selectorId, varp, fptr);
+
+	if (segMan != _segMan || segMan->getScriptGeneration() != _scriptGeneration) {
+		if (_segMan)
+			_stats.flushes++;
+		clear();
+		_segMan = segMan;
+		_scriptGeneration = segMan->getScriptGeneration();
+	}
+
+	const Object *obj = segMan->getObject(objAddr);
+	if (!obj) {
+		// Let lookupSelector() complain about it
+		return Sci::lookupSelector(segMan, objAddr, selectorId, varp, fptr);
+	}
+
+	const reg_t pos = obj->getPos();
+	const reg_t superClass = obj->getSuperClassSelector();
+
+	CallSite &site = _callSites[(callSite.getOffset() ^ (callSite.getSegment() << 7)) & (kCallSiteCount - 1)];
+	if (site.pc != callSite) {
+		if (site.entryCount)
+			_stats.conflicts++;
+		site.pc = callSite;
+		site.entryCount = 0;
+		site.nextEntry = 0;
+		site.megamorphic = false;
+	}
+
+	for (uint i = 0; i < site.entryCount; i++) {
+		const Entry &entry = site.entries[i];
+		if (entry.selector == selectorId && entry.pos == pos && entry.superClass == superClass) {
+			_stats.hits++;
+			if (entry.type == kSelectorVariable) {
+				if (varp) {
+					varp->obj = objAddr;
+					varp->varindex = entry.varIndex;
+				}
+			} else if (fptr) {
+				*fptr = entry.funcp;
+			}
+			return entry.type;
+		}
+	}
+
+	_stats.misses++;
+
+	ObjVarRef var;
+	reg_t funcp = NULL_REG;
+	const SelectorType type = Sci::lookupSelector(segMan, objAddr, selectorId, &var, &funcp);
+	if (type == kSelectorNone)
+		return type;
+
+	Entry *entry;
+	if (site.entryCount < kEntriesPerCallSite) {
+		entry = &site.entries[site.entryCount++];
+	} else {
+		entry = &site.entries[site.nextEntry];
+		site.nextEntry = (site.nextEntry + 1) % kEntriesPerCallSite;
+		site.megamorphic = true;
+	}
+
+	entry->pos = pos;
+	entry->superClass = superClass;
+	entry->selector = selectorId;
+	entry->type = type;
+	if (type == kSelectorVariable) {
+		entry->varIndex = var.varindex;
+		if (varp)
+			*varp = var;
+	} else {
+		entry->funcp = funcp;
+		if (fptr)
+			*fptr = funcp;
+	}
+
+	return type;
+}
+
 } // End of namespace Sci
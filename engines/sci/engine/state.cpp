@@ -26,6 +26,7 @@
 #include "sci/engine/file.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/vm.h"
@@ -69,6 +70,7 @@ static const uint16 s_halfWidthSJISMap[256] = {
 EngineState::EngineState(SegManager *segMan) :
 	_segMan(segMan),
 	_msgState(nullptr),
+	_avoidPathCache(new AvoidPathCache()),
 	_dirseeker() {
 
 	reset(false);
@@ -76,6 +78,7 @@ EngineState::EngineState(SegManager *segMan) :
 
 EngineState::~EngineState() {
 	delete _msgState;
+	delete _avoidPathCache;
 }
 
 void EngineState::reset(bool isRestoring) {
@@ -47,6 +47,7 @@ class DirSeeker;
 class EventManager;
 class MessageState;
 class SoundCommandParser;
+struct AvoidPathCache;
 class VirtualIndexFile;
 
 enum AbortGameState {
@@ -56,6 +57,28 @@ enum AbortGameState {
 	kAbortQuitGame = 3
 };
 
+/**
+ * Statistics about the pauses of the garbage collector, see run_gc()
+ */
+struct GCStats {
+	uint32 collections;
+	uint32 lastPause; ///< In microseconds
+	uint32 maxPause; ///< In microseconds
+	uint64 totalPause; ///< In microseconds
+	uint32 lastMarked; ///< Addresses found to be referenced by the last collection
+	uint32 lastFreed;
+	uint32 totalFreed;
+
+	GCStats() { reset(); }
+
+	void reset() {
+		collections = 0;
+		lastPause = maxPause = totalPause = 0;
+		lastMarked = 0;
+		lastFreed = totalFreed = 0;
+	}
+};
+
 // We assume that scripts give us savegameId 0->99 for creating a new save slot
 //  and savegameId 100->199 for existing save slots. Refer to kfile.cpp
 enum {
@@ -170,6 +193,8 @@ struct EngineState : public Common::Serializable {
 	AbortGameState abortScriptProcessing;
 	int16 gameIsRestarting; // is set when restarting (=1) or restoring the game (=2)
 
+	SendCache _sendCache; /**< Caches the selector lookups of the sends */
+
 	int scriptStepCounter; // Counts the number of steps executed
 	int scriptGCInterval; // Number of steps in between gcs
 
@@ -188,9 +213,12 @@ struct EngineState : public Common::Serializable {
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	GCStats _gcStats;
 
 	MessageState *_msgState;
 
+	AvoidPathCache *_avoidPathCache; /**< Visibility graphs of the kAvoidPath polygons */
+
 	// MemorySegment provides access to a 256-byte block of memory that remains
 	// intact across restarts and restores
 	enum {
@@ -360,10 +360,12 @@ ExecStack *execute_method(EngineState *s, uint16 script, uint16 pubfunct,
  * 						[selector_number][argument_counter] and then
  * 						"argument_counter" word entries with the
  * 						parameter values.
+ * @param[in] callSite	Address of the send in the script, for caching
+ * 						the selector lookups, or NULL_REG
  * @return				A pointer to the new execution stack TOS entry
  */
 ExecStack *send_selector(EngineState *s, reg_t send_obj, reg_t work_obj,
-	StackPtr sp, int framesize, StackPtr argp);
+	StackPtr sp, int framesize, StackPtr argp, reg_t callSite = NULL_REG);
 
 
 /**
@@ -403,6 +405,76 @@ void script_debug(EngineState *s);
 SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
 		ObjVarRef *varp, reg_t *fptr);
 
+/**
+ * A polymorphic inline cache for the selector lookups of the sends. For each
+ * call site, it remembers what lookupSelector() returned for the last few
+ * kinds of objects that were sent to from there, so that the sends in the
+ * doit loops of the scripts do not walk the superclass chain every time.
+ *
+ * The kind of an object is its position, which clones share with the object
+ * they were cloned from, and its superclass. Together these determine both
+ * the variable and the method tables of the object. Everything is flushed
+ * when the segment manager loads or unloads scripts.
+ */
+class SendCache {
+public:
+	struct Stats {
+		uint32 hits;
+		uint32 misses;
+		uint32 flushes; ///< Times the cache was flushed because scripts changed
+		uint32 conflicts; ///< Times a call site replaced another one in the cache
+	};
+
+	SendCache();
+
+	/**
+	 * Looks up a selector like lookupSelector() does, for a send from the
+	 * given call site. A null call site skips the cache.
+	 */
+	SelectorType lookupSelector(SegManager *segMan, reg_t callSite, reg_t obj,
+			Selector selectorId, ObjVarRef *varp, reg_t *fptr);
+
+	/** Forgets all the cached lookups. */
+	void clear();
+
+	const Stats &getStats() const { return _stats; }
+	void resetStats();
+
+	/**
+	 * Counts the call sites in the cache which saw a single kind of object,
+	 * several of them, and more of them than the cache keeps per call site.
+	 */
+	void countCallSites(uint &monomorphic, uint &polymorphic, uint &megamorphic) const;
+
+private:
+	enum {
+		kCallSiteCount = 2048, ///< Must be a power of two
+		kEntriesPerCallSite = 4
+	};
+
+	struct Entry {
+		reg_t pos;
+		reg_t superClass;
+		Selector selector;
+		SelectorType type;
+		int varIndex;
+		reg_t funcp;
+	};
+
+	struct CallSite {
+		reg_t pc;
+		byte entryCount;
+		byte nextEntry; ///< The entry to replace once all of them are used
+		bool megamorphic;
+		Entry entries[kEntriesPerCallSite];
+	};
+
+	CallSite _callSites[kCallSiteCount];
+	const SegManager *_segMan;
+	uint32 _scriptGeneration;
+	Stats _stats;
+};
+
 /**
  * Read a PMachine instruction from a memory buffer and return its length.
  *
@@ -421,6 +493,18 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
  */
 int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4]);
 
+/**
+ * A PMachine instruction as read by readPMachineInstruction(). Scripts keep
+ * the instructions they execute in this form, so that the VM only has to
+ * parse each of them once.
+ */
+struct PMachineInstruction {
+	int16 opparams[4];
+	uint16 size; ///< Length of the instruction in the script, in bytes
+	byte extOpcode;
+	uint32 offset; ///< Offset of the instruction in the script
+};
+
 /**
  * Finds the script-absolute offset of a relative object offset.
  *
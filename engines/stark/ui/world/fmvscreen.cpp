@@ -84,6 +84,9 @@ void FMVScreen::play(const Common::Path &name) {
 		error("Could not open %s", name.toString().c_str());
 	}
 	_decoder->setOutputPixelFormat(_bitmap->getBestPixelFormat());
+	// Decode a few frames on a separate thread, so that the high resolution
+	// videos don't stutter when a frame takes longer to decode
+	_decoder->setDecodeAhead(4);
 	_decoder->start();
 }
 
@@ -0,0 +1,128 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "graphics/dirty_region.h"
+
+namespace Graphics {
+
+DirtyRegion::DirtyRegion(int tileSize)
+	: _tileSize(tileSize), _width(0), _height(0), _tilesW(0), _tilesH(0), _numDirtyTiles(0), _addedPixels(0) {
+	assert(tileSize > 0);
+}
+
+void DirtyRegion::setSize(int width, int height) {
+	_width = width;
+	_height = height;
+	_tilesW = (width + _tileSize - 1) / _tileSize;
+	_tilesH = (height + _tileSize - 1) / _tileSize;
+	_tiles.resize(_tilesW * _tilesH);
+	clear();
+}
+
+void DirtyRegion::addRect(const Common::Rect &r) {
+	Common::Rect area(r);
+	area.clip(Common::Rect(_width, _height));
+	if (area.isEmpty())
+		return;
+
+	_addedPixels += area.width() * area.height();
+
+	const int left = area.left / _tileSize;
+	const int right = (area.right - 1) / _tileSize;
+	const int top = area.top / _tileSize;
+	const int bottom = (area.bottom - 1) / _tileSize;
+
+	for (int y = top; y <= bottom; y++) {
+		bool *tile = &_tiles[y * _tilesW + left];
+		for (int x = left; x <= right; x++, tile++) {
+			if (!*tile) {
+				*tile = true;
+				_numDirtyTiles++;
+			}
+		}
+	}
+}
+
+void DirtyRegion::addAll() {
+	for (uint i = 0; i < _tiles.size(); i++)
+		_tiles[i] = true;
+	_numDirtyTiles = _tiles.size();
+	_addedPixels += _width * _height;
+}
+
+void DirtyRegion::clear() {
+	for (uint i = 0; i < _tiles.size(); i++)
+		_tiles[i] = false;
+	_numDirtyTiles = 0;
+	_addedPixels = 0;
+}
+
+void DirtyRegion::getRects(Common::Array<Common::Rect> &rects) const {
+	if (isEmpty())
+		return;
+
+	if (isFull()) {
+		rects.push_back(Common::Rect(_width, _height));
+		return;
+	}
+
+	// The rectangles that end at the current tile row, which can still grow
+	// downwards. They are stored as indices into rects and sorted by column.
+	Common::Array<uint> open, next;
+
+	for (int y = 0; y < _tilesH; y++) {
+		const bool *row = &_tiles[y * _tilesW];
+		const int16 top = y * _tileSize;
+		const int16 bottom = MIN(top + _tileSize, _height);
+		uint o = 0;
+
+		next.clear();
+		for (int x = 0; x < _tilesW; x++) {
+			if (!row[x])
+				continue;
+
+			int start = x;
+			while (x < _tilesW && row[x])
+				x++;
+
+			const int16 left = start * _tileSize;
+			const int16 right = MIN(x * _tileSize, _width);
+
+			// Skip the open rectangles left of this run
+			while (o < open.size() && rects[open[o]].left < left)
+				o++;
+
+			if (o < open.size() && rects[open[o]].left == left && rects[open[o]].right == right) {
+				rects[open[o]].bottom = bottom;
+				next.push_back(open[o]);
+				o++;
+			} else {
+				rects.push_back(Common::Rect(left, top, right, bottom));
+				next.push_back(rects.size() - 1);
+			}
+		}
+
+		open.swap(next);
+	}
+}
+
+} // End of namespace Graphics
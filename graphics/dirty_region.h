@@ -0,0 +1,98 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_DIRTY_REGION_H
+#define GRAPHICS_DIRTY_REGION_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_dirty_region Dirty region
+ * @ingroup graphics
+ *
+ * @brief Tile based tracking of the changed areas of a screen.
+ *
+ * @{
+ */
+
+/**
+ * Keeps track of the changed areas of a screen as a bitmap of square tiles.
+ *
+ * Unlike a list of rectangles, this never overflows and never updates the
+ * same pixel twice, no matter how many overlapping rectangles are added.
+ * The dirty tiles are handed out again as a small number of rectangles
+ * aligned to the tile grid.
+ */
+class DirtyRegion {
+public:
+	explicit DirtyRegion(int tileSize = 32);
+
+	/** Resize the tracked area. This also clears it. */
+	void setSize(int width, int height);
+
+	int getWidth() const { return _width; }
+	int getHeight() const { return _height; }
+	int getTileSize() const { return _tileSize; }
+
+	/** Mark the tiles touched by @p r as dirty, clipping it to the area. */
+	void addRect(const Common::Rect &r);
+
+	/** Mark the whole area as dirty. */
+	void addAll();
+
+	/** Mark everything as clean again. */
+	void clear();
+
+	bool isEmpty() const { return _numDirtyTiles == 0; }
+	bool isFull() const { return _numDirtyTiles == _tiles.size(); }
+
+	/**
+	 * The sum of the areas of the rectangles added since the last clear().
+	 * Overlapping pixels are counted once for each rectangle, which is what
+	 * updating each rectangle separately would have cost.
+	 */
+	uint32 getAddedPixels() const { return _addedPixels; }
+
+	/**
+	 * Append the dirty area to @p rects. Each rectangle covers a horizontal
+	 * run of dirty tiles, merged with the runs below it that span exactly the
+	 * same columns. The rectangles are clipped to the area and do not overlap.
+	 */
+	void getRects(Common::Array<Common::Rect> &rects) const;
+
+private:
+	int _tileSize;
+	int _width, _height;
+	int _tilesW, _tilesH;
+	Common::Array<bool> _tiles;
+	uint _numDirtyTiles;
+	uint32 _addedPixels;
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
@@ -212,6 +212,23 @@ public:
 	virtual void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const = 0;
 	virtual void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const;
 
+	/**
+	 * Draw a run of characters on the same line to the specified surface.
+	 *
+	 * This is the same as calling drawChar for every character in order, but
+	 * lets fonts draw the whole run at once. drawString uses it for the
+	 * characters it draws.
+	 *
+	 * @param dst   The surface to draw on.
+	 * @param chrs  The characters to draw.
+	 * @param xs    The x coordinate where to draw each character.
+	 * @param count The number of characters.
+	 * @param y     The y coordinate where to draw the characters.
+	 * @param color The color of the characters.
+	 */
+	virtual void drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const;
+	virtual void drawChars(ManagedSurface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const;
+
 	/** @overload */
 
 	/**
@@ -30,6 +30,7 @@
 #include "graphics/font.h"
 #include "graphics/surface.h"
 #include "graphics/managed_surface.h"
+#include "graphics/shelf_packer.h"
 
 #include "common/ustr.h"
 #include "common/file.h"
@@ -37,6 +38,7 @@
 #include "common/singleton.h"
 #include "common/stream.h"
 #include "common/memstream.h"
+#include "common/algorithm.h"
 #include "common/hashmap.h"
 #include "common/ptr.h"
 #include "common/compression/unzip.h"
@@ -89,6 +91,241 @@ inline int divRoundToNearest(int dividend, int divisor) {
 
 } // End of anonymous namespace
 
+/**
+ * The glyph images of all the TTF fonts, packed into shared pages.
+ *
+ * Glyphs are keyed by the face they were rendered with, which covers the
+ * font file, its size and the render mode, so fonts loaded several times
+ * share their glyphs instead of rendering them again. Once all pages are
+ * in use, the least recently used page gets evicted, and the fonts render
+ * its glyphs again when they are needed.
+ */
+class TTFGlyphAtlas {
+public:
+	struct Entry {
+		int page; ///< -1 for glyphs without an image
+		int x, y;
+		int width, height;
+		int xOffset, yOffset;
+		int advance;
+	};
+
+	TTFGlyphAtlas();
+	~TTFGlyphAtlas();
+
+	/**
+	 * Return the id for glyphs of the face described by @p faceKey.
+	 */
+	uint getFaceId(const Common::String &faceKey);
+
+	/**
+	 * Start a new use of the atlas. Pages used since the last call are
+	 * never evicted, so the images returned until the next call stay valid.
+	 */
+	void startUse() { _clock++; }
+
+	const Entry *find(uint faceId, uint slot);
+	const Entry *add(uint faceId, uint slot, const Entry &metrics, const Surface &image);
+
+	/**
+	 * Mark the page of an entry as used. Entries stay valid as long as the
+	 * eviction count does not change.
+	 */
+	void touch(const Entry &entry) {
+		if (entry.page >= 0)
+			_pages[entry.page]->lastUse = _clock;
+	}
+
+	uint32 getEvictionCount() const { return _evictionCount; }
+
+	const uint8 *getPixels(const Entry &entry) const {
+		return (const uint8 *)_pages[entry.page]->surface.getBasePtr(entry.x, entry.y);
+	}
+
+	int getPitch(const Entry &entry) const {
+		return _pages[entry.page]->surface.pitch;
+	}
+
+private:
+	static const int kPageSize = 256;
+	static const uint kMaxPages = 16;
+
+	struct Key {
+		uint faceId;
+		uint slot;
+
+		bool operator==(const Key &other) const {
+			return faceId == other.faceId && slot == other.slot;
+		}
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &key) const {
+			return key.faceId * 0x9E3779B1 ^ key.slot;
+		}
+	};
+
+	struct Page {
+		explicit Page(int size) : packer(size, size, size, 0), lastUse(0) {}
+
+		Surface surface;
+		ShelfPacker packer;
+		uint32 lastUse;
+		Common::Array<Key> keys;
+	};
+
+	bool allocate(Page &page, int width, int height, int &x, int &y);
+	Page *createPage(int size);
+	void evictPage(Page &page);
+	void removePage(uint index);
+
+	typedef Common::HashMap<Key, Entry, KeyHash> EntryMap;
+	EntryMap _entries;
+	Common::HashMap<Common::String, uint> _faceIds;
+	Common::Array<Page *> _pages;
+	uint32 _clock;
+	uint32 _evictionCount;
+};
+
+TTFGlyphAtlas::TTFGlyphAtlas() : _clock(0), _evictionCount(0) {
+}
+
+TTFGlyphAtlas::~TTFGlyphAtlas() {
+	for (uint i = 0; i < _pages.size(); i++) {
+		_pages[i]->surface.free();
+		delete _pages[i];
+	}
+}
+
+uint TTFGlyphAtlas::getFaceId(const Common::String &faceKey) {
+	Common::HashMap<Common::String, uint>::const_iterator i = _faceIds.find(faceKey);
+	if (i != _faceIds.end())
+		return i->_value;
+
+	uint faceId = _faceIds.size();
+	_faceIds[faceKey] = faceId;
+	return faceId;
+}
+
+const TTFGlyphAtlas::Entry *TTFGlyphAtlas::find(uint faceId, uint slot) {
+	Key key = { faceId, slot };
+	EntryMap::const_iterator i = _entries.find(key);
+	if (i == _entries.end())
+		return nullptr;
+
+	touch(i->_value);
+	return &i->_value;
+}
+
+const TTFGlyphAtlas::Entry *TTFGlyphAtlas::add(uint faceId, uint slot, const Entry &metrics, const Surface &image) {
+	Key key = { faceId, slot };
+	Entry &entry = _entries[key];
+	entry = metrics;
+	entry.page = -1;
+	entry.x = entry.y = 0;
+	entry.width = image.w;
+	entry.height = image.h;
+
+	if (!image.w || !image.h)
+		return &entry;
+
+	// Glyphs are first packed into the most recently used pages
+	int page = -1;
+	for (int i = _pages.size() - 1; i >= 0 && page < 0; i--) {
+		if (allocate(*_pages[i], image.w, image.h, entry.x, entry.y))
+			page = i;
+	}
+
+	if (page < 0) {
+		// A run of glyphs which all had to be kept may have pushed the atlas
+		// past its size, give the surplus pages back once they can be evicted
+		while (_pages.size() > kMaxPages) {
+			int oldest = -1;
+			for (uint i = 0; i < _pages.size(); i++) {
+				if (_pages[i]->lastUse != _clock && (oldest < 0 || _pages[i]->lastUse < _pages[oldest]->lastUse))
+					oldest = i;
+			}
+			if (oldest < 0)
+				break;
+			removePage(oldest);
+		}
+
+		Page *lru = nullptr;
+		if (_pages.size() >= kMaxPages) {
+			for (uint i = 0; i < _pages.size(); i++) {
+				if (_pages[i]->lastUse != _clock && (!lru || _pages[i]->lastUse < lru->lastUse))
+					lru = _pages[i];
+			}
+		}
+
+		if (lru) {
+			evictPage(*lru);
+			if (lru->surface.w < image.w || lru->surface.h < image.h) {
+				const int size = MAX(kPageSize, MAX<int>(image.w, image.h));
+				lru->surface.free();
+				lru->surface.create(size, size, PixelFormat::createFormatCLUT8());
+				lru->packer = ShelfPacker(size, size, size, 0);
+			}
+			page = Common::find(_pages.begin(), _pages.end(), lru) - _pages.begin();
+		} else {
+			// Glyphs larger than a page get a page of their own, the atlas also
+			// grows for now when all its pages hold glyphs of the current run
+			_pages.push_back(createPage(MAX(kPageSize, MAX<int>(image.w, image.h))));
+			page = _pages.size() - 1;
+		}
+
+		allocate(*_pages[page], image.w, image.h, entry.x, entry.y);
+	}
+
+	Page &dst = *_pages[page];
+	entry.page = page;
+	dst.lastUse = _clock;
+	dst.keys.push_back(key);
+	dst.surface.copyRectToSurface(image, entry.x, entry.y, Common::Rect(image.w, image.h));
+	return &entry;
+}
+
+bool TTFGlyphAtlas::allocate(Page &page, int width, int height, int &x, int &y) {
+	// The pages neither grow nor drop single glyphs, so glyphs are never moved
+	const int id = page.packer.add(width, height);
+	if (id < 0)
+		return false;
+
+	const Common::Rect &area = page.packer.getArea(id);
+	x = area.left;
+	y = area.top;
+	return true;
+}
+
+TTFGlyphAtlas::Page *TTFGlyphAtlas::createPage(int size) {
+	Page *page = new Page(size);
+	page->surface.create(size, size, PixelFormat::createFormatCLUT8());
+	page->lastUse = _clock;
+	return page;
+}
+
+void TTFGlyphAtlas::evictPage(Page &page) {
+	for (uint i = 0; i < page.keys.size(); i++)
+		_entries.erase(page.keys[i]);
+
+	page.keys.clear();
+	page.packer = ShelfPacker(page.surface.w, page.surface.h, page.surface.w, 0);
+	_evictionCount++;
+}
+
+void TTFGlyphAtlas::removePage(uint index) {
+	evictPage(*_pages[index]);
+	_pages[index]->surface.free();
+	delete _pages[index];
+	_pages.remove_at(index);
+
+	// The glyphs of the following pages moved down by one page
+	for (uint i = index; i < _pages.size(); i++) {
+		for (uint j = 0; j < _pages[i]->keys.size(); j++)
+			_entries[_pages[i]->keys[j]].page = i;
+	}
+}
+
 class TTFLibrary : public Common::Singleton<TTFLibrary> {
 public:
 	TTFLibrary();
@@ -101,9 +338,12 @@ public:
 
 	bool loadFont(const uint8 *file, const int32 face_index, const uint32 size, FT_Face &face);
 	void closeFont(FT_Face &face);
+
+	TTFGlyphAtlas &getGlyphAtlas() { return _glyphAtlas; }
 private:
 	FT_Library _library;
 	bool _initialized;
+	TTFGlyphAtlas _glyphAtlas;
 };
 
 void shutdownTTF() {
@@ -161,6 +401,9 @@ public:
 	void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const override;
 	void drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const override;
 
+	void drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const override;
+	void drawChars(ManagedSurface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const override;
+
 private:
 	bool _initialized;
 	FT_Face _face;
@@ -171,25 +414,34 @@ private:
 	int _width, _height;
 	int _ascent, _descent;
 
+	// The image of a glyph is kept in the glyph atlas, which may evict it
 	struct Glyph {
-		Surface image;
 		int xOffset, yOffset;
+		int width, height;
 		int advance;
 		FT_UInt slot;
+
+		// The atlas entry of the image, valid until the next eviction
+		const TTFGlyphAtlas::Entry *entry;
+		uint32 entryEvictionCount;
 	};
 
+	uint _faceId;
+
 	bool cacheGlyph(Glyph &glyph, uint32 chr) const;
+	const TTFGlyphAtlas::Entry *getGlyphEntry(Glyph &glyph) const;
+	const TTFGlyphAtlas::Entry *renderGlyph(FT_UInt slot) const;
 	typedef Common::HashMap<uint32, Glyph> GlyphCache;
 	mutable GlyphCache _glyphs;
 	bool _allowLateCaching;
-	void assureCached(uint32 chr) const;
+	Glyph *findGlyph(uint32 chr) const;
 
 	Common::SeekableReadStream *readTTFTable(FT_ULong tag) const;
 
 	int computePointSize(int size, TTFSizeMode sizeMode) const;
 	int readPointSizeFromVDMXTable(int height) const;
 	int computePointSizeFromHeaders(int height) const;
-	void drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color,
+	Common::Rect drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color,
 		const uint32 *transparentColor) const;
 
 	FT_Int32 _loadFlags;
@@ -202,7 +454,7 @@ private:
 
 TTFFont::TTFFont()
 	: _initialized(false), _face(), _ttfFile(0), _size(0), _width(0), _height(0), _ascent(0),
-	  _descent(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
+	  _descent(0), _faceId(0), _glyphs(), _loadFlags(FT_LOAD_TARGET_NORMAL), _renderMode(FT_RENDER_MODE_NORMAL),
 	  _hasKerning(false), _allowLateCaching(false), _fakeBold(false), _fakeItalic(false) {
 }
 
@@ -213,9 +465,6 @@ TTFFont::~TTFFont() {
 		delete[] _ttfFile;
 		_ttfFile = 0;
 
-		for (GlyphCache::iterator i = _glyphs.begin(), end = _glyphs.end(); i != end; ++i)
-			i->_value.image.free();
-
 		_initialized = false;
 	}
 }
@@ -367,6 +616,17 @@ bool TTFFont::load(uint8 *ttfFile, uint32 sizeFile, int32 faceIndex, bool bold,
 		_loadFlags |= FT_LOAD_NO_BITMAP;
 	}
 
+	// Fonts loaded with the same file and settings render the same glyphs,
+	// so they share them in the atlas
+	uint32 fileHash = 2166136261u;
+	for (uint32 i = 0; i < MIN<uint32>(_size, 65536); i++)
+		fileHash = (fileHash ^ _ttfFile[i]) * 16777619u;
+
+	_faceId = g_ttf.getGlyphAtlas().getFaceId(Common::String::format("%s/%s/%ld/%u/%08x/%d/%ld/%ld/%d/%d/%d/%d/%d",
+		_face->family_name ? _face->family_name : "", _face->style_name ? _face->style_name : "",
+		(long)_face->num_glyphs, _size, fileHash, faceIndex, (long)_face->size->metrics.x_scale,
+		(long)_face->size->metrics.y_scale, (int)_loadFlags, (int)_renderMode, _fakeBold, _fakeItalic, stemDarkening));
+
 	if (!mapping) {
 		// Allow loading of all unicode characters.
 		_allowLateCaching = true;
@@ -553,34 +813,30 @@ int TTFFont::getMaxCharWidth() const {
 }
 
 int TTFFont::getCharWidth(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
+	const Glyph *glyph = findGlyph(chr);
+	if (!glyph)
 		return 0;
 	else
-		return glyphEntry->_value.advance;
+		return glyph->advance;
 }
 
 int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 	if (!_hasKerning)
 		return 0;
 
-	assureCached(left);
-	assureCached(right);
-
 	FT_UInt leftGlyph, rightGlyph;
-	GlyphCache::const_iterator glyphEntry;
+	const Glyph *glyph;
 
-	glyphEntry = _glyphs.find(left);
-	if (glyphEntry != _glyphs.end()) {
-		leftGlyph = glyphEntry->_value.slot;
+	glyph = findGlyph(left);
+	if (glyph) {
+		leftGlyph = glyph->slot;
 	} else {
 		return 0;
 	}
 
-	glyphEntry = _glyphs.find(right);
-	if (glyphEntry != _glyphs.end()) {
-		rightGlyph = glyphEntry->_value.slot;
+	glyph = findGlyph(right);
+	if (glyph) {
+		rightGlyph = glyph->slot;
 	} else {
 		return 0;
 	}
@@ -594,158 +850,195 @@ int TTFFont::getKerningOffset(uint32 left, uint32 right) const {
 }
 
 Common::Rect TTFFont::getBoundingBox(uint32 chr) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end()) {
+	const Glyph *glyph = findGlyph(chr);
+	if (!glyph) {
 		return Common::Rect();
 	} else {
-		const int xOffset = glyphEntry->_value.xOffset;
-		const int yOffset = glyphEntry->_value.yOffset;
-		const Graphics::Surface &image = glyphEntry->_value.image;
-		return Common::Rect(xOffset, yOffset, xOffset + image.w, yOffset + image.h);
+		return Common::Rect(glyph->xOffset, glyph->yOffset, glyph->xOffset + glyph->width, glyph->yOffset + glyph->height);
 	}
 }
 
 namespace {
 
 template<typename ColorType>
-static void renderGlyph(uint8 *dstPos, const int dstPitch, const uint8 *srcPos,
-		const int srcPitch, const int w, const int h, ColorType color,
-		const PixelFormat &dstFormat, const uint32 *transparentColor) {
-	uint8 sA, sR, sG, sB;
-	dstFormat.colorToRGB(color, sR, sG, sB);
-
-	for (int y = 0; y < h; ++y) {
-		ColorType *rDst = (ColorType *)dstPos;
-		const uint8 *src = srcPos;
-
-		for (int x = 0; x < w; ++x) {
-			if (*src == 255) {
-				*rDst = color;
-			} else if (*src) {
-				sA = *src;
-
-				uint8 dA, dR, dG, dB;
-				if (transparentColor && *rDst == *transparentColor) {
-					dA = dR = dG = dB = 0;
-				} else {
-					dstFormat.colorToARGB(*rDst, dA, dR, dG, dB);
-				}
+static void renderGlyphRow(ColorType *rDst, const uint8 *src, const int w, ColorType color,
+		uint8 sR, uint8 sG, uint8 sB, const PixelFormat &dstFormat, const uint32 *transparentColor) {
+	for (int x = 0; x < w; ++x) {
+		if (*src == 255) {
+			*rDst = color;
+		} else if (*src) {
+			uint8 sA = *src;
+
+			uint8 dA, dR, dG, dB;
+			if (transparentColor && *rDst == *transparentColor) {
+				dA = dR = dG = dB = 0;
+			} else {
+				dstFormat.colorToARGB(*rDst, dA, dR, dG, dB);
+			}
 
-				double sAn = (double)sA / 255.0;
-				double dAn = (double)dA / 255.0;
-				double oAn = sAn + dAn * (1.0 - sAn);
+			double sAn = (double)sA / 255.0;
+			double dAn = (double)dA / 255.0;
+			double oAn = sAn + dAn * (1.0 - sAn);
 
-				dR = static_cast<uint8>(sR * sAn + dR * dAn * (1.0 - sAn) / oAn);
-				dG = static_cast<uint8>(sG * sAn + dG * dAn * (1.0 - sAn) / oAn);
-				dB = static_cast<uint8>(sB * sAn + dB * dAn * (1.0 - sAn) / oAn);
-				dA = static_cast<uint8>(oAn * 255.0);
+			dR = static_cast<uint8>(sR * sAn + dR * dAn * (1.0 - sAn) / oAn);
+			dG = static_cast<uint8>(sG * sAn + dG * dAn * (1.0 - sAn) / oAn);
+			dB = static_cast<uint8>(sB * sAn + dB * dAn * (1.0 - sAn) / oAn);
+			dA = static_cast<uint8>(oAn * 255.0);
 
-				*rDst = dstFormat.ARGBToColor(dA, dR, dG, dB);
-			}
-
-			++rDst;
-			++src;
+			*rDst = dstFormat.ARGBToColor(dA, dR, dG, dB);
 		}
 
-		dstPos += dstPitch;
-		srcPos += srcPitch;
+		++rDst;
+		++src;
+	}
+}
+
+static void renderGlyphRowCLUT8(uint8 *rDst, const uint8 *src, const int w, uint8 color) {
+	for (int x = 0; x < w; ++x) {
+		// We assume a 1Bpp mode is a color indexed mode, thus we can
+		// not take advantage of anti-aliasing here.
+		if (*src >= 0x80)
+			*rDst = color;
+
+		++rDst;
+		++src;
+	}
+}
+
+// The visible part of a glyph of a run
+struct GlyphSpan {
+	const uint8 *src;
+	int srcPitch;
+	int x, y;
+	int w, h;
+};
+
+// Blend the glyphs row by row. Each pixel still gets the glyphs in the order
+// of the run, so overlapping glyphs look the same as when they are drawn one
+// by one.
+template<typename ColorType, bool kCLUT8>
+static void renderGlyphSpans(Surface *dst, const GlyphSpan *spans, uint numSpans, int top, int bottom,
+		uint32 color, const uint32 *transparentColor) {
+	uint8 sR, sG, sB;
+	dst->format.colorToRGB(color, sR, sG, sB);
+
+	for (int row = top; row < bottom; ++row) {
+		ColorType *dstRow = (ColorType *)dst->getBasePtr(0, row);
+
+		for (uint i = 0; i < numSpans; ++i) {
+			const GlyphSpan &span = spans[i];
+			if (row < span.y || row >= span.y + span.h)
+				continue;
+
+			const uint8 *src = span.src + (row - span.y) * span.srcPitch;
+			if (kCLUT8)
+				renderGlyphRowCLUT8((uint8 *)dstRow + span.x, src, span.w, color);
+			else
+				renderGlyphRow<ColorType>(dstRow + span.x, src, span.w, color, sR, sG, sB, dst->format, transparentColor);
+		}
 	}
 }
 
 } // End of anonymous namespace
 
 void TTFFont::drawChar(Surface *dst, uint32 chr, int x, int y, uint32 color) const {
-	drawChar(dst, chr, x, y, color, nullptr);
+	drawChars(dst, &chr, &x, 1, y, color, nullptr);
 }
 
 void TTFFont::drawChar(ManagedSurface *dst, uint32 chr, int x, int y, uint32 color) const {
+	drawChars(dst, &chr, &x, 1, y, color);
+}
+
+void TTFFont::drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const {
+	drawChars(dst, chrs, xs, count, y, color, nullptr);
+}
+
+void TTFFont::drawChars(ManagedSurface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color) const {
+	Common::Rect bbox;
 	if (dst->hasTransparentColor()) {
 		uint32 transColor = dst->getTransparentColor();
-		drawChar(dst->surfacePtr(), chr, x, y, color, &transColor);
+		bbox = drawChars(dst->surfacePtr(), chrs, xs, count, y, color, &transColor);
 	} else {
-		drawChar(dst->surfacePtr(), chr, x, y, color, nullptr);
+		bbox = drawChars(dst->surfacePtr(), chrs, xs, count, y, color, nullptr);
 	}
 
-	Common::Rect charBox = getBoundingBox(chr);
-	charBox.translate(x, y);
-	dst->addDirtyRect(charBox);
+	if (!bbox.isEmpty())
+		dst->addDirtyRect(bbox);
 }
 
-void TTFFont::drawChar(Surface * dst, uint32 chr, int x, int y, uint32 color,
+Common::Rect TTFFont::drawChars(Surface *dst, const uint32 *chrs, const int *xs, uint count, int y, uint32 color,
 		const uint32 *transparentColor) const {
-	assureCached(chr);
-	GlyphCache::const_iterator glyphEntry = _glyphs.find(chr);
-	if (glyphEntry == _glyphs.end())
-		return;
+	const uint kMaxSpans = 64;
+	GlyphSpan spans[kMaxSpans];
 
-	const Glyph &glyph = glyphEntry->_value;
+	Common::Rect bbox;
+	bool first = true;
 
-	x += glyph.xOffset;
-	y += glyph.yOffset;
+	TTFGlyphAtlas &atlas = g_ttf.getGlyphAtlas();
 
-	if (x > dst->w)
-		return;
-	if (y > dst->h)
-		return;
+	for (uint start = 0; start < count; start += kMaxSpans) {
+		const uint end = MIN(count, start + kMaxSpans);
 
-	int w = glyph.image.w;
-	int h = glyph.image.h;
+		// The glyphs of the run stay in the atlas until the next use
+		atlas.startUse();
 
-	const uint8 *srcPos = (const uint8 *)glyph.image.getPixels();
+		uint numSpans = 0;
+		int top = dst->h, bottom = 0;
 
-	// Make sure we are not drawing outside the screen bounds
-	if (x < 0) {
-		srcPos -= x;
-		w += x;
-		x = 0;
-	}
-
-	if (x + w > dst->w)
-		w = dst->w - x;
-
-	if (w <= 0)
-		return;
+		for (uint i = start; i < end; ++i) {
+			Glyph *glyphPtr = findGlyph(chrs[i]);
+			if (!glyphPtr)
+				continue;
 
-	if (y < 0) {
-		srcPos -= y * glyph.image.pitch;
-		h += y;
-		y = 0;
-	}
+			Glyph &glyph = *glyphPtr;
+			if (!glyph.width || !glyph.height)
+				continue;
 
-	if (y + h > dst->h)
-		h = dst->h - y;
+			int x = xs[i] + glyph.xOffset;
+			int gy = y + glyph.yOffset;
 
-	if (h <= 0)
-		return;
+			Common::Rect charBox(x, gy, x + glyph.width, gy + glyph.height);
+			if (first) {
+				bbox = charBox;
+				first = false;
+			} else {
+				bbox.extend(charBox);
+			}
 
-	uint8 *dstPos = (uint8 *)dst->getBasePtr(x, y);
+			// Make sure we are not drawing outside the screen bounds
+			int left = MAX(x, 0), right = MIN(x + glyph.width, (int)dst->w);
+			int glyphTop = MAX(gy, 0), glyphBottom = MIN(gy + glyph.height, (int)dst->h);
+			if (left >= right || glyphTop >= glyphBottom)
+				continue;
 
-	if (dst->format.isCLUT8()) {
-		for (int cy = 0; cy < h; ++cy) {
-			uint8 *rDst = dstPos;
-			const uint8 *src = srcPos;
+			const TTFGlyphAtlas::Entry *entry = getGlyphEntry(glyph);
+			if (!entry || entry->page < 0)
+				continue;
 
-			for (int cx = 0; cx < w; ++cx) {
-				// We assume a 1Bpp mode is a color indexed mode, thus we can
-				// not take advantage of anti-aliasing here.
-				if (*src >= 0x80)
-					*rDst = color;
+			GlyphSpan &span = spans[numSpans++];
+			span.srcPitch = atlas.getPitch(*entry);
+			span.src = atlas.getPixels(*entry) + (glyphTop - gy) * span.srcPitch + (left - x);
+			span.x = left;
+			span.y = glyphTop;
+			span.w = right - left;
+			span.h = glyphBottom - glyphTop;
 
-				++rDst;
-				++src;
-			}
+			top = MIN(top, glyphTop);
+			bottom = MAX(bottom, glyphBottom);
+		}
 
-			dstPos += dst->pitch;
-			srcPos += glyph.image.pitch;
+		if (dst->format.isCLUT8()) {
+			renderGlyphSpans<uint8, true>(dst, spans, numSpans, top, bottom, color, transparentColor);
+		} else if (dst->format.bytesPerPixel == 1) {
+			renderGlyphSpans<uint8, false>(dst, spans, numSpans, top, bottom, color, transparentColor);
+		} else if (dst->format.bytesPerPixel == 2) {
+			renderGlyphSpans<uint16, false>(dst, spans, numSpans, top, bottom, color, transparentColor);
+		} else if (dst->format.bytesPerPixel == 4) {
+			renderGlyphSpans<uint32, false>(dst, spans, numSpans, top, bottom, color, transparentColor);
 		}
-	} else if (dst->format.bytesPerPixel == 1) {
-		renderGlyph<uint8>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
-	} else if (dst->format.bytesPerPixel == 2) {
-		renderGlyph<uint16>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
-	} else if (dst->format.bytesPerPixel == 4) {
-		renderGlyph<uint32>(dstPos, dst->pitch, srcPos, glyph.image.pitch, w, h, color, dst->format, transparentColor);
 	}
+
+	return bbox;
 }
 
 bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
@@ -755,17 +1048,54 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 
 	glyph.slot = slot;
 
+	// Another font with the same face may have rendered the glyph already
+	const TTFGlyphAtlas::Entry *entry = g_ttf.getGlyphAtlas().find(_faceId, slot);
+	if (!entry)
+		entry = renderGlyph(slot);
+	if (!entry)
+		return false;
+
+	glyph.xOffset = entry->xOffset;
+	glyph.yOffset = entry->yOffset;
+	glyph.width = entry->width;
+	glyph.height = entry->height;
+	glyph.advance = entry->advance;
+	glyph.entry = entry;
+	glyph.entryEvictionCount = g_ttf.getGlyphAtlas().getEvictionCount();
+	return true;
+}
+
+const TTFGlyphAtlas::Entry *TTFFont::getGlyphEntry(Glyph &glyph) const {
+	TTFGlyphAtlas &atlas = g_ttf.getGlyphAtlas();
+	if (glyph.entry && glyph.entryEvictionCount == atlas.getEvictionCount()) {
+		atlas.touch(*glyph.entry);
+		return glyph.entry;
+	}
+
+	glyph.entry = atlas.find(_faceId, glyph.slot);
+
+	// The glyph got evicted from the atlas, render it again
+	if (!glyph.entry)
+		glyph.entry = renderGlyph(glyph.slot);
+
+	glyph.entryEvictionCount = atlas.getEvictionCount();
+	return glyph.entry;
+}
+
+const TTFGlyphAtlas::Entry *TTFFont::renderGlyph(FT_UInt slot) const {
+	TTFGlyphAtlas::Entry glyph;
+
 	// We use the light target and render mode to improve the looks of the
 	// glyphs. It is most noticeable in FreeSansBold.ttf, where otherwise the
 	// 't' glyph looks like it is cut off on the right side.
 	if (FT_Load_Glyph(_face, slot, _loadFlags))
-		return false;
+		return nullptr;
 
 	if (FT_Render_Glyph(_face->glyph, _renderMode))
-		return false;
+		return nullptr;
 
 	if (_face->glyph->format != FT_GLYPH_FORMAT_BITMAP)
-		return false;
+		return nullptr;
 
 	glyph.xOffset = _face->glyph->bitmap_left;
 	glyph.yOffset = _ascent - _face->glyph->bitmap_top;
@@ -783,25 +1113,25 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		glyph.advance += 1;
 
 		if (FT_GlyphSlot_Own_Bitmap(_face->glyph))
-			return false;
+			return nullptr;
 
 		// That's 26.6 fixed-point units
 		if (FT_Bitmap_Embolden(_face->glyph->library, &_face->glyph->bitmap, 1 << 6, 0))
-			return false;
+			return nullptr;
 
 		bitmap = &_face->glyph->bitmap;
 #elif FAKE_BOLD >= 1
 		FT_Bitmap_New(&ownBitmap);
 
 		if (FT_Bitmap_Copy(_face->glyph->library, &_face->glyph->bitmap, &ownBitmap))
-			return false;
+			return nullptr;
 
 		// Embolden by 1 pixel in x and 0 in y
 		glyph.advance += 1;
 
 		// That's 26.6 fixed-point units
 		if (FT_Bitmap_Embolden(_face->glyph->library, &ownBitmap, 1 << 6, 0))
-			return false;
+			return nullptr;
 
 		bitmap = &ownBitmap;
 #else
@@ -813,7 +1143,8 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 
 
-	glyph.image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
+	Surface image;
+	image.create(bitmap->width, bitmap->rows, PixelFormat::createFormatCLUT8());
 
 	const uint8 *src = bitmap->buffer;
 	int srcPitch = bitmap->pitch;
@@ -822,7 +1153,7 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 		srcPitch = -srcPitch;
 	}
 
-	uint8 *dst = (uint8 *)glyph.image.getPixels();
+	uint8 *dst = (uint8 *)image.getPixels();
 
 	switch (bitmap->pixel_mode) {
 	case FT_PIXEL_MODE_MONO:
@@ -848,15 +1179,15 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	case FT_PIXEL_MODE_GRAY:
 		for (int y = 0; y < (int)bitmap->rows; ++y) {
 			memcpy(dst, src, bitmap->width);
-			dst += glyph.image.pitch;
+			dst += image.pitch;
 			src += srcPitch;
 		}
 		break;
 
 	default:
-		warning("TTFFont::cacheGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
-		glyph.image.free();
-		return false;
+		warning("TTFFont::renderGlyph: Unsupported pixel mode %d", bitmap->pixel_mode);
+		image.free();
+		return nullptr;
 	}
 
 #if FAKE_BOLD == 1
@@ -865,18 +1196,26 @@ bool TTFFont::cacheGlyph(Glyph &glyph, uint32 chr) const {
 	}
 #endif
 
-	return true;
+	const TTFGlyphAtlas::Entry *entry = g_ttf.getGlyphAtlas().add(_faceId, slot, glyph, image);
+	image.free();
+	return entry;
 }
 
-void TTFFont::assureCached(uint32 chr) const {
-	if (!chr || !_allowLateCaching || _glyphs.contains(chr)) {
-		return;
-	}
+TTFFont::Glyph *TTFFont::findGlyph(uint32 chr) const {
+	GlyphCache::iterator glyphEntry = _glyphs.find(chr);
+	if (glyphEntry != _glyphs.end())
+		return &glyphEntry->_value;
+
+	if (!chr || !_allowLateCaching)
+		return nullptr;
 
 	Glyph newGlyph;
-	if (cacheGlyph(newGlyph, chr)) {
-		_glyphs[chr] = newGlyph;
-	}
+	if (!cacheGlyph(newGlyph, chr))
+		return nullptr;
+
+	Glyph &glyph = _glyphs[chr];
+	glyph = newGlyph;
+	return &glyph;
 }
 
 Font *loadTTFFont(Common::SeekableReadStream &stream, int size, TTFSizeMode sizeMode, uint dpi, TTFRenderMode renderMode, const uint32 *mapping, bool stemDarkening) {
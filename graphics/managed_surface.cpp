@@ -696,6 +696,198 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 	delete[] lookup;
 }
 
+/**
+ * Pixel operations for the format combinations transBlitSpecialized() handles.
+ * Each gives the same result as transBlitPixel() does for the settings it was
+ * set up for, without looking at the pixel formats for every pixel.
+ */
+template<typename TSRC, typename TDEST>
+struct TransBlitMapOp {
+	TSRC key;
+	TDEST map[256];
+
+	FORCEINLINE void operator()(TSRC srcVal, TDEST &destVal) const {
+		if (srcVal != key)
+			destVal = map[srcVal];
+	}
+};
+
+template<typename T>
+struct TransBlitCopyOp {
+	T key;
+
+	FORCEINLINE void operator()(T srcVal, T &destVal) const {
+		if (srcVal != key)
+			destVal = srcVal;
+	}
+};
+
+struct TransBlitAlphaOp {
+	uint32 key, keyMask;
+	uint32 srcAlpha;
+	byte srcAShift, srcRShift, srcGShift, srcBShift;
+	byte destAShift, destRShift, destGShift, destBShift;
+
+	FORCEINLINE void operator()(uint32 srcVal, uint32 &destVal) const {
+		if ((srcVal & keyMask) == key)
+			return;
+
+		byte aSrc = srcVal >> srcAShift;
+		byte rSrc = srcVal >> srcRShift;
+		byte gSrc = srcVal >> srcGShift;
+		byte bSrc = srcVal >> srcBShift;
+		if (srcAlpha != 0xff)
+			aSrc = aSrc * srcAlpha / 255;
+
+		byte aDest, rDest, gDest, bDest;
+		if (aSrc == 0) {
+			return;
+		} else if (aSrc == 0xff) {
+			rDest = rSrc;
+			gDest = gSrc;
+			bDest = bSrc;
+			aDest = 0xff;
+		} else {
+			// Same math as transBlitPixel(), so that the results match exactly
+			aDest = destVal >> destAShift;
+			rDest = destVal >> destRShift;
+			gDest = destVal >> destGShift;
+			bDest = destVal >> destBShift;
+			double sAlpha = (double)aSrc / 255.0;
+			double dAlpha = (double)aDest / 255.0;
+			dAlpha *= (1.0 - sAlpha);
+			rDest = static_cast<uint8>((rSrc * sAlpha + rDest * dAlpha) / (sAlpha + dAlpha));
+			gDest = static_cast<uint8>((gSrc * sAlpha + gDest * dAlpha) / (sAlpha + dAlpha));
+			bDest = static_cast<uint8>((bSrc * sAlpha + bDest * dAlpha) / (sAlpha + dAlpha));
+			aDest = static_cast<uint8>(255. * (sAlpha + dAlpha));
+		}
+
+		destVal = ((uint32)aDest << destAShift) | ((uint32)rDest << destRShift) |
+			((uint32)gDest << destGShift) | ((uint32)bDest << destBShift);
+	}
+};
+
+template<typename TSRC, typename TDEST, class PixelOp>
+void transBlitWithOp(const Surface &src, const Common::Rect &srcRect, ManagedSurface &dest, const Common::Rect &destRect,
+		bool flipped, const PixelOp &op) {
+	int scaleX = SCALE_THRESHOLD * srcRect.width() / destRect.width();
+	int scaleY = SCALE_THRESHOLD * srcRect.height() / destRect.height();
+	int left = MAX<int>(destRect.left, 0);
+	int right = MIN<int>(destRect.right, dest.w);
+
+	for (int destY = destRect.top, scaleYCtr = 0; destY < destRect.bottom; ++destY, scaleYCtr += scaleY) {
+		if (destY < 0 || destY >= dest.h)
+			continue;
+		const TSRC *srcLine = (const TSRC *)src.getBasePtr(srcRect.left, scaleYCtr / SCALE_THRESHOLD + srcRect.top);
+		TDEST *destLine = (TDEST *)dest.getBasePtr(0, destY);
+
+		if (flipped) {
+			for (int destX = left, scaleXCtr = (left - destRect.left) * scaleX; destX < right; ++destX, scaleXCtr += scaleX)
+				op(srcLine[src.w - scaleXCtr / SCALE_THRESHOLD - 1], destLine[destX]);
+		} else {
+			for (int destX = left, scaleXCtr = (left - destRect.left) * scaleX; destX < right; ++destX, scaleXCtr += scaleX)
+				op(srcLine[scaleXCtr / SCALE_THRESHOLD], destLine[destX]);
+		}
+	}
+}
+
+static bool hasByteChannels(const PixelFormat &format) {
+	return format.bytesPerPixel == 4 && format.rLoss == 0 && format.gLoss == 0 && format.bLoss == 0 && format.aLoss == 0;
+}
+
+/**
+ * Handles the most common format combinations of transBlitFrom() without
+ * the per pixel checks of transBlit(): CLUT8 to CLUT8, CLUT8 to RGB through
+ * the palette, RGB565 to RGB565 and 32-bit ARGB to 32-bit ARGB with alpha.
+ * The choice is made once for the whole blit, and returns false for anything
+ * transBlit() has to handle.
+ */
+static bool transBlitSpecialized(const Surface &src, const Common::Rect &srcRect, ManagedSurface &dest, const Common::Rect &destRect,
+		uint32 transColor, bool flipped, uint32 overrideColor, uint32 srcAlpha, const byte *srcPalette,
+		const byte *dstPalette) {
+	const PixelFormat &srcFormat = src.format;
+	const PixelFormat &destFormat = dest.format;
+
+	if (srcFormat.bytesPerPixel == 1 && destFormat.bytesPerPixel == 1) {
+		// A transparent srcAlpha leaves transparent destination pixels cleared
+		if (srcAlpha == 0)
+			return false;
+
+		byte *lookup = nullptr;
+		if (srcPalette && dstPalette)
+			lookup = createPaletteLookup(srcPalette, dstPalette);
+
+		TransBlitMapOp<byte, byte> op;
+		op.key = transColor;
+		for (int i = 0; i < 256; i++) {
+			byte color = overrideColor ? overrideColor : i;
+			op.map[i] = lookup ? lookup[color] : color;
+		}
+		delete[] lookup;
+
+		transBlitWithOp<byte, byte>(src, srcRect, dest, destRect, flipped, op);
+		return true;
+	}
+
+	if (srcFormat.isCLUT8() && srcPalette && srcAlpha == 0xff) {
+		if (destFormat.bytesPerPixel == 2) {
+			TransBlitMapOp<byte, uint16> op;
+			op.key = transColor;
+			for (int i = 0; i < 256; i++)
+				op.map[i] = destFormat.ARGBToColor(0xff, srcPalette[i * 3 + 0], srcPalette[i * 3 + 1], srcPalette[i * 3 + 2]);
+
+			transBlitWithOp<byte, uint16>(src, srcRect, dest, destRect, flipped, op);
+			return true;
+		} else if (destFormat.bytesPerPixel == 4) {
+			TransBlitMapOp<byte, uint32> op;
+			op.key = transColor;
+			for (int i = 0; i < 256; i++)
+				op.map[i] = destFormat.ARGBToColor(0xff, srcPalette[i * 3 + 0], srcPalette[i * 3 + 1], srcPalette[i * 3 + 2]);
+
+			transBlitWithOp<byte, uint32>(src, srcRect, dest, destRect, flipped, op);
+			return true;
+		}
+		return false;
+	}
+
+	// Opaque pixels of a format without alpha or unused bits convert back to the same value
+	if (srcFormat.bytesPerPixel == 2 && srcFormat == destFormat && srcAlpha == 0xff &&
+			srcFormat.aBits() == 0 && srcFormat.rBits() + srcFormat.gBits() + srcFormat.bBits() == 16) {
+		TransBlitCopyOp<uint16> op;
+		op.key = transColor;
+
+		transBlitWithOp<uint16, uint16>(src, srcRect, dest, destRect, flipped, op);
+		return true;
+	}
+
+	if (hasByteChannels(srcFormat) && hasByteChannels(destFormat) && !dest.hasTransparentColor()) {
+		TransBlitAlphaOp op;
+
+		// Like transBlit(), a transparent color ignores the alpha of the pixels
+		if (transColor != (uint32)-1 && transColor > 0) {
+			op.keyMask = ~(0xffu << srcFormat.aShift);
+			op.key = transColor & op.keyMask;
+		} else {
+			op.keyMask = 0xffffffff;
+			op.key = transColor;
+		}
+		op.srcAlpha = srcAlpha;
+		op.srcAShift = srcFormat.aShift;
+		op.srcRShift = srcFormat.rShift;
+		op.srcGShift = srcFormat.gShift;
+		op.srcBShift = srcFormat.bShift;
+		op.destAShift = destFormat.aShift;
+		op.destRShift = destFormat.rShift;
+		op.destGShift = destFormat.gShift;
+		op.destBShift = destFormat.bShift;
+
+		transBlitWithOp<uint32, uint32>(src, srcRect, dest, destRect, flipped, op);
+		return true;
+	}
+
+	return false;
+}
+
 #define HANDLE_BLIT(SRC_BYTES, DEST_BYTES, SRC_TYPE, DEST_TYPE) \
 	if (src.format.bytesPerPixel == SRC_BYTES && format.bytesPerPixel == DEST_BYTES) \
 		transBlit<SRC_TYPE, DEST_TYPE>(src, srcRect, *this, destRect, transColor, flipped, overrideColor, srcAlpha, srcPalette, dstPalette, mask, maskOnly); \
@@ -712,6 +904,13 @@ void ManagedSurface::transBlitFromInner(const Surface &src, const Common::Rect &
 			error("Surface::transBlitFrom: mask dimensions do not match src");
 	}
 
+	if (!mask && !maskOnly && transBlitSpecialized(src, srcRect, *this, destRect, transColor, flipped,
+			overrideColor, srcAlpha, srcPalette, dstPalette)) {
+		// Handled without the generic per pixel code
+		addDirtyRect(destRect);
+		return;
+	}
+
 	HANDLE_BLIT(1, 1, uint8,  uint8)
 	HANDLE_BLIT(1, 2, uint8,  uint16)
 	HANDLE_BLIT(1, 4, uint8,  uint32)
@@ -7,6 +7,7 @@ MODULE_OBJS := \
 	blit/blit-generic.o \
 	blit/blit-scale.o \
 	cursorman.o \
+	dirty_region.o \
 	font.o \
 	fontman.o \
 	fonts/amigafont.o \
@@ -52,6 +53,7 @@ MODULE_OBJS := \
 	scaler/thumbnail_intern.o \
 	screen.o \
 	scaler/normal.o \
+	shelf_packer.o \
 	sjis.o \
 	surface.o \
 	svg.o \
@@ -93,7 +95,19 @@ MODULE_OBJS += \
 	tinygl/zmath.o \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
-	tinygl/zdirtyrect.o
+	tinygl/zdirtyrect.o \
+	tinygl/zspan.o
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	tinygl/zspan-neon.o
+$(MODULE)/tinygl/zspan-neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	tinygl/zspan-sse2.o
+$(MODULE)/tinygl/zspan-sse2.o: CXXFLAGS += -msse2
+endif
 endif
 
 ifdef USE_ASPECT
@@ -143,18 +157,24 @@ endif
 
 ifdef SCUMMVM_NEON
 MODULE_OBJS += \
-	blit/blit-neon.o
+	blit/blit-neon.o \
+	yuv_to_rgb-neon.o
 $(MODULE)/blit/blit-neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+$(MODULE)/yuv_to_rgb-neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
 endif
 ifdef SCUMMVM_SSE2
 MODULE_OBJS += \
-	blit/blit-sse2.o
+	blit/blit-sse2.o \
+	yuv_to_rgb-sse2.o
 $(MODULE)/blit/blit-sse2.o: CXXFLAGS += -msse2
+$(MODULE)/yuv_to_rgb-sse2.o: CXXFLAGS += -msse2
 endif
 ifdef SCUMMVM_AVX2
 MODULE_OBJS += \
-	blit/blit-avx2.o
+	blit/blit-avx2.o \
+	yuv_to_rgb-avx2.o
 $(MODULE)/blit/blit-avx2.o: CXXFLAGS += -mavx2
+$(MODULE)/yuv_to_rgb-avx2.o: CXXFLAGS += -mavx2
 endif
 
 # Include common rules
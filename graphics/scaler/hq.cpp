@@ -5079,6 +5079,7 @@ public:
 
 	bool canDrawCursor() const override { return false; }
 	uint extraPixels() const override { return 1; }
+	bool isBandSafe() const override { return true; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
 };
@@ -423,6 +423,7 @@ public:
 
 	bool canDrawCursor() const override { return false; }
 	uint extraPixels() const override { return 2; }
+	bool isBandSafe() const override { return true; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
 };
@@ -479,6 +480,7 @@ public:
 
 	bool canDrawCursor() const override { return false; }
 	uint extraPixels() const override { return 2; }
+	bool isBandSafe() const override { return true; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
 };
@@ -535,6 +537,7 @@ public:
 
 	bool canDrawCursor() const override { return false; }
 	uint extraPixels() const override { return 2; }
+	bool isBandSafe() const override { return true; }
 	const char *getName() const override;
 	const char *getPrettyName() const override;
 };
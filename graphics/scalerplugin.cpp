@@ -20,7 +20,13 @@
 
 #include "graphics/scalerplugin.h"
 
+#include "common/threadpool.h"
+
 namespace {
+// Rects are only split into bands of at least this many rows and pixels
+const int kMinBandHeight = 8;
+const int kMinBandPixels = 64 * 64;
+
 /**
  * Trivial 'scaler' - in fact it doesn't do any scaling but just copies the
  * source to the destination.
@@ -53,10 +59,28 @@ void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 			Normal1x<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 		}
 	} else {
-		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
+		uint numBands = MIN<uint>(_threadCount, MIN(height / kMinBandHeight, width * height / kMinBandPixels));
+		if (numBands > 1)
+			scaleBands(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y, numBands);
+		else
+			scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
 	}
 }
 
+void Scaler::scaleBands(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+                        uint32 dstPitch, int width, int height, int x, int y, uint numBands) {
+	// Each band reads the rows around it from the source just like the whole
+	// rect would, but only writes its own rows of the destination. So the
+	// bands do not depend on each other, and neither does the result on how
+	// the rect has been split.
+	Common::ThreadPool::instance().parallelFor(numBands, [&](uint band) {
+		int top = height * band / numBands;
+		int bottom = height * (band + 1) / numBands;
+		scaleIntern(srcPtr + top * srcPitch, srcPitch, dstPtr + top * _factor * dstPitch, dstPitch,
+		            width, bottom - top, x, y + top);
+	});
+}
+
 SourceScaler::SourceScaler(const Graphics::PixelFormat &format) : Scaler(format), _width(0), _height(0), _oldSrc(NULL), _enable(false) {
 }
 
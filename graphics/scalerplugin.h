@@ -27,7 +27,7 @@
 
 class Scaler {
 public:
-	Scaler(const Graphics::PixelFormat &format) : _format(format) {}
+	Scaler(const Graphics::PixelFormat &format) : _format(format), _threadCount(1) {}
 	virtual ~Scaler() {}
 
 	/**
@@ -72,6 +72,18 @@ public:
 		return oldFactor;
 	}
 
+	/**
+	 * Set the number of threads scale() may use. Large enough rects are then
+	 * split into horizontal bands, which are scaled in parallel on the thread
+	 * pool. Only use this if the plugin of the scaler is band-safe.
+	 *
+	 * @param count The maximum number of bands, or 1 to always scale serially.
+	 * @see ScalerPluginObject::isBandSafe
+	 */
+	void setThreadCount(uint count) { _threadCount = MAX<uint>(count, 1); }
+
+	uint getThreadCount() const { return _threadCount; }
+
 	/**
 	 * Set the source to be used when scaling and copying to the old buffer.
 	 *
@@ -103,6 +115,12 @@ protected:
 
 	uint _factor;
 	Graphics::PixelFormat _format;
+
+private:
+	void scaleBands(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
+	                uint32 dstPitch, int width, int height, int x, int y, uint numBands);
+
+	uint _threadCount;
 };
 
 /**
@@ -199,6 +217,16 @@ public:
 	 */
 	virtual bool useOldSource() const { return false; }
 
+	/**
+	 * Whether the scaler may scale several horizontal bands of a rect at the
+	 * same time. This requires that each output pixel only depends on the
+	 * source pixels within extraPixels() of it, and that scaling does not
+	 * change any state of the scaler instance.
+	 *
+	 * @see Scaler::setThreadCount
+	 */
+	virtual bool isBandSafe() const { return false; }
+
 protected:
 	Common::Array<uint> _factors;
 };
@@ -239,6 +267,13 @@ public:
 	 * Returns whether the supplied mode is one of the old gfx-modes.
 	 */
 	bool isOldGraphicsSetting(const Common::String &gfxMode);
+
+	/**
+	 * Returns the number of threads band-safe scalers should use, as set
+	 * by the "scaler_threads" option. With 0, all threads of the thread
+	 * pool are used.
+	 */
+	uint getThreadCount() const;
 };
 
 /** Convenience shortcut for accessing singleton */
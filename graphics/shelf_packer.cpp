@@ -0,0 +1,148 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "graphics/shelf_packer.h"
+
+#include "common/algorithm.h"
+
+namespace Graphics {
+
+ShelfPacker::ShelfPacker(uint width, uint height, uint maxSize, uint gutter)
+	: _width(width), _height(height), _maxSize(maxSize), _gutter(gutter), _removed(false) {
+}
+
+int ShelfPacker::add(uint width, uint height, Common::Array<Common::Rect> *oldAreas) {
+	if (oldAreas)
+		oldAreas->clear();
+
+	// Repacking can only make room when rectangles were removed or the area
+	// can be grown
+	const bool canRepack = _removed || _width < _maxSize || _height < _maxSize;
+
+	Common::Rect area;
+	if (!place(width, height, area) && (!canRepack || !repack(width, height, area, oldAreas)))
+		return -1;
+
+	uint id = 0;
+	while (id < _rects.size() && _rects[id].used)
+		++id;
+	if (id == _rects.size())
+		_rects.push_back(PackedRect());
+
+	_rects[id].area = area;
+	_rects[id].used = true;
+	return id;
+}
+
+void ShelfPacker::remove(int id) {
+	assert(isUsed(id));
+
+	_rects[id].used = false;
+	_removed = true;
+}
+
+bool ShelfPacker::place(uint width, uint height, Common::Rect &area) {
+	const uint w = width + _gutter;
+	const uint h = height + _gutter;
+
+	// Use the lowest shelf which has enough room left
+	Shelf *best = nullptr;
+	for (uint i = 0; i < _shelves.size(); ++i) {
+		Shelf &shelf = _shelves[i];
+		if (shelf.height >= h && shelf.used + w <= _width && (!best || shelf.height < best->height))
+			best = &shelf;
+	}
+
+	if (!best) {
+		const uint top = _shelves.empty() ? 0 : _shelves.back().top + _shelves.back().height;
+		if (w > _width || top + h > _height)
+			return false;
+
+		Shelf shelf;
+		shelf.top = top;
+		shelf.height = h;
+		shelf.used = 0;
+		_shelves.push_back(shelf);
+		best = &_shelves.back();
+	}
+
+	area = Common::Rect(best->used, best->top, best->used + width, best->top + height);
+	best->used += w;
+	return true;
+}
+
+bool ShelfPacker::repack(uint width, uint height, Common::Rect &area, Common::Array<Common::Rect> *oldAreas) {
+	// Pack the highest rectangles first, which wastes the least space
+	Common::Array<uint> order;
+	for (uint i = 0; i < _rects.size(); ++i) {
+		if (_rects[i].used)
+			order.push_back(i);
+	}
+	Common::sort(order.begin(), order.end(), [this](uint a, uint b) {
+		return _rects[a].area.height() > _rects[b].area.height();
+	});
+
+	const uint oldWidth = _width, oldHeight = _height;
+	const Common::Array<Shelf> oldShelves = _shelves;
+	Common::Array<Common::Rect> areas;
+	areas.resize(order.size());
+
+	// Grow the area until the rectangles fit into it
+	for (;;) {
+		_shelves.clear();
+
+		bool fits = true;
+		for (uint i = 0; fits && i < order.size(); ++i) {
+			const Common::Rect &old = _rects[order[i]].area;
+			fits = place(old.width(), old.height(), areas[i]);
+		}
+		if (fits && place(width, height, area))
+			break;
+
+		if (_width >= _maxSize && _height >= _maxSize) {
+			// Leave everything as it was
+			_width = oldWidth;
+			_height = oldHeight;
+			_shelves = oldShelves;
+			return false;
+		}
+
+		if (_width <= _height && _width < _maxSize)
+			_width = MIN(_width * 2, _maxSize);
+		else
+			_height = MIN(_height * 2, _maxSize);
+	}
+
+	if (oldAreas) {
+		oldAreas->resize(_rects.size());
+		for (uint i = 0; i < _rects.size(); ++i)
+			(*oldAreas)[i] = _rects[i].area;
+	}
+
+	for (uint i = 0; i < order.size(); ++i)
+		_rects[order[i]].area = areas[i];
+	_removed = false;
+
+	return true;
+}
+
+} // End of namespace Graphics
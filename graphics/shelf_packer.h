@@ -0,0 +1,117 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_SHELF_PACKER_H
+#define GRAPHICS_SHELF_PACKER_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_shelf_packer Shelf packer
+ * @ingroup graphics
+ *
+ * @brief Packing of rectangles into a texture atlas.
+ *
+ * @{
+ */
+
+/**
+ * Places rectangles, e.g. the sprites of a texture atlas, into an area.
+ *
+ * The rectangles are packed into shelves, rows which are as high as the
+ * highest rectangle put into them. Space of removed rectangles is only
+ * reclaimed when everything is repacked, which happens when a rectangle
+ * does not fit anymore. The area is grown up to a maximum size when
+ * repacking alone does not make room. Rectangles are never moved while
+ * none were removed and the area is at its maximum size.
+ */
+class ShelfPacker {
+public:
+	/**
+	 * @param width   Initial width of the area.
+	 * @param height  Initial height of the area.
+	 * @param maxSize Maximum width and height the area is grown to.
+	 * @param gutter  Space left to the right of and below every rectangle.
+	 */
+	ShelfPacker(uint width, uint height, uint maxSize, uint gutter);
+
+	uint getWidth() const { return _width; }
+	uint getHeight() const { return _height; }
+
+	/**
+	 * Add a rectangle. This does not change the ids of the other rectangles,
+	 * but may move them when they are repacked.
+	 *
+	 * @param width    Width of the rectangle.
+	 * @param height   Height of the rectangle.
+	 * @param oldAreas If not null, this is set to the areas all rectangles had
+	 *                 before they were repacked, indexed by their id. It is
+	 *                 left empty if they were not moved.
+	 * @return The id of the rectangle, or -1 if it does not fit into the area
+	 *         of the maximum size. The area is left as it was then.
+	 */
+	int add(uint width, uint height, Common::Array<Common::Rect> *oldAreas = nullptr);
+
+	/** Remove a rectangle. Its id may be handed out again. */
+	void remove(int id);
+
+	/** The area of a rectangle. */
+	const Common::Rect &getArea(int id) const { return _rects[id].area; }
+
+	/** Whether the id refers to a rectangle which was not removed. */
+	bool isUsed(int id) const { return id >= 0 && (uint)id < _rects.size() && _rects[id].used; }
+
+	/** One more than the highest id handed out so far. */
+	uint getIdCount() const { return _rects.size(); }
+
+private:
+	struct PackedRect {
+		Common::Rect area;
+		bool used;
+	};
+
+	struct Shelf {
+		uint top;
+		uint height;
+		uint used;
+	};
+
+	bool place(uint width, uint height, Common::Rect &area);
+	bool repack(uint width, uint height, Common::Rect &area, Common::Array<Common::Rect> *oldAreas);
+
+	uint _width, _height;
+	uint _maxSize;
+	uint _gutter;
+	bool _removed;
+
+	Common::Array<PackedRect> _rects;
+	Common::Array<Shelf> _shelves;
+};
+
+/** @} */
+
+} // End of namespace Graphics
+
+#endif
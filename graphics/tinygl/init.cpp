@@ -153,6 +153,7 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	stencil_buffer_supported = enableStencilBuffer;
 
 	fb = new TinyGL::FrameBuffer(screenW, screenH, pixelFormat, enableStencilBuffer);
+	initZSpanFuncs();
 	renderRect = Common::Rect(0, 0, screenW, screenH);
 
 	if ((textureSize & (textureSize - 1)))
@@ -353,6 +354,7 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_drawCallAllocator[1].initialize(drawCallMemorySize);
 	_debugRectsEnabled = false;
 	_profilingEnabled = false;
+	_threadCount = 0;
 
 	TinyGL::Internal::tglBlitResetScissorRect();
 }
@@ -360,6 +362,7 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 void GLContext::deinit() {
 	disposeDrawCallLists();
 	disposeResources();
+	disposeTileContexts();
 
 	specbuf_cleanup();
 	for (int i = 0; i < 3; i++)
@@ -37,6 +37,12 @@ ContextHandle *createContext(int screenW, int screenH, Graphics::PixelFormat pix
 void destroyContext();
 void destroyContext(ContextHandle *handle);
 void setContext(ContextHandle *handle);
+/**
+ * Set the number of threads that rasterize the tiles of a frame of the current
+ * context. This only applies to contexts with dirty rectangles enabled. With 0,
+ * all threads of Common::ThreadPool are used.
+ */
+void setThreadCount(uint count);
 void presentBuffer();
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas);
 void getSurfaceRef(Graphics::Surface &surface);
@@ -53,12 +53,40 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_offscreenBuffer.pbuf = _pbuf;
 	_offscreenBuffer.zbuf = _zbuf;
 
+	_ownsBuffers = true;
+
+	_currentTexture = nullptr;
+
+	_enableScissor = false;
+}
+
+FrameBuffer::FrameBuffer(const FrameBuffer *target) {
+	_pbufWidth = target->_pbufWidth;
+	_pbufHeight = target->_pbufHeight;
+	_pbufFormat = target->_pbufFormat;
+	_pbufBpp = target->_pbufBpp;
+	_pbufPitch = target->_pbufPitch;
+
+	_pbuf = target->_pbuf;
+	_zbuf = target->_zbuf;
+	_sbuf = target->_sbuf;
+	_ownsBuffers = false;
+
+	_offscreenBuffer.pbuf = _pbuf;
+	_offscreenBuffer.zbuf = _zbuf;
+
+	_textureSize = target->_textureSize;
+	_textureSizeMask = target->_textureSizeMask;
+
 	_currentTexture = nullptr;
 
 	_enableScissor = false;
 }
 
 FrameBuffer::~FrameBuffer() {
+	if (!_ownsBuffers)
+		return;
+
 	gl_free(_pbuf);
 	gl_free(_zbuf);
 	if (_sbuf)
@@ -30,6 +30,7 @@
 
 #include "graphics/surface.h"
 #include "graphics/tinygl/texelbuffer.h"
+#include "graphics/tinygl/zspan.h"
 #include "graphics/tinygl/gl.h"
 
 #include "common/rect.h"
@@ -104,6 +105,12 @@ struct ZBufferPoint {
 
 struct FrameBuffer {
 	FrameBuffer(int width, int height, const Graphics::PixelFormat &format, bool enableStencilBuffer);
+	/**
+	 * Creates a frame buffer that draws into the buffers of another one, which
+	 * keeps owning them. The rendering state is separate, so that several
+	 * threads can rasterize different tiles of a frame at the same time.
+	 */
+	explicit FrameBuffer(const FrameBuffer *target);
 	~FrameBuffer();
 
 	Graphics::PixelFormat getPixelFormat() {
@@ -372,6 +379,14 @@ private:
 	template <bool kDepthWrite, bool kEnableScissor, bool kStencilEnabled, bool kDepthTestEnabled>
 	void putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &z, int &dzdx);
 
+	ZSpanFunc getSpanFunc(bool textured, bool blending, bool depthTest, bool depthWrite, ZSpanParams &params) const;
+
+	template <bool kSmoothMode, bool kEnableScissor, bool kTextured>
+	void fillSpan(ZSpanFunc spanFunc, const ZSpanParams &spanParams, const TexelBuffer *texture,
+	              int fbOffset, uint *pz, int x, int count, uint &z, int &t, int &s,
+	              uint &r, uint &g, uint &b, uint &a,
+	              int dzdx, int dsdx, int dtdx, int drdx, int dgdx, int dbdx, int dadx);
+
 
 	template <bool kEnableAlphaTest>
 	FORCEINLINE void writePixel(int pixel, int value) {
@@ -750,6 +765,7 @@ private:
 
 	uint *_zbuf;
 	byte *_sbuf;
+	bool _ownsBuffers;
 
 	bool _enableStencil;
 	int _textureSize;
@@ -25,6 +25,7 @@
 
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/threadpool.h"
 
 namespace TinyGL {
 
@@ -56,6 +57,11 @@ void GLContext::debugDrawRectangle(Common::Rect rect, int r, int g, int b) {
 	}
 }
 
+// Height of the tiles executeDrawCallsTiled() splits the frame buffer into. The tiles span
+// the whole width, as the triangle rasterizer skips the lines outside of the scissor
+// rectangle, but still walks the pixels of the lines inside of it.
+static const int kTileHeight = 32;
+
 struct DirtyRectangle {
 	Common::Rect rectangle;
 	int r, g, b;
@@ -188,18 +194,19 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 	}
 
 	if (!rectangles.empty()) {
+		Common::Array<Common::Rect> dirtyRegions;
 		for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
 			dirtyAreas.push_back((*itRect).rectangle);
+			dirtyRegions.push_back((*itRect).rectangle);
 		}
 
 		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
-				}
+		uint numThreads = _threadCount ? _threadCount : Common::ThreadPool::instance().getThreadCount();
+		if (numThreads > 1 && !_profilingEnabled && render_mode != TGL_SELECT) {
+			executeDrawCallsTiled(dirtyRegions, numThreads);
+		} else {
+			for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+				executeDrawCall(**it, dirtyRegions);
 			}
 		}
 
@@ -235,6 +242,108 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 	_drawCallAllocator[_currentAllocatorIndex].reset();
 }
 
+void GLContext::executeDrawCall(const DrawCall &drawCall, const Common::Array<Common::Rect> &dirtyRegions) {
+	Common::Rect drawCallRegion = drawCall.getDirtyRegion();
+	for (uint i = 0; i < dirtyRegions.size(); i++) {
+		if (dirtyRegions[i].intersects(drawCallRegion)) {
+			drawCall.execute(dirtyRegions[i], true);
+		}
+	}
+}
+
+struct TileDrawCall {
+	const DrawCall *drawCall;
+	Common::Rect clippingRectangle;
+
+	TileDrawCall(const DrawCall *call, const Common::Rect &rect) : drawCall(call), clippingRectangle(rect) {}
+};
+
+void GLContext::executeDrawCallsTiled(const Common::Array<Common::Rect> &dirtyRegions, uint numThreads) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+
+	const int numTiles = (renderRect.height() + kTileHeight - 1) / kTileHeight;
+	const uint numWorkers = MIN<uint>(numThreads, numTiles);
+
+	while (_tileContexts.size() < numWorkers) {
+		GLContext *tileContext = new GLContext();
+		tileContext->vertex_max = POLYGON_MAX_VERTEX;
+		tileContext->vertex = (GLVertex *)gl_malloc(POLYGON_MAX_VERTEX * sizeof(GLVertex));
+		_tileContexts.push_back(tileContext);
+	}
+
+	// The workers share the frame buffer, and the context state that the draw calls don't capture
+	for (uint i = 0; i < numWorkers; i++) {
+		GLContext *tileContext = _tileContexts[i];
+		tileContext->fb = new FrameBuffer(fb);
+		tileContext->renderRect = renderRect;
+		tileContext->_textureSize = _textureSize;
+		tileContext->render_mode = render_mode;
+		tileContext->current_cull_face = current_cull_face;
+		tileContext->vertex_n = vertex_n;
+		tileContext->_profilingEnabled = false;
+	}
+
+	Common::Array<Common::Array<TileDrawCall> > tiles(numTiles);
+	DrawCallIterator it = _drawCallsQueue.begin();
+	while (it != _drawCallsQueue.end()) {
+		// Bin the draw calls up to the next one that needs the whole frame buffer. The draw
+		// calls only touch the pixels of their dirty region, so intersecting it with the
+		// dirty regions and the tiles gives the same result as the serial path.
+		bool binned = false;
+		for (; it != _drawCallsQueue.end() && (*it)->isTileSafe(); ++it) {
+			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+			for (uint i = 0; i < dirtyRegions.size(); i++) {
+				if (!dirtyRegions[i].intersects(drawCallRegion)) {
+					continue;
+				}
+
+				Common::Rect area = dirtyRegions[i].findIntersectingRect(drawCallRegion);
+				int firstTile = (area.top - renderRect.top) / kTileHeight;
+				int lastTile = (area.bottom - 1 - renderRect.top) / kTileHeight;
+				for (int tile = firstTile; tile <= lastTile; tile++) {
+					Common::Rect tileRect(renderRect.left, renderRect.top + tile * kTileHeight,
+					                      renderRect.right, MIN<int>(renderRect.top + (tile + 1) * kTileHeight, renderRect.bottom));
+					tiles[tile].push_back(TileDrawCall(*it, dirtyRegions[i].findIntersectingRect(tileRect)));
+				}
+				binned = true;
+			}
+		}
+
+		if (binned) {
+			Common::ThreadPool::instance().parallelFor(numWorkers, [&](uint worker) {
+				GLContext *tileContext = _tileContexts[worker];
+				for (uint tile = worker; tile < tiles.size(); tile += numWorkers) {
+					for (uint i = 0; i < tiles[tile].size(); i++) {
+						tiles[tile][i].drawCall->executeTile(tileContext, tiles[tile][i].clippingRectangle);
+					}
+				}
+			});
+
+			for (uint tile = 0; tile < tiles.size(); tile++) {
+				tiles[tile].clear();
+			}
+		}
+
+		if (it != _drawCallsQueue.end()) {
+			executeDrawCall(**it, dirtyRegions);
+			++it;
+		}
+	}
+
+	for (uint i = 0; i < numWorkers; i++) {
+		delete _tileContexts[i]->fb;
+		_tileContexts[i]->fb = nullptr;
+	}
+}
+
+void GLContext::disposeTileContexts() {
+	for (uint i = 0; i < _tileContexts.size(); i++) {
+		gl_free(_tileContexts[i]->vertex);
+		delete _tileContexts[i];
+	}
+	_tileContexts.clear();
+}
+
 void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
 
@@ -261,6 +370,10 @@ void presentBuffer(Common::List<Common::Rect> &dirtyAreas) {
 	}
 }
 
+void setThreadCount(uint count) {
+	gl_get_context()->_threadCount = count;
+}
+
 void presentBuffer() {
 	Common::List<Common::Rect> dirtyAreas;
 	presentBuffer(dirtyAreas);
@@ -286,6 +399,10 @@ bool DrawCall::operator==(const DrawCall &other) const {
 	}
 }
 
+void DrawCall::executeTile(GLContext *c, const Common::Rect &clippingRectangle) const {
+	error("DrawCall::executeTile: Draw call type %d can't be executed on a tile", _type);
+}
+
 
 RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization) {
 	GLContext *c = gl_get_context();
@@ -340,13 +457,24 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	if (restoreState) {
 		backupState = captureState();
 	}
-	applyState(_state);
+	applyState(c, _state);
 
 	GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
 	c->vertex = _vertex;
 	c->vertex_cnt = _vertexCount;
+	rasterize(c);
+
+	c->vertex = prevVertex;
+	c->vertex_cnt = prevVertexCount;
+
+	if (restoreState) {
+		applyState(c, backupState);
+	}
+}
+
+void RasterizationDrawCall::rasterize(GLContext *c) const {
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
 
@@ -399,11 +527,17 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 		break;
 	case TGL_QUADS:
 		for(int i = 0; i < cnt; i += 4) {
+			// Draw calls get executed again for every dirty rectangle and compared with the
+			// ones of the next frame, so leave the edge flags as they were
+			int edgeFlag0 = c->vertex[i + 0].edge_flag;
+			int edgeFlag2 = c->vertex[i + 2].edge_flag;
 			c->vertex[i + 2].edge_flag = 0;
 			c->gl_draw_triangle(&c->vertex[i], &c->vertex[i + 1], &c->vertex[i + 2]);
 			c->vertex[i + 2].edge_flag = 1;
 			c->vertex[i + 0].edge_flag = 0;
 			c->gl_draw_triangle(&c->vertex[i], &c->vertex[i + 2], &c->vertex[i + 3]);
+			c->vertex[i + 0].edge_flag = edgeFlag0;
+			c->vertex[i + 2].edge_flag = edgeFlag2;
 		}
 		break;
 	case TGL_QUAD_STRIP:
@@ -424,13 +558,6 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	default:
 		error("glBegin: type %x not handled", c->begin_type);
 	}
-
-	c->vertex = prevVertex;
-	c->vertex_cnt = prevVertexCount;
-
-	if (restoreState) {
-		applyState(backupState);
-	}
 }
 
 RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
@@ -484,8 +611,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	GLContext *c = gl_get_context();
+void RasterizationDrawCall::applyState(GLContext *c, const RasterizationDrawCall::RasterizationState &state) const {
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableAlphaTest(state.alphaTestEnabled);
@@ -553,6 +679,33 @@ void RasterizationDrawCall::execute(const Common::Rect &clippingRectangle, bool
 	c->fb->resetScissorRectangle();
 }
 
+bool RasterizationDrawCall::isTileSafe() const {
+	// Quad strips consume their vertices, and selection doesn't rasterize anything
+	return _state.beginType != TGL_QUAD_STRIP &&
+		_drawTriangleFront != &GLContext::gl_draw_triangle_select &&
+		_drawTriangleBack != &GLContext::gl_draw_triangle_select;
+}
+
+void RasterizationDrawCall::executeTile(GLContext *c, const Common::Rect &clippingRectangle) const {
+	applyState(c, _state);
+
+	// Clipping writes to the vertices, so every worker needs its own copy
+	if (c->vertex_max < _vertexCount) {
+		gl_free(c->vertex);
+		c->vertex_max = _vertexCount;
+		c->vertex = (GLVertex *)gl_malloc(sizeof(GLVertex) * c->vertex_max);
+	}
+	GLVertex *vertex = c->vertex;
+	memcpy(vertex, _vertex, sizeof(GLVertex) * _vertexCount);
+	c->vertex_cnt = _vertexCount;
+
+	c->fb->setScissorRectangle(clippingRectangle);
+	rasterize(c);
+	c->fb->resetScissorRectangle();
+
+	c->vertex = vertex;
+}
+
 bool RasterizationDrawCall::operator==(const RasterizationDrawCall &other) const {
 	if (_vertexCount == other._vertexCount &&
 		_drawTriangleFront == other._drawTriangleFront &&
@@ -701,7 +854,10 @@ void ClearBufferDrawCall::execute(bool restoreState) const {
 }
 
 void ClearBufferDrawCall::execute(const Common::Rect &clippingRectangle, bool restoreState) const {
-	TinyGL::GLContext *c = gl_get_context();
+	executeTile(gl_get_context(), clippingRectangle);
+}
+
+void ClearBufferDrawCall::executeTile(GLContext *c, const Common::Rect &clippingRectangle) const {
 	Common::Rect clearRect = clippingRectangle.findIntersectingRect(getDirtyRegion());
 	c->fb->clearRegion(clearRect.left, clearRect.top, clearRect.width(), clearRect.height(),
 	                   _clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue,
@@ -55,6 +55,10 @@ public:
 	}
 	virtual void execute(bool restoreState) const = 0;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const = 0;
+	// Whether the draw call only touches the pixels of its dirty region and can be executed
+	// on the context of a tile worker, see GLContext::executeDrawCallsTiled().
+	virtual bool isTileSafe() const { return false; }
+	virtual void executeTile(GLContext *c, const Common::Rect &clippingRectangle) const;
 	DrawCallType getType() const { return _type; }
 	virtual const Common::Rect getDirtyRegion() const { return _dirtyRegion; }
 protected:
@@ -70,6 +74,8 @@ public:
 	bool operator==(const ClearBufferDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	virtual bool isTileSafe() const { return true; }
+	virtual void executeTile(GLContext *c, const Common::Rect &clippingRectangle) const;
 
 	void *operator new(size_t size) {
 		return Internal::allocateFrame(size);
@@ -89,6 +95,8 @@ public:
 	bool operator==(const RasterizationDrawCall &other) const;
 	virtual void execute(bool restoreState) const;
 	virtual void execute(const Common::Rect &clippingRectangle, bool restoreState) const;
+	virtual bool isTileSafe() const;
+	virtual void executeTile(GLContext *c, const Common::Rect &clippingRectangle) const;
 
 	void *operator new(size_t size) {
 		return Internal::allocateFrame(size);
@@ -151,7 +159,8 @@ private:
 	RasterizationState _state;
 
 	RasterizationState captureState() const;
-	void applyState(const RasterizationState &state) const;
+	void applyState(GLContext *c, const RasterizationState &state) const;
+	void rasterize(GLContext *c) const;
 };
 
 // Encapsulate a blit call: it might execute either a color buffer or z buffer blit.
@@ -463,6 +463,10 @@ struct GLContext {
 	bool _debugRectsEnabled;
 	bool _profilingEnabled;
 
+	// Threads rasterizing the tiles of a frame, see TinyGL::setThreadCount()
+	uint _threadCount;
+	Common::Array<GLContext *> _tileContexts;
+
 	void gl_vertex_transform(GLVertex *v);
 	void gl_calc_fog_factor(GLVertex *v);
 
@@ -519,6 +523,9 @@ public:
 
 	void presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas);
 	void presentBufferSimple(Common::List<Common::Rect> &dirtyAreas);
+	void executeDrawCall(const DrawCall &drawCall, const Common::Array<Common::Rect> &dirtyRegions);
+	void executeDrawCallsTiled(const Common::Array<Common::Rect> &dirtyRegions, uint numThreads);
+	void disposeTileContexts();
 
 	void debugDrawRectangle(Common::Rect rect, int r, int g, int b);
 
@@ -0,0 +1,146 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+#include <arm_neon.h>
+
+#include "graphics/tinygl/zspan.h"
+
+namespace TinyGL {
+
+// The values of four consecutive pixels
+static FORCEINLINE uint32x4_t neon_interpolate(uint start, int delta) {
+	const uint32 values[4] = { start, start + delta, start + delta * 2, start + delta * 3 };
+	return vld1q_u32(values);
+}
+
+// (a * b) >> 8 on 8-bit channels
+static FORCEINLINE uint32x4_t neon_mulChannel(uint32x4_t a, uint32x4_t b) {
+	return vshrq_n_u32(vmulq_u32(a, b), 8);
+}
+
+static FORCEINLINE bool neon_any(uint32x4_t mask) {
+	uint32x2_t half = vorr_u32(vget_low_u32(mask), vget_high_u32(mask));
+	return (vget_lane_u32(half, 0) | vget_lane_u32(half, 1)) != 0;
+}
+
+template<bool kTextured, bool kBlending, int kDepthFunc, bool kDepthWrite>
+static void zSpanNEON(const ZSpan &span, const ZSpanParams &params) {
+	const uint32x4_t byteMask = vdupq_n_u32(0xff);
+	const int32x4_t rShift = vdupq_n_s32(params.rShift);
+	const int32x4_t gShift = vdupq_n_s32(params.gShift);
+	const int32x4_t bShift = vdupq_n_s32(params.bShift);
+	const int32x4_t aShift = vdupq_n_s32(params.aShift);
+	const uint32x4_t alphaMask = vdupq_n_u32(params.alphaMask);
+
+	uint32x4_t z = neon_interpolate(span.z, span.dzdx);
+	uint32x4_t r = neon_interpolate(span.r, span.drdx);
+	uint32x4_t g = neon_interpolate(span.g, span.dgdx);
+	uint32x4_t b = neon_interpolate(span.b, span.dbdx);
+	uint32x4_t a = neon_interpolate(span.a, span.dadx);
+	const uint32x4_t dz = vdupq_n_u32(span.dzdx * 4);
+	const uint32x4_t dr = vdupq_n_u32(span.drdx * 4);
+	const uint32x4_t dg = vdupq_n_u32(span.dgdx * 4);
+	const uint32x4_t db = vdupq_n_u32(span.dbdx * 4);
+	const uint32x4_t da = vdupq_n_u32(span.dadx * 4);
+
+	int i = 0;
+	for (; i + 4 <= span.count; i += 4) {
+		uint32x4_t zDst = vld1q_u32(span.zbuf + i);
+
+		uint32x4_t mask;
+		if (kDepthFunc == kZSpanDepthLess)
+			mask = vcltq_u32(zDst, z);
+		else if (kDepthFunc == kZSpanDepthLessEqual)
+			mask = vcleq_u32(zDst, z);
+		else
+			mask = vdupq_n_u32(0xffffffff);
+
+		if (neon_any(mask)) {
+			uint32x4_t cr = vshrq_n_u32(r, 8);
+			uint32x4_t cg = vshrq_n_u32(g, 8);
+			uint32x4_t cb = vshrq_n_u32(b, 8);
+			uint32x4_t ca = vshrq_n_u32(a, 8);
+			if (kTextured) {
+				uint32x4_t texels = vld1q_u32(span.texels + i);
+				cr = neon_mulChannel(vandq_u32(vshrq_n_u32(texels, 16), byteMask), cr);
+				cg = neon_mulChannel(vandq_u32(vshrq_n_u32(texels, 8), byteMask), cg);
+				cb = neon_mulChannel(vandq_u32(texels, byteMask), cb);
+				ca = neon_mulChannel(vshrq_n_u32(texels, 24), ca);
+			}
+			cr = vandq_u32(cr, byteMask);
+			cg = vandq_u32(cg, byteMask);
+			cb = vandq_u32(cb, byteMask);
+			ca = vandq_u32(ca, byteMask);
+
+			uint32x4_t dst = vld1q_u32(span.pbuf + i);
+			uint32x4_t pixels;
+			if (!kBlending) {
+				pixels = vorrq_u32(vorrq_u32(vshlq_u32(cr, rShift), vshlq_u32(cg, gShift)),
+				                   vorrq_u32(vshlq_u32(cb, bShift), vandq_u32(vshlq_u32(ca, aShift), alphaMask)));
+			} else {
+				const uint32x4_t invAlpha = vsubq_u32(byteMask, ca);
+				uint32x4_t fr = vaddq_u32(neon_mulChannel(cr, ca), neon_mulChannel(vandq_u32(vshlq_u32(dst, vnegq_s32(rShift)), byteMask), invAlpha));
+				uint32x4_t fg = vaddq_u32(neon_mulChannel(cg, ca), neon_mulChannel(vandq_u32(vshlq_u32(dst, vnegq_s32(gShift)), byteMask), invAlpha));
+				uint32x4_t fb = vaddq_u32(neon_mulChannel(cb, ca), neon_mulChannel(vandq_u32(vshlq_u32(dst, vnegq_s32(bShift)), byteMask), invAlpha));
+				pixels = vorrq_u32(vorrq_u32(vshlq_u32(vminq_u32(fr, byteMask), rShift), vshlq_u32(vminq_u32(fg, byteMask), gShift)),
+				                   vorrq_u32(vshlq_u32(vminq_u32(fb, byteMask), bShift), alphaMask));
+			}
+			vst1q_u32(span.pbuf + i, vbslq_u32(mask, pixels, dst));
+
+			// The per pixel code passes the depth as a float
+			if (kDepthWrite)
+				vst1q_u32(span.zbuf + i, vbslq_u32(mask, vcvtq_u32_f32(vcvtq_f32_u32(z)), zDst));
+		}
+
+		z = vaddq_u32(z, dz);
+		r = vaddq_u32(r, dr);
+		g = vaddq_u32(g, dg);
+		b = vaddq_u32(b, db);
+		a = vaddq_u32(a, da);
+	}
+
+	if (i < span.count) {
+		ZSpan rest = span;
+		rest.pbuf += i;
+		rest.zbuf += i;
+		if (kTextured)
+			rest.texels += i;
+		rest.count -= i;
+		rest.z += span.dzdx * i;
+		rest.r += span.drdx * i;
+		rest.g += span.dgdx * i;
+		rest.b += span.dbdx * i;
+		rest.a += span.dadx * i;
+		zSpanGeneric<kTextured, kBlending, kDepthFunc, kDepthWrite>(rest, params);
+	}
+}
+
+const ZSpanFuncs zSpanFuncsNEON = {{
+	{ ZSPAN_FUNCS(zSpanNEON, false, false), ZSPAN_FUNCS(zSpanNEON, false, true) },
+	{ ZSPAN_FUNCS(zSpanNEON, true, false), ZSPAN_FUNCS(zSpanNEON, true, true) }
+}};
+
+} // end of namespace TinyGL
+
+#endif
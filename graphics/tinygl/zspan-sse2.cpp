@@ -0,0 +1,147 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include <immintrin.h>
+
+#include "graphics/tinygl/zspan.h"
+
+namespace TinyGL {
+
+// The values of four consecutive pixels
+static FORCEINLINE __m128i sse2_interpolate(uint start, int delta) {
+	return _mm_set_epi32(start + delta * 3, start + delta * 2, start + delta, start);
+}
+
+// Multiply 32-bit lanes holding values below 2^16 whose products also fit
+// in 16 bits, which is what (a * b) >> 8 on 8-bit channels needs
+static FORCEINLINE __m128i sse2_mulChannel(__m128i a, __m128i b) {
+	return _mm_srli_epi32(_mm_mullo_epi16(a, b), 8);
+}
+
+template<bool kTextured, bool kBlending, int kDepthFunc, bool kDepthWrite>
+static void zSpanSSE2(const ZSpan &span, const ZSpanParams &params) {
+	if (kDepthWrite && !zSpanDepthFitsInt32(span)) {
+		zSpanGeneric<kTextured, kBlending, kDepthFunc, kDepthWrite>(span, params);
+		return;
+	}
+
+	const __m128i byteMask = _mm_set1_epi32(0xff);
+	const __m128i signBit = _mm_set1_epi32((int)0x80000000);
+	const __m128i rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(params.bShift);
+	const __m128i aShift = _mm_cvtsi32_si128(params.aShift);
+	const __m128i alphaMask = _mm_set1_epi32(params.alphaMask);
+
+	__m128i z = sse2_interpolate(span.z, span.dzdx);
+	__m128i r = sse2_interpolate(span.r, span.drdx);
+	__m128i g = sse2_interpolate(span.g, span.dgdx);
+	__m128i b = sse2_interpolate(span.b, span.dbdx);
+	__m128i a = sse2_interpolate(span.a, span.dadx);
+	const __m128i dz = _mm_set1_epi32(span.dzdx * 4);
+	const __m128i dr = _mm_set1_epi32(span.drdx * 4);
+	const __m128i dg = _mm_set1_epi32(span.dgdx * 4);
+	const __m128i db = _mm_set1_epi32(span.dbdx * 4);
+	const __m128i da = _mm_set1_epi32(span.dadx * 4);
+
+	int i = 0;
+	for (; i + 4 <= span.count; i += 4) {
+		__m128i zDst = _mm_loadu_si128((const __m128i *)(span.zbuf + i));
+
+		// There are no unsigned compares, so flip the sign bits
+		__m128i mask;
+		if (kDepthFunc == kZSpanDepthLess)
+			mask = _mm_cmpgt_epi32(_mm_xor_si128(z, signBit), _mm_xor_si128(zDst, signBit));
+		else if (kDepthFunc == kZSpanDepthLessEqual)
+			mask = _mm_xor_si128(_mm_cmpgt_epi32(_mm_xor_si128(zDst, signBit), _mm_xor_si128(z, signBit)), _mm_set1_epi32(-1));
+		else
+			mask = _mm_set1_epi32(-1);
+
+		if (_mm_movemask_epi8(mask)) {
+			__m128i cr = _mm_srli_epi32(r, 8);
+			__m128i cg = _mm_srli_epi32(g, 8);
+			__m128i cb = _mm_srli_epi32(b, 8);
+			__m128i ca = _mm_srli_epi32(a, 8);
+			if (kTextured) {
+				__m128i texels = _mm_loadu_si128((const __m128i *)(span.texels + i));
+				cr = sse2_mulChannel(_mm_and_si128(_mm_srli_epi32(texels, 16), byteMask), cr);
+				cg = sse2_mulChannel(_mm_and_si128(_mm_srli_epi32(texels, 8), byteMask), cg);
+				cb = sse2_mulChannel(_mm_and_si128(texels, byteMask), cb);
+				ca = sse2_mulChannel(_mm_srli_epi32(texels, 24), ca);
+			}
+			cr = _mm_and_si128(cr, byteMask);
+			cg = _mm_and_si128(cg, byteMask);
+			cb = _mm_and_si128(cb, byteMask);
+			ca = _mm_and_si128(ca, byteMask);
+
+			__m128i dst = _mm_loadu_si128((const __m128i *)(span.pbuf + i));
+			__m128i pixels;
+			if (!kBlending) {
+				pixels = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(cr, rShift), _mm_sll_epi32(cg, gShift)),
+				                      _mm_or_si128(_mm_sll_epi32(cb, bShift), _mm_and_si128(_mm_sll_epi32(ca, aShift), alphaMask)));
+			} else {
+				const __m128i invAlpha = _mm_sub_epi32(byteMask, ca);
+				const __m128i maxValue = byteMask;
+				__m128i fr = _mm_add_epi32(sse2_mulChannel(cr, ca), sse2_mulChannel(_mm_and_si128(_mm_srl_epi32(dst, rShift), byteMask), invAlpha));
+				__m128i fg = _mm_add_epi32(sse2_mulChannel(cg, ca), sse2_mulChannel(_mm_and_si128(_mm_srl_epi32(dst, gShift), byteMask), invAlpha));
+				__m128i fb = _mm_add_epi32(sse2_mulChannel(cb, ca), sse2_mulChannel(_mm_and_si128(_mm_srl_epi32(dst, bShift), byteMask), invAlpha));
+				pixels = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_min_epi16(fr, maxValue), rShift), _mm_sll_epi32(_mm_min_epi16(fg, maxValue), gShift)),
+				                      _mm_or_si128(_mm_sll_epi32(_mm_min_epi16(fb, maxValue), bShift), alphaMask));
+			}
+			_mm_storeu_si128((__m128i *)(span.pbuf + i), _mm_or_si128(_mm_and_si128(mask, pixels), _mm_andnot_si128(mask, dst)));
+
+			// The per pixel code passes the depth as a float
+			if (kDepthWrite) {
+				__m128i zRounded = _mm_cvttps_epi32(_mm_cvtepi32_ps(z));
+				_mm_storeu_si128((__m128i *)(span.zbuf + i), _mm_or_si128(_mm_and_si128(mask, zRounded), _mm_andnot_si128(mask, zDst)));
+			}
+		}
+
+		z = _mm_add_epi32(z, dz);
+		r = _mm_add_epi32(r, dr);
+		g = _mm_add_epi32(g, dg);
+		b = _mm_add_epi32(b, db);
+		a = _mm_add_epi32(a, da);
+	}
+
+	if (i < span.count) {
+		ZSpan rest = span;
+		rest.pbuf += i;
+		rest.zbuf += i;
+		if (kTextured)
+			rest.texels += i;
+		rest.count -= i;
+		rest.z += span.dzdx * i;
+		rest.r += span.drdx * i;
+		rest.g += span.dgdx * i;
+		rest.b += span.dbdx * i;
+		rest.a += span.dadx * i;
+		zSpanGeneric<kTextured, kBlending, kDepthFunc, kDepthWrite>(rest, params);
+	}
+}
+
+const ZSpanFuncs zSpanFuncsSSE2 = {{
+	{ ZSPAN_FUNCS(zSpanSSE2, false, false), ZSPAN_FUNCS(zSpanSSE2, false, true) },
+	{ ZSPAN_FUNCS(zSpanSSE2, true, false), ZSPAN_FUNCS(zSpanSSE2, true, true) }
+}};
+
+} // end of namespace TinyGL
@@ -0,0 +1,52 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/tinygl/zspan.h"
+
+namespace TinyGL {
+
+// Initialize this to nullptr at the start
+const ZSpanFuncs *zSpanFuncs = nullptr;
+
+const ZSpanFuncs zSpanFuncsGeneric = {{
+	{ ZSPAN_FUNCS(zSpanGeneric, false, false), ZSPAN_FUNCS(zSpanGeneric, false, true) },
+	{ ZSPAN_FUNCS(zSpanGeneric, true, false), ZSPAN_FUNCS(zSpanGeneric, true, true) }
+}};
+
+// Select the span fillers when a context is created, so that we can detect
+// at runtime whether or not the cpu has certain SIMD features enabled. This
+// runs on the thread creating the context, before any tiles are drawn by the
+// worker threads.
+void initZSpanFuncs() {
+	if (!zSpanFuncs) {
+		zSpanFuncs = &zSpanFuncsGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) zSpanFuncs = &zSpanFuncsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) zSpanFuncs = &zSpanFuncsSSE2;
+#endif
+	}
+}
+
+} // end of namespace TinyGL
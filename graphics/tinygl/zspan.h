@@ -0,0 +1,162 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZSPAN_H
+#define GRAPHICS_TINYGL_ZSPAN_H
+
+#include "common/scummsys.h"
+#include "common/util.h"
+
+namespace TinyGL {
+
+/**
+ * A run of pixels of a triangle line, for the span fillers. The interpolated
+ * values are the ones of the first pixel, and advance by the deltas on each
+ * pixel like they do in the per pixel code of FrameBuffer::fillTriangle().
+ */
+struct ZSpan {
+	uint32 *pbuf;
+	uint *zbuf;
+	int count;
+
+	uint z, r, g, b, a;
+	int dzdx, drdx, dgdx, dbdx, dadx;
+
+	// The texels of the pixels as 0xAARRGGBB, which get modulated with the
+	// color. Only used by the textured span fillers.
+	const uint32 *texels;
+};
+
+/**
+ * The frame buffer format and state a span filler needs. The span fillers
+ * only handle 32-bit pixels with 8 bits per color channel, and blending
+ * with TGL_SRC_ALPHA and TGL_ONE_MINUS_SRC_ALPHA.
+ */
+struct ZSpanParams {
+	byte rShift, gShift, bShift, aShift;
+	uint32 alphaMask; // Alpha bits of the pixel format, if it has any
+};
+
+enum {
+	kZSpanDepthAlways,
+	kZSpanDepthLess,
+	kZSpanDepthLessEqual,
+	kZSpanDepthFuncCount
+};
+
+typedef void (*ZSpanFunc)(const ZSpan &span, const ZSpanParams &params);
+
+/**
+ * A set of span fillers, indexed by [textured][blending][depth function][depth write].
+ */
+struct ZSpanFuncs {
+	ZSpanFunc fill[2][2][kZSpanDepthFuncCount][2];
+};
+
+extern const ZSpanFuncs zSpanFuncsGeneric;
+#ifdef SCUMMVM_NEON
+extern const ZSpanFuncs zSpanFuncsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+extern const ZSpanFuncs zSpanFuncsSSE2;
+#endif
+
+/**
+ * The span fillers used by the triangle rasterizer. This is selected at
+ * runtime depending on the CPU features by initZSpanFuncs(), and is only
+ * exposed here so that the unit tests can compare the implementations.
+ */
+extern const ZSpanFuncs *zSpanFuncs;
+
+/** Select the span fillers, unless they were already selected. */
+void initZSpanFuncs();
+
+/**
+ * The reference implementation all the SIMD span fillers have to match
+ * exactly. They use it for the pixels that do not fill a whole vector.
+ */
+template<bool kTextured, bool kBlending, int kDepthFunc, bool kDepthWrite>
+static inline void zSpanGeneric(const ZSpan &span, const ZSpanParams &params) {
+	uint z = span.z, r = span.r, g = span.g, b = span.b, a = span.a;
+
+	for (int i = 0; i < span.count; i++) {
+		uint zDst = span.zbuf[i];
+		bool depthTestResult = kDepthFunc == kZSpanDepthAlways ||
+			(kDepthFunc == kZSpanDepthLess && zDst < z) ||
+			(kDepthFunc == kZSpanDepthLessEqual && zDst <= z);
+
+		if (depthTestResult) {
+			byte aSrc = a >> 8, rSrc = r >> 8, gSrc = g >> 8, bSrc = b >> 8;
+			if (kTextured) {
+				uint32 texel = span.texels[i];
+				aSrc = ((texel >> 24) * (a >> 8)) >> 8;
+				rSrc = (((texel >> 16) & 0xff) * (r >> 8)) >> 8;
+				gSrc = (((texel >> 8) & 0xff) * (g >> 8)) >> 8;
+				bSrc = ((texel & 0xff) * (b >> 8)) >> 8;
+			}
+
+			// The per pixel code passes the depth as a float
+			if (kDepthWrite) {
+				span.zbuf[i] = (uint)(float)z;
+			}
+
+			if (!kBlending) {
+				span.pbuf[i] = ((uint32)aSrc << params.aShift & params.alphaMask) |
+					(rSrc << params.rShift) | (gSrc << params.gShift) | (bSrc << params.bShift);
+			} else {
+				uint32 dst = span.pbuf[i];
+				int finalR = ((rSrc * aSrc) >> 8) + ((((dst >> params.rShift) & 0xff) * (255 - aSrc)) >> 8);
+				int finalG = ((gSrc * aSrc) >> 8) + ((((dst >> params.gShift) & 0xff) * (255 - aSrc)) >> 8);
+				int finalB = ((bSrc * aSrc) >> 8) + ((((dst >> params.bShift) & 0xff) * (255 - aSrc)) >> 8);
+				span.pbuf[i] = params.alphaMask | (MIN(finalR, 255) << params.rShift) |
+					(MIN(finalG, 255) << params.gShift) | (MIN(finalB, 255) << params.bShift);
+			}
+		}
+
+		z += span.dzdx;
+		r += span.drdx;
+		g += span.dgdx;
+		b += span.dbdx;
+		a += span.dadx;
+	}
+}
+
+// The fillers of a ZSpanFuncs table for one of its [textured][blending] entries
+#define ZSPAN_FUNCS(func, textured, blending) \
+	{ \
+		{ func<textured, blending, kZSpanDepthAlways, false>, func<textured, blending, kZSpanDepthAlways, true> }, \
+		{ func<textured, blending, kZSpanDepthLess, false>, func<textured, blending, kZSpanDepthLess, true> }, \
+		{ func<textured, blending, kZSpanDepthLessEqual, false>, func<textured, blending, kZSpanDepthLessEqual, true> } \
+	}
+
+/**
+ * Whether the depth of every pixel of the span is below 2^31. The span
+ * fillers convert the depth to a float like the per pixel code, which SSE2
+ * can only do for signed values.
+ */
+static inline bool zSpanDepthFitsInt32(const ZSpan &span) {
+	int64 zEnd = (int64)span.z + (int64)(span.count - 1) * span.dzdx;
+	return span.z < 0x80000000 && zEnd >= 0 && zEnd < 0x80000000;
+}
+
+} // end of namespace TinyGL
+
+#endif
@@ -157,6 +157,96 @@ void FrameBuffer::putPixelDepth(uint *pz, byte *ps, int _a, int x, int y, uint &
 	z += dzdx;
 }
 
+ZSpanFunc FrameBuffer::getSpanFunc(bool textured, bool blending, bool depthTest, bool depthWrite, ZSpanParams &params) const {
+	// The span fillers only handle the most common formats and modes, the
+	// rest goes through the per pixel code
+	if (_pbufBpp != 4 || _pbufFormat.rLoss != 0 || _pbufFormat.gLoss != 0 || _pbufFormat.bLoss != 0 ||
+	    (_pbufFormat.aLoss != 0 && _pbufFormat.aLoss != 8)) {
+		return nullptr;
+	}
+	if (blending && (_sourceBlendingFactor != TGL_SRC_ALPHA || _destinationBlendingFactor != TGL_ONE_MINUS_SRC_ALPHA)) {
+		return nullptr;
+	}
+
+	int depthFunc = kZSpanDepthAlways;
+	if (depthTest) {
+		switch (_depthFunc) {
+		case TGL_LESS:
+			depthFunc = kZSpanDepthLess;
+			break;
+		case TGL_LEQUAL:
+			depthFunc = kZSpanDepthLessEqual;
+			break;
+		case TGL_ALWAYS:
+			break;
+		default:
+			return nullptr;
+		}
+	}
+
+	params.rShift = _pbufFormat.rShift;
+	params.gShift = _pbufFormat.gShift;
+	params.bShift = _pbufFormat.bShift;
+	params.aShift = _pbufFormat.aShift;
+	params.alphaMask = _pbufFormat.aLoss == 0 ? 0xff << _pbufFormat.aShift : 0;
+	return zSpanFuncs->fill[textured][blending][depthFunc][depthWrite];
+}
+
+template <bool kSmoothMode, bool kEnableScissor, bool kTextured>
+void FrameBuffer::fillSpan(ZSpanFunc spanFunc, const ZSpanParams &spanParams, const TexelBuffer *texture,
+                           int fbOffset, uint *pz, int x, int count, uint &z, int &t, int &s,
+                           uint &r, uint &g, uint &b, uint &a,
+                           int dzdx, int dsdx, int dtdx, int drdx, int dgdx, int dbdx, int dadx) {
+	// Like the per pixel code, the interpolated values only advance over the
+	// pixels inside of the scissor rectangle
+	int start = 0;
+	if (kEnableScissor) {
+		start = MAX(_clipRectangle.left - x, 0);
+		count = MIN(count, _clipRectangle.right - x);
+	}
+	count -= start;
+	if (count <= 0) {
+		return;
+	}
+
+	uint32 texels[NB_INTERP];
+	if (kTextured) {
+		assert(count <= NB_INTERP);
+		for (int i = 0; i < count; i++) {
+			uint8 c_a, c_r, c_g, c_b;
+			texture->getARGBAt(_wrapS, _wrapT, s, t, c_a, c_r, c_g, c_b);
+			texels[i] = (c_a << 24) | (c_r << 16) | (c_g << 8) | c_b;
+			s += dsdx;
+			t += dtdx;
+		}
+	}
+
+	ZSpan span;
+	span.pbuf = (uint32 *)_pbuf + fbOffset + start;
+	span.zbuf = pz + start;
+	span.count = count;
+	span.z = z;
+	span.r = r;
+	span.g = g;
+	span.b = b;
+	span.a = a;
+	span.dzdx = dzdx;
+	span.drdx = kSmoothMode ? drdx : 0;
+	span.dgdx = kSmoothMode ? dgdx : 0;
+	span.dbdx = kSmoothMode ? dbdx : 0;
+	span.dadx = kSmoothMode ? dadx : 0;
+	span.texels = texels;
+	spanFunc(span, spanParams);
+
+	z += dzdx * count;
+	if (kSmoothMode) {
+		r += drdx * count;
+		g += dgdx * count;
+		b += dbdx * count;
+		a += dadx * count;
+	}
+}
+
 template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, bool kSmoothMode,
           bool kDepthWrite, bool kFogMode, bool kAlphaTestEnabled, bool kEnableScissor,
           bool kBlendingEnabled, bool kStencilEnabled, bool kDepthTestEnabled>
@@ -325,6 +415,12 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		ndtzdx = NB_INTERP * dtzdx;
 	}
 
+	ZSpanParams spanParams;
+	ZSpanFunc spanFunc = nullptr;
+	if (kInterpRGB && kInterpZ && !kFogMode && !kAlphaTestEnabled && !kStencilEnabled) {
+		spanFunc = getSpanFunc(kInterpST || kInterpSTZ, kBlendingEnabled, kDepthTestEnabled, kDepthWrite, spanParams);
+	}
+
 	if (fz0 > 0) {
 		l1 = p0;
 		l2 = p2;
@@ -424,7 +520,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			if (!kInterpRGB) {
+			if (kEnableScissor && (y < _clipRectangle.top || y >= _clipRectangle.bottom)) {
+				// The whole line is outside of the scissor rectangle, only step the edges
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
@@ -483,6 +581,12 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				if (kStencilEnabled) {
 					ps = ps1 + x1;
 				}
+				if (spanFunc) {
+					int s, t;
+					fillSpan<kSmoothMode, kEnableScissor, false>(spanFunc, spanParams, nullptr, pp, pz, x, n + 1, z, t, s, r, g, b, a,
+					                                             dzdx, 0, 0, drdx, dgdx, dbdx, dadx);
+					n = -1;
+				}
 				while (n >= 3) {
 					putPixelNoTexture<kDepthWrite, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
 					                 (pp, pz, ps, 0, x, y, z, r, g, b, a, dzdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
@@ -557,9 +661,14 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						fz += fndzdx;
 						zinv = (float)(1.0 / fz);
 					}
-					for (int _a = 0; _a < NB_INTERP; _a++) {
-						putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-						               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+					if (spanFunc) {
+						fillSpan<kSmoothMode, kEnableScissor, true>(spanFunc, spanParams, texture, pp, pz, x, NB_INTERP, z, t, s, r, g, b, a,
+						                                            dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+					} else {
+						for (int _a = 0; _a < NB_INTERP; _a++) {
+							putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
+							               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						}
 					}
 					pp += NB_INTERP;
 					if (kInterpZ) {
@@ -584,6 +693,11 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
 				}
 
+				if (spanFunc) {
+					fillSpan<kSmoothMode, kEnableScissor, true>(spanFunc, spanParams, texture, pp, pz, x, n + 1, z, t, s, r, g, b, a,
+					                                            dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx);
+					n = -1;
+				}
 				while (n >= 0) {
 					putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
 					               (pp, texture, _wrapS, _wrapT, pz, ps, 0, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
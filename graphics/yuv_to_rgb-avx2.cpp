@@ -0,0 +1,136 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include <immintrin.h>
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+namespace Graphics {
+
+// Multiply the chroma values by a 0.15 fixed point factor, truncating
+// towards zero like the int16 casts in the color table
+static FORCEINLINE __m256i avx2_mulChroma(__m256i c, int factor) {
+	__m256i abs = _mm256_abs_epi16(c);
+	__m256i prod = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_slli_epi16(abs, 8), _mm256_set1_epi16((short)factor)), 7);
+	return _mm256_sign_epi16(prod, c);
+}
+
+// Clamp the channel values and scale them like the rgbToPix table does
+static FORCEINLINE __m256i avx2_clampChannel(__m256i x, bool ituScale) {
+	if (!ituScale)
+		return _mm256_max_epi16(_mm256_min_epi16(x, _mm256_set1_epi16(255)), _mm256_setzero_si256());
+
+	x = _mm256_max_epi16(_mm256_min_epi16(x, _mm256_set1_epi16(235)), _mm256_set1_epi16(16));
+	x = _mm256_mullo_epi16(_mm256_sub_epi16(x, _mm256_set1_epi16(16)), _mm256_set1_epi16(255));
+	return _mm256_srli_epi16(_mm256_mulhi_epu16(x, _mm256_set1_epi16((short)kYUVToRGBITUFactor)), 7);
+}
+
+// Load sixteen chroma values, or eight that are each used for two pixels
+template<bool halfChroma>
+static FORCEINLINE __m256i avx2_loadChroma(const byte *src) {
+	__m128i c;
+	if (halfChroma) {
+		c = _mm_loadl_epi64((const __m128i *)src);
+		c = _mm_unpacklo_epi8(c, c);
+	} else {
+		c = _mm_loadu_si128((const __m128i *)src);
+	}
+	return _mm256_sub_epi16(_mm256_cvtepu8_epi16(c), _mm256_set1_epi16(128));
+}
+
+// Pack the channels of eight pixels into 32-bit pixels
+static FORCEINLINE __m256i avx2_pack32(__m128i r, __m128i g, __m128i b, __m128i a, const __m128i *shifts, __m256i alphaBits, bool hasAlpha) {
+	__m256i pixels = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(r), shifts[0]), _mm256_sll_epi32(_mm256_cvtepu16_epi32(g), shifts[1])),
+	                                 _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(b), shifts[2]), alphaBits));
+	if (hasAlpha)
+		pixels = _mm256_or_si256(pixels, _mm256_sll_epi32(_mm256_cvtepu16_epi32(a), shifts[3]));
+	return pixels;
+}
+
+/**
+ * Converts sixteen pixels at a time. The loads widen the bytes to 16 bits
+ * across the whole register, so no lane fixups are needed afterwards.
+ */
+template<typename PixelInt, bool halfChroma, bool hasAlpha>
+static void yuvToRGBRowAVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const YUVToRGBParams &params) {
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss);
+	const __m128i aLoss = _mm_cvtsi32_si128(params.aLoss);
+	const __m128i shifts[4] = {
+		_mm_cvtsi32_si128(params.rShift), _mm_cvtsi32_si128(params.gShift),
+		_mm_cvtsi32_si128(params.bShift), _mm_cvtsi32_si128(params.aShift)
+	};
+	const bool ituScale = params.ituScale;
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		__m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + x)));
+		__m256i u = avx2_loadChroma<halfChroma>(uSrc + (halfChroma ? (x >> 1) : x));
+		__m256i v = avx2_loadChroma<halfChroma>(vSrc + (halfChroma ? (x >> 1) : x));
+
+		__m256i r = _mm256_add_epi16(y, avx2_mulChroma(v, kYUVToRGBCrR));
+		__m256i g = _mm256_sub_epi16(y, _mm256_add_epi16(avx2_mulChroma(v, kYUVToRGBCrG), avx2_mulChroma(u, kYUVToRGBCbG)));
+		__m256i b = _mm256_add_epi16(y, avx2_mulChroma(u, kYUVToRGBCbB));
+
+		r = _mm256_srl_epi16(avx2_clampChannel(r, ituScale), rLoss);
+		g = _mm256_srl_epi16(avx2_clampChannel(g, ituScale), gLoss);
+		b = _mm256_srl_epi16(avx2_clampChannel(b, ituScale), bLoss);
+
+		__m256i a = _mm256_setzero_si256();
+		if (hasAlpha)
+			a = _mm256_srl_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(aSrc + x))), aLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			__m256i pixels = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi16(r, shifts[0]), _mm256_sll_epi16(g, shifts[1])),
+			                                 _mm256_or_si256(_mm256_sll_epi16(b, shifts[2]), _mm256_set1_epi16((short)params.alphaBits)));
+			if (hasAlpha)
+				pixels = _mm256_or_si256(pixels, _mm256_sll_epi16(a, shifts[3]));
+			_mm256_storeu_si256((__m256i *)(dst + x * 2), pixels);
+		} else {
+			const __m256i alphaBits = _mm256_set1_epi32(params.alphaBits);
+			__m256i lo = avx2_pack32(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g), _mm256_castsi256_si128(b), _mm256_castsi256_si128(a), shifts, alphaBits, hasAlpha);
+			__m256i hi = avx2_pack32(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1), _mm256_extracti128_si256(b, 1), _mm256_extracti128_si256(a, 1), shifts, alphaBits, hasAlpha);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4), lo);
+			_mm256_storeu_si256((__m256i *)(dst + x * 4 + 32), hi);
+		}
+	}
+
+	if (x < width) {
+		int uvOffset = halfChroma ? (x >> 1) : x;
+		yuvToRGBRowGeneric<PixelInt, halfChroma, hasAlpha>(dst + x * sizeof(PixelInt), ySrc + x, uSrc + uvOffset, vSrc + uvOffset,
+		                                                   hasAlpha ? aSrc + x : aSrc, width - x, params);
+	}
+}
+
+const YUVToRGBFuncs yuvToRGBFuncsAVX2 = {{
+	{
+		{ yuvToRGBRowAVX2<uint16, false, false>, yuvToRGBRowAVX2<uint16, false, true> },
+		{ yuvToRGBRowAVX2<uint16, true, false>, yuvToRGBRowAVX2<uint16, true, true> }
+	},
+	{
+		{ yuvToRGBRowAVX2<uint32, false, false>, yuvToRGBRowAVX2<uint32, false, true> },
+		{ yuvToRGBRowAVX2<uint32, true, false>, yuvToRGBRowAVX2<uint32, true, true> }
+	}
+}};
+
+} // End of namespace Graphics
@@ -0,0 +1,146 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+#include <arm_neon.h>
+
+#include "common/endian.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+namespace Graphics {
+
+// Multiply the high halves of unsigned 16-bit values, like SSE2's mulhi
+static FORCEINLINE uint16x8_t neon_mulhi(uint16x8_t a, uint16x8_t b) {
+	uint32x4_t lo = vmull_u16(vget_low_u16(a), vget_low_u16(b));
+	uint32x4_t hi = vmull_u16(vget_high_u16(a), vget_high_u16(b));
+	return vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16));
+}
+
+// Multiply the chroma values by a 0.15 fixed point factor, truncating
+// towards zero like the int16 casts in the color table
+static FORCEINLINE int16x8_t neon_mulChroma(int16x8_t c, int factor) {
+	uint16x8_t abs = vreinterpretq_u16_s16(vabsq_s16(c));
+	int16x8_t prod = vreinterpretq_s16_u16(vshrq_n_u16(neon_mulhi(vshlq_n_u16(abs, 8), vdupq_n_u16(factor)), 7));
+	return vbslq_s16(vcltq_s16(c, vdupq_n_s16(0)), vnegq_s16(prod), prod);
+}
+
+// Clamp the channel values and scale them like the rgbToPix table does
+static FORCEINLINE uint16x8_t neon_clampChannel(int16x8_t x, bool ituScale) {
+	if (!ituScale)
+		return vreinterpretq_u16_s16(vmaxq_s16(vminq_s16(x, vdupq_n_s16(255)), vdupq_n_s16(0)));
+
+	x = vmaxq_s16(vminq_s16(x, vdupq_n_s16(235)), vdupq_n_s16(16));
+	uint16x8_t d = vmulq_n_u16(vreinterpretq_u16_s16(vsubq_s16(x, vdupq_n_s16(16))), 255);
+	return vshrq_n_u16(neon_mulhi(d, vdupq_n_u16(kYUVToRGBITUFactor)), 7);
+}
+
+// Load eight chroma values, or four that are each used for two pixels
+template<bool halfChroma>
+static FORCEINLINE int16x8_t neon_loadChroma(const byte *src) {
+	uint8x8_t c;
+	if (halfChroma) {
+		c = vreinterpret_u8_u32(vdup_n_u32(READ_UINT32(src)));
+		c = vzip_u8(c, c).val[0];
+	} else {
+		c = vld1_u8(src);
+	}
+	return vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(c)), vdupq_n_s16(128));
+}
+
+/**
+ * Converts eight pixels at a time. The variable channel shifts use vshl,
+ * which shifts to the right for negative counts.
+ */
+template<typename PixelInt, bool halfChroma, bool hasAlpha>
+static void yuvToRGBRowNEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const YUVToRGBParams &params) {
+	const int16x8_t rLoss = vdupq_n_s16(-params.rLoss);
+	const int16x8_t gLoss = vdupq_n_s16(-params.gLoss);
+	const int16x8_t bLoss = vdupq_n_s16(-params.bLoss);
+	const int16x8_t aLoss = vdupq_n_s16(-params.aLoss);
+	const bool ituScale = params.ituScale;
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + x)));
+		int16x8_t u = neon_loadChroma<halfChroma>(uSrc + (halfChroma ? (x >> 1) : x));
+		int16x8_t v = neon_loadChroma<halfChroma>(vSrc + (halfChroma ? (x >> 1) : x));
+
+		int16x8_t r = vaddq_s16(y, neon_mulChroma(v, kYUVToRGBCrR));
+		int16x8_t g = vsubq_s16(y, vaddq_s16(neon_mulChroma(v, kYUVToRGBCrG), neon_mulChroma(u, kYUVToRGBCbG)));
+		int16x8_t b = vaddq_s16(y, neon_mulChroma(u, kYUVToRGBCbB));
+
+		uint16x8_t r16 = vshlq_u16(neon_clampChannel(r, ituScale), rLoss);
+		uint16x8_t g16 = vshlq_u16(neon_clampChannel(g, ituScale), gLoss);
+		uint16x8_t b16 = vshlq_u16(neon_clampChannel(b, ituScale), bLoss);
+
+		uint16x8_t a16 = vdupq_n_u16(0);
+		if (hasAlpha)
+			a16 = vshlq_u16(vmovl_u8(vld1_u8(aSrc + x)), aLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			uint16x8_t pixels = vorrq_u16(vorrq_u16(vshlq_u16(r16, vdupq_n_s16(params.rShift)), vshlq_u16(g16, vdupq_n_s16(params.gShift))),
+			                              vorrq_u16(vshlq_u16(b16, vdupq_n_s16(params.bShift)), vdupq_n_u16(params.alphaBits)));
+			if (hasAlpha)
+				pixels = vorrq_u16(pixels, vshlq_u16(a16, vdupq_n_s16(params.aShift)));
+			vst1q_u16((uint16 *)(dst + x * 2), pixels);
+		} else {
+			const int32x4_t rShift = vdupq_n_s32(params.rShift);
+			const int32x4_t gShift = vdupq_n_s32(params.gShift);
+			const int32x4_t bShift = vdupq_n_s32(params.bShift);
+			const int32x4_t aShift = vdupq_n_s32(params.aShift);
+			const uint32x4_t alphaBits = vdupq_n_u32(params.alphaBits);
+
+			uint32x4_t lo = vorrq_u32(vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(r16)), rShift), vshlq_u32(vmovl_u16(vget_low_u16(g16)), gShift)),
+			                          vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(b16)), bShift), alphaBits));
+			uint32x4_t hi = vorrq_u32(vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(r16)), rShift), vshlq_u32(vmovl_u16(vget_high_u16(g16)), gShift)),
+			                          vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(b16)), bShift), alphaBits));
+			if (hasAlpha) {
+				lo = vorrq_u32(lo, vshlq_u32(vmovl_u16(vget_low_u16(a16)), aShift));
+				hi = vorrq_u32(hi, vshlq_u32(vmovl_u16(vget_high_u16(a16)), aShift));
+			}
+			vst1q_u32((uint32 *)(dst + x * 4), lo);
+			vst1q_u32((uint32 *)(dst + x * 4 + 16), hi);
+		}
+	}
+
+	if (x < width) {
+		int uvOffset = halfChroma ? (x >> 1) : x;
+		yuvToRGBRowGeneric<PixelInt, halfChroma, hasAlpha>(dst + x * sizeof(PixelInt), ySrc + x, uSrc + uvOffset, vSrc + uvOffset,
+		                                                   hasAlpha ? aSrc + x : aSrc, width - x, params);
+	}
+}
+
+const YUVToRGBFuncs yuvToRGBFuncsNEON = {{
+	{
+		{ yuvToRGBRowNEON<uint16, false, false>, yuvToRGBRowNEON<uint16, false, true> },
+		{ yuvToRGBRowNEON<uint16, true, false>, yuvToRGBRowNEON<uint16, true, true> }
+	},
+	{
+		{ yuvToRGBRowNEON<uint32, false, false>, yuvToRGBRowNEON<uint32, false, true> },
+		{ yuvToRGBRowNEON<uint32, true, false>, yuvToRGBRowNEON<uint32, true, true> }
+	}
+}};
+
+} // End of namespace Graphics
+
+#endif // SCUMMVM_NEON
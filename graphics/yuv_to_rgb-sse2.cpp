@@ -0,0 +1,131 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/endian.h"
+#include <immintrin.h>
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+namespace Graphics {
+
+// Multiply the chroma values by a 0.15 fixed point factor, truncating
+// towards zero like the int16 casts in the color table
+static FORCEINLINE __m128i sse2_mulChroma(__m128i c, int factor) {
+	__m128i sign = _mm_srai_epi16(c, 15);
+	__m128i abs = _mm_sub_epi16(_mm_xor_si128(c, sign), sign);
+	__m128i prod = _mm_srli_epi16(_mm_mulhi_epu16(_mm_slli_epi16(abs, 8), _mm_set1_epi16((short)factor)), 7);
+	return _mm_sub_epi16(_mm_xor_si128(prod, sign), sign);
+}
+
+// Clamp the channel values and scale them like the rgbToPix table does
+static FORCEINLINE __m128i sse2_clampChannel(__m128i x, bool ituScale) {
+	if (!ituScale)
+		return _mm_max_epi16(_mm_min_epi16(x, _mm_set1_epi16(255)), _mm_setzero_si128());
+
+	x = _mm_max_epi16(_mm_min_epi16(x, _mm_set1_epi16(235)), _mm_set1_epi16(16));
+	x = _mm_mullo_epi16(_mm_sub_epi16(x, _mm_set1_epi16(16)), _mm_set1_epi16(255));
+	return _mm_srli_epi16(_mm_mulhi_epu16(x, _mm_set1_epi16((short)kYUVToRGBITUFactor)), 7);
+}
+
+// Load eight chroma values, or four that are each used for two pixels
+template<bool halfChroma>
+static FORCEINLINE __m128i sse2_loadChroma(const byte *src) {
+	if (halfChroma) {
+		__m128i c = _mm_cvtsi32_si128(READ_UINT32(src));
+		c = _mm_unpacklo_epi8(c, c);
+		return _mm_sub_epi16(_mm_unpacklo_epi8(c, _mm_setzero_si128()), _mm_set1_epi16(128));
+	}
+
+	return _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128()), _mm_set1_epi16(128));
+}
+
+/**
+ * Converts eight pixels at a time. The channels are computed in 16-bit lanes
+ * and only widened to 32 bits when packing them into the pixel format.
+ */
+template<typename PixelInt, bool halfChroma, bool hasAlpha>
+static void yuvToRGBRowSSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const YUVToRGBParams &params) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rLoss = _mm_cvtsi32_si128(params.rLoss), rShift = _mm_cvtsi32_si128(params.rShift);
+	const __m128i gLoss = _mm_cvtsi32_si128(params.gLoss), gShift = _mm_cvtsi32_si128(params.gShift);
+	const __m128i bLoss = _mm_cvtsi32_si128(params.bLoss), bShift = _mm_cvtsi32_si128(params.bShift);
+	const __m128i aLoss = _mm_cvtsi32_si128(params.aLoss), aShift = _mm_cvtsi32_si128(params.aShift);
+	const bool ituScale = params.ituScale;
+
+	int x = 0;
+	for (; x + 8 <= width; x += 8) {
+		__m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + x)), zero);
+		__m128i u = sse2_loadChroma<halfChroma>(uSrc + (halfChroma ? (x >> 1) : x));
+		__m128i v = sse2_loadChroma<halfChroma>(vSrc + (halfChroma ? (x >> 1) : x));
+
+		__m128i r = _mm_add_epi16(y, sse2_mulChroma(v, kYUVToRGBCrR));
+		__m128i g = _mm_sub_epi16(y, _mm_add_epi16(sse2_mulChroma(v, kYUVToRGBCrG), sse2_mulChroma(u, kYUVToRGBCbG)));
+		__m128i b = _mm_add_epi16(y, sse2_mulChroma(u, kYUVToRGBCbB));
+
+		r = _mm_srl_epi16(sse2_clampChannel(r, ituScale), rLoss);
+		g = _mm_srl_epi16(sse2_clampChannel(g, ituScale), gLoss);
+		b = _mm_srl_epi16(sse2_clampChannel(b, ituScale), bLoss);
+
+		__m128i a = zero;
+		if (hasAlpha)
+			a = _mm_srl_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(aSrc + x)), zero), aLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			__m128i pixels = _mm_or_si128(_mm_or_si128(_mm_sll_epi16(r, rShift), _mm_sll_epi16(g, gShift)),
+			                              _mm_or_si128(_mm_sll_epi16(b, bShift), _mm_set1_epi16((short)params.alphaBits)));
+			if (hasAlpha)
+				pixels = _mm_or_si128(pixels, _mm_sll_epi16(a, aShift));
+			_mm_storeu_si128((__m128i *)(dst + x * 2), pixels);
+		} else {
+			const __m128i alphaBits = _mm_set1_epi32(params.alphaBits);
+			__m128i lo = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), gShift)),
+			                          _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(b, zero), bShift), alphaBits));
+			__m128i hi = _mm_or_si128(_mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), gShift)),
+			                          _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(b, zero), bShift), alphaBits));
+			if (hasAlpha) {
+				lo = _mm_or_si128(lo, _mm_sll_epi32(_mm_unpacklo_epi16(a, zero), aShift));
+				hi = _mm_or_si128(hi, _mm_sll_epi32(_mm_unpackhi_epi16(a, zero), aShift));
+			}
+			_mm_storeu_si128((__m128i *)(dst + x * 4), lo);
+			_mm_storeu_si128((__m128i *)(dst + x * 4 + 16), hi);
+		}
+	}
+
+	if (x < width) {
+		int uvOffset = halfChroma ? (x >> 1) : x;
+		yuvToRGBRowGeneric<PixelInt, halfChroma, hasAlpha>(dst + x * sizeof(PixelInt), ySrc + x, uSrc + uvOffset, vSrc + uvOffset,
+		                                                   hasAlpha ? aSrc + x : aSrc, width - x, params);
+	}
+}
+
+const YUVToRGBFuncs yuvToRGBFuncsSSE2 = {{
+	{
+		{ yuvToRGBRowSSE2<uint16, false, false>, yuvToRGBRowSSE2<uint16, false, true> },
+		{ yuvToRGBRowSSE2<uint16, true, false>, yuvToRGBRowSSE2<uint16, true, true> }
+	},
+	{
+		{ yuvToRGBRowSSE2<uint32, false, false>, yuvToRGBRowSSE2<uint32, false, true> },
+		{ yuvToRGBRowSSE2<uint32, true, false>, yuvToRGBRowSSE2<uint32, true, true> }
+	}
+}};
+
+} // End of namespace Graphics
@@ -82,8 +82,11 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
+#include "common/threadpool.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -202,39 +205,104 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
-#define PUT_PIXEL(s, d) \
-	L = &rgbToPix[(s)]; \
-	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
-
-template<typename PixelInt>
-void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
-	const int16 *Cr_g_tab = Cr_r_tab + 256;
-	const int16 *Cb_g_tab = Cr_g_tab + 256;
-	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->getRGBToPix();
-
-	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < yWidth; w++) {
-			const uint32 *L;
-
-			int16 cr_r  = Cr_r_tab[*vSrc];
-			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
-			int16 cb_b  = Cb_b_tab[*uSrc];
-			++uSrc;
-			++vSrc;
-
-			PUT_PIXEL(*ySrc, dstPtr);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
-		}
+// Initialize this to nullptr at the start
+const YUVToRGBFuncs *yuvToRGBFuncs = nullptr;
+
+const YUVToRGBFuncs yuvToRGBFuncsGeneric = {{
+	{
+		{ yuvToRGBRowGeneric<uint16, false, false>, yuvToRGBRowGeneric<uint16, false, true> },
+		{ yuvToRGBRowGeneric<uint16, true, false>, yuvToRGBRowGeneric<uint16, true, true> }
+	},
+	{
+		{ yuvToRGBRowGeneric<uint32, false, false>, yuvToRGBRowGeneric<uint32, false, true> },
+		{ yuvToRGBRowGeneric<uint32, true, false>, yuvToRGBRowGeneric<uint32, true, true> }
+	}
+}};
+
+// Select the row converters on first use, so that we can detect at runtime
+// whether or not the cpu has certain SIMD features enabled.
+static const YUVToRGBFuncs *getYUVToRGBFuncs() {
+	if (!yuvToRGBFuncs) {
+		yuvToRGBFuncs = &yuvToRGBFuncsGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) yuvToRGBFuncs = &yuvToRGBFuncsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) yuvToRGBFuncs = &yuvToRGBFuncsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) yuvToRGBFuncs = &yuvToRGBFuncsAVX2;
+#endif
+	}
+
+	return yuvToRGBFuncs;
+}
+
+static YUVToRGBParams getParams(const YUVToRGBLookup *lookup, const int16 *colorTab, bool alphaMode) {
+	const Graphics::PixelFormat &format = lookup->getFormat();
+
+	YUVToRGBParams params;
+	params.rgbToPix = lookup->getRGBToPix();
+	params.alphaToPix = lookup->getAlphaToPix();
+	params.colorTab = colorTab;
+	params.ituScale = (lookup->getScale() == YUVToRGBManager::kScaleITU);
+	params.rLoss = format.rLoss;
+	params.gLoss = format.gLoss;
+	params.bLoss = format.bLoss;
+	params.aLoss = format.aLoss;
+	params.rShift = format.rShift;
+	params.gShift = format.gShift;
+	params.bShift = format.bShift;
+	params.aShift = format.aShift;
+	params.alphaBits = alphaMode ? 0 : format.ARGBToColor(255, 0, 0, 0);
+	return params;
+}
+
+static void convertRows(YUVToRGBRowFunc rowFunc, const YUVToRGBParams &params, Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int firstRow, int numRows, int yPitch, int uvPitch, int uvRowShift) {
+	byte *dstPtr = (byte *)dst->getBasePtr(0, firstRow);
+	ySrc += firstRow * yPitch;
+	if (aSrc)
+		aSrc += firstRow * yPitch;
+
+	for (int h = firstRow; h < firstRow + numRows; h++) {
+		int uvOffset = (h >> uvRowShift) * uvPitch;
+		rowFunc(dstPtr, ySrc, uSrc + uvOffset, vSrc + uvOffset, aSrc, yWidth, params);
+
+		dstPtr += dst->pitch;
+		ySrc += yPitch;
+		if (aSrc)
+			aSrc += yPitch;
+	}
+}
 
-		dstPtr += dstPitch - yWidth * sizeof(PixelInt);
-		ySrc += yPitch - yWidth;
-		uSrc += uvPitch - yWidth;
-		vSrc += uvPitch - yWidth;
+// Rows per slice when converting on several threads. This is a multiple of
+// four, so that no chroma row of the subsampled formats spans two slices.
+static const int kSliceHeight = 32;
+
+// Frames smaller than this are not worth waking up the other threads for
+static const int kMinParallelPixels = 320 * 200;
+
+/**
+ * Calls func(firstRow, numRows) for horizontal slices covering all rows of
+ * the frame. Large frames have their slices converted on all CPU cores.
+ */
+template<class F>
+static void forEachSlice(int yWidth, int yHeight, const F &func) {
+	if (yWidth * yHeight < kMinParallelPixels) {
+		func(0, yHeight);
+		return;
 	}
+
+	Common::ThreadPool::instance().parallelFor((yHeight + kSliceHeight - 1) / kSliceHeight, [&](uint slice) {
+		int firstRow = slice * kSliceHeight;
+		func(firstRow, MIN(kSliceHeight, yHeight - firstRow));
+	});
+}
+
+static void convertSlices(YUVToRGBRowFunc rowFunc, const YUVToRGBParams &params, Graphics::Surface *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, int uvRowShift) {
+	forEachSlice(yWidth, yHeight, [&](int firstRow, int numRows) {
+		convertRows(rowFunc, params, dst, ySrc, uSrc, vSrc, aSrc, yWidth, firstRow, numRows, yPitch, uvPitch, uvRowShift);
+	});
 }
 
 void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
@@ -244,48 +312,8 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(ySrc && uSrc && vSrc);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
-
-	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUV444ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-}
-
-template<typename PixelInt>
-void convertYUV422ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	int halfWidth = yWidth >> 1;
-
-	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
-	const int16 *Cr_g_tab = Cr_r_tab + 256;
-	const int16 *Cb_g_tab = Cr_g_tab + 256;
-	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->getRGBToPix();
-
-	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			const uint32 *L;
-
-			int16 cr_r  = Cr_r_tab[*vSrc];
-			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
-			int16 cb_b  = Cb_b_tab[*uSrc];
-			++uSrc;
-			++vSrc;
-
-			PUT_PIXEL(*ySrc, dstPtr);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
-			PUT_PIXEL(*ySrc, dstPtr);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
-		}
-
-		dstPtr += dstPitch - yWidth * sizeof(PixelInt);
-		ySrc += yPitch  - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
-	}
+	YUVToRGBRowFunc rowFunc = getYUVToRGBFuncs()->row[dst->format.bytesPerPixel == 4][0][0];
+	convertSlices(rowFunc, getParams(lookup, _colorTab, false), dst, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 0);
 }
 
 void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
@@ -296,51 +324,8 @@ void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
-
-	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV422ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUV422ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-}
-
-template<typename PixelInt>
-void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	int halfHeight = yHeight >> 1;
-	int halfWidth = yWidth >> 1;
-
-	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
-	const int16 *Cr_g_tab = Cr_r_tab + 256;
-	const int16 *Cb_g_tab = Cr_g_tab + 256;
-	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->getRGBToPix();
-
-	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			const uint32 *L;
-
-			int16 cr_r  = Cr_r_tab[*vSrc];
-			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
-			int16 cb_b  = Cb_b_tab[*uSrc];
-			++uSrc;
-			++vSrc;
-
-			PUT_PIXEL(*ySrc, dstPtr);
-			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
-			PUT_PIXEL(*ySrc, dstPtr);
-			PUT_PIXEL(*(ySrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			dstPtr += sizeof(PixelInt);
-		}
-
-		dstPtr += dstPitch;
-		ySrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
-	}
+	YUVToRGBRowFunc rowFunc = getYUVToRGBFuncs()->row[dst->format.bytesPerPixel == 4][1][0];
+	convertSlices(rowFunc, getParams(lookup, _colorTab, false), dst, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 0);
 }
 
 void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
@@ -352,59 +337,8 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yHeight & 1) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
-
-	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUV420ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-}
-
-#define PUT_PIXELA(s, a, d) \
-	L = &rgbToPix[(s)]; \
-	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b] | aToPix[a])
-
-template<typename PixelInt>
-void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	int halfHeight = yHeight >> 1;
-	int halfWidth = yWidth >> 1;
-
-	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
-	const int16 *Cr_g_tab = Cr_r_tab + 256;
-	const int16 *Cb_g_tab = Cr_g_tab + 256;
-	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->getRGBToPix();
-	const uint32 *aToPix = lookup->getAlphaToPix();
-
-	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			const uint32 *L;
-
-			int16 cr_r  = Cr_r_tab[*vSrc];
-			int16 crb_g = Cr_g_tab[*vSrc] + Cb_g_tab[*uSrc];
-			int16 cb_b  = Cb_b_tab[*uSrc];
-			++uSrc;
-			++vSrc;
-
-			PUT_PIXELA(*ySrc, *aSrc, dstPtr);
-			PUT_PIXELA(*(ySrc + yPitch), *(aSrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			aSrc++;
-			dstPtr += sizeof(PixelInt);
-			PUT_PIXELA(*ySrc, *aSrc, dstPtr);
-			PUT_PIXELA(*(ySrc + yPitch), *(aSrc + yPitch), dstPtr + dstPitch);
-			ySrc++;
-			aSrc++;
-			dstPtr += sizeof(PixelInt);
-		}
-
-		dstPtr += dstPitch;
-		ySrc += (yPitch << 1) - yWidth;
-		aSrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
-	}
+	YUVToRGBRowFunc rowFunc = getYUVToRGBFuncs()->row[dst->format.bytesPerPixel == 4][1][0];
+	convertSlices(rowFunc, getParams(lookup, _colorTab, false), dst, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 1);
 }
 
 void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
@@ -416,82 +350,30 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 	assert((yHeight & 1) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale, true);
-
-	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUVA420ToRGBA<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+	YUVToRGBRowFunc rowFunc = getYUVToRGBFuncs()->row[dst->format.bytesPerPixel == 4][1][1];
+	convertSlices(rowFunc, getParams(lookup, _colorTab, true), dst, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch, 1);
 }
 
-#define READ_QUAD(ptr, prefix) \
-	byte prefix##A = ptr[index]; \
-	byte prefix##B = ptr[index + 1]; \
-	byte prefix##C = ptr[index + uvPitch]; \
-	byte prefix##D = ptr[index + uvPitch + 1]
-
-#define DO_INTERPOLATION(out) \
-	out = (out##A * (4 - xDiff) * (4 - yDiff) + out##B * xDiff * (4 - yDiff) + \
-			out##C * yDiff * (4 - xDiff) + out##D * xDiff * yDiff) >> 4
-
-#define DO_YUV410_PIXEL() \
-	DO_INTERPOLATION(u); \
-	DO_INTERPOLATION(v); \
-	\
-	cr_r  = Cr_r_tab[v]; \
-	crb_g = Cr_g_tab[v] + Cb_g_tab[u]; \
-	cb_b  = Cb_b_tab[u]; \
-	\
-	PUT_PIXEL(*ySrc, dstPtr); \
-	dstPtr += sizeof(PixelInt); \
-	\
-	ySrc++; \
-	xDiff++
-
-template<typename PixelInt>
-void convertYUV410ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	// Keep the tables in pointers here to avoid a dereference on each pixel
-	const int16 *Cr_r_tab = colorTab;
-	const int16 *Cr_g_tab = Cr_r_tab + 256;
-	const int16 *Cb_g_tab = Cr_g_tab + 256;
-	const int16 *Cb_b_tab = Cb_g_tab + 256;
-	const uint32 *rgbToPix = lookup->getRGBToPix();
-
-	int quarterWidth = yWidth >> 2;
-
-	for (int y = 0; y < yHeight; y++) {
-		for (int x = 0; x < quarterWidth; x++) {
-			// Perform bilinear interpolation on the chroma values
-			// Based on the algorithm found here: http://tech-algorithm.com/articles/bilinear-image-scaling/
-			// Feel free to optimize further
-			int targetY = y >> 2;
-			int xDiff = 0;
-			int yDiff = y & 3;
-			int index = targetY * uvPitch + x;
-
-			// Declare some variables for the following macros
-			byte u, v;
-			int16 cr_r, crb_g, cb_b;
-			const uint32 *L;
-
-			READ_QUAD(uSrc, u);
-			READ_QUAD(vSrc, v);
-
-			DO_YUV410_PIXEL();
-			DO_YUV410_PIXEL();
-			DO_YUV410_PIXEL();
-			DO_YUV410_PIXEL();
-		}
-
-		dstPtr += dstPitch - yWidth * sizeof(PixelInt);
-		ySrc += yPitch - yWidth;
+// Perform bilinear interpolation on the chroma values
+// Based on the algorithm found here: http://tech-algorithm.com/articles/bilinear-image-scaling/
+// The vertical pass is done once per chroma column, which gives the same
+// result as weighting all four samples for every pixel.
+static void interpolateYUV410Row(byte *dst, const byte *src, int uvPitch, int yDiff, int width) {
+	int quarterWidth = width >> 2;
+
+	int right = src[0] * (4 - yDiff) + src[uvPitch] * yDiff;
+	for (int x = 0; x < quarterWidth; x++) {
+		int left = right;
+		right = src[x + 1] * (4 - yDiff) + src[x + uvPitch + 1] * yDiff;
+
+		dst[0] = (left * 4) >> 4;
+		dst[1] = (left * 3 + right) >> 4;
+		dst[2] = (left * 2 + right * 2) >> 4;
+		dst[3] = (left + right * 3) >> 4;
+		dst += 4;
 	}
 }
 
-#undef READ_QUAD
-#undef DO_INTERPOLATION
-#undef DO_YUV410_PIXEL
-
 void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
 	// Sanity checks
 	assert(dst && dst->getPixels());
@@ -501,12 +383,35 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yHeight & 3) == 0);
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
+	const YUVToRGBParams params = getParams(lookup, _colorTab, false);
+	YUVToRGBRowFunc rowFunc = getYUVToRGBFuncs()->row[dst->format.bytesPerPixel == 4][0][0];
+
+	// The chroma is scaled up into full resolution rows, which are then
+	// converted like YUV444. This is done in chunks to keep them on the stack.
+	forEachSlice(yWidth, yHeight, [&](int firstRow, int numRows) {
+		const int kChunkSize = 512;
+		byte uRow[kChunkSize];
+		byte vRow[kChunkSize];
 
-	// Use a templated function to avoid an if check on every pixel
-	if (dst->format.bytesPerPixel == 2)
-		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
-	else
-		convertYUV410ToRGB<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		byte *dstPtr = (byte *)dst->getBasePtr(0, firstRow);
+		const byte *yRowSrc = ySrc + firstRow * yPitch;
+
+		for (int y = firstRow; y < firstRow + numRows; y++) {
+			int yDiff = y & 3;
+			const byte *uRowSrc = uSrc + (y >> 2) * uvPitch;
+			const byte *vRowSrc = vSrc + (y >> 2) * uvPitch;
+
+			for (int x = 0; x < yWidth; x += kChunkSize) {
+				int width = MIN(kChunkSize, yWidth - x);
+				interpolateYUV410Row(uRow, uRowSrc + (x >> 2), uvPitch, yDiff, width);
+				interpolateYUV410Row(vRow, vRowSrc + (x >> 2), uvPitch, yDiff, width);
+				rowFunc(dstPtr + x * dst->format.bytesPerPixel, yRowSrc + x, uRow, vRow, nullptr, width, params);
+			}
+
+			dstPtr += dst->pitch;
+			yRowSrc += yPitch;
+		}
+	});
 }
 
 } // End of namespace Graphics
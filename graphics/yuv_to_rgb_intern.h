@@ -0,0 +1,127 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * Everything a row converter needs to know about the destination format.
+ *
+ * The generic converters use the lookup tables, the SIMD ones compute the
+ * same values arithmetically from the shifts and losses.
+ */
+struct YUVToRGBParams {
+	const uint32 *rgbToPix;
+	const uint32 *alphaToPix;
+	const int16 *colorTab;
+
+	bool ituScale;
+	byte rLoss, gLoss, bLoss, aLoss;
+	byte rShift, gShift, bShift, aShift;
+	uint32 alphaBits; // Alpha bits of every pixel when there is no alpha plane
+};
+
+/**
+ * Converts @p width pixels of a single row. With @p halfChroma, one chroma
+ * sample covers two horizontally neighbouring pixels. The alpha plane is
+ * only used by the converters that have one.
+ */
+typedef void (*YUVToRGBRowFunc)(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const YUVToRGBParams &params);
+
+/**
+ * A set of row converters, indexed by [bytesPerPixel == 4][halfChroma][hasAlpha].
+ */
+struct YUVToRGBFuncs {
+	YUVToRGBRowFunc row[2][2][2];
+};
+
+extern const YUVToRGBFuncs yuvToRGBFuncsGeneric;
+#ifdef SCUMMVM_NEON
+extern const YUVToRGBFuncs yuvToRGBFuncsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+extern const YUVToRGBFuncs yuvToRGBFuncsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+extern const YUVToRGBFuncs yuvToRGBFuncsAVX2;
+#endif
+
+/**
+ * The converters used by YUVToRGBManager. This is selected at runtime
+ * depending on the CPU features on first use, and is only exposed here
+ * so that the unit tests can compare the implementations.
+ */
+extern const YUVToRGBFuncs *yuvToRGBFuncs;
+
+/**
+ * The chroma factors of the color table as 0.15 fixed point numbers. With
+ * these, (|c| << 8) * factor >> 23 gives exactly the truncated products the
+ * table holds for every chroma value c in [-128, 127].
+ */
+enum {
+	kYUVToRGBCrR = 45919, // 0.419 / 0.299
+	kYUVToRGBCrG = 23383, // 0.299 / 0.419 (subtracted)
+	kYUVToRGBCbG = 11286, // 0.114 / 0.331 (subtracted)
+	kYUVToRGBCbB = 58111  // 0.587 / 0.331
+};
+
+/**
+ * Scaling [16, 235] to [0, 255] as (d * 255) * kYUVToRGBITUFactor >> 23 for
+ * d = value - 16, which matches (d * 255) / 219 exactly.
+ */
+enum {
+	kYUVToRGBITUFactor = 38305
+};
+
+/**
+ * The reference implementation all the SIMD converters have to match
+ * exactly. They use it for the pixels that do not fill a whole vector.
+ */
+template<typename PixelInt, bool halfChroma, bool hasAlpha>
+static inline void yuvToRGBRowGeneric(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const YUVToRGBParams &params) {
+	// Keep the tables in pointers here to avoid a dereference on each pixel
+	const int16 *Cr_r_tab = params.colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+	const uint32 *rgbToPix = params.rgbToPix;
+	const uint32 *aToPix = params.alphaToPix;
+	PixelInt *out = (PixelInt *)dst;
+
+	for (int x = 0; x < width; x++) {
+		byte u = uSrc[halfChroma ? (x >> 1) : x];
+		byte v = vSrc[halfChroma ? (x >> 1) : x];
+
+		const uint32 *L = &rgbToPix[ySrc[x]];
+		uint32 pixel = L[Cr_r_tab[v]] | L[Cr_g_tab[v] + Cb_g_tab[u]] | L[Cb_b_tab[u]];
+		if (hasAlpha)
+			pixel |= aToPix[aSrc[x]];
+		out[x] = pixel;
+	}
+}
+
+} // End of namespace Graphics
+
+#endif
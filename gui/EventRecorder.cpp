@@ -19,6 +19,8 @@
  *
  */
 
+// Needed for getrusage()
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
 
 #include "gui/EventRecorder.h"
 
@@ -29,10 +31,13 @@ DECLARE_SINGLETON(GUI::EventRecorder);
 }
 
 #include "common/debug-channels.h"
+#ifdef SDL_BACKEND
 #include "backends/timer/sdl/sdl-timer.h"
+#endif
 #include "backends/mixer/mixer.h"
 #include "common/config-manager.h"
 #include "common/md5.h"
+#include "common/profiler.h"
 #include "gui/gui-manager.h"
 #include "gui/widget.h"
 #include "gui/onscreendialog.h"
@@ -43,6 +48,10 @@ DECLARE_SINGLETON(GUI::EventRecorder);
 #include "graphics/surface.h"
 #include "graphics/scaler.h"
 
+#ifdef POSIX
+#include <sys/resource.h>
+#endif
+
 namespace GUI {
 
 
@@ -57,6 +66,11 @@ EventRecorder::EventRecorder() {
 	_needRedraw = false;
 	_processingMillis = false;
 	_fastPlayback = false;
+	_benchmark = false;
+	_benchmarkFrames = 0;
+	_benchmarkStartTime = 0;
+	_benchmarkLastFrameTime = 0;
+	memset(_benchmarkHistogram, 0, sizeof(_benchmarkHistogram));
 	_lastTimeDate.tm_sec = 0;
 	_lastTimeDate.tm_min = 0;
 	_lastTimeDate.tm_hour = 0;
@@ -89,13 +103,19 @@ void EventRecorder::deinit() {
 		return;
 	}
 	setFileHeader();
+	if (_benchmark) {
+		printBenchmarkReport();
+	}
 	_needRedraw = false;
 	_initialized = false;
 	_recordMode = kPassthrough;
 	delete _fakeMixerManager;
 	_fakeMixerManager = nullptr;
-	_controlPanel->close();
-	delete _controlPanel;
+	if (_controlPanel) {
+		_controlPanel->close();
+		delete _controlPanel;
+		_controlPanel = nullptr;
+	}
 	debugC(1, kDebugLevelEventRec, "playback:action=stopplayback");
 	Common::EventDispatcher *eventDispatcher = g_system->getEventManager()->getEventDispatcher();
 	eventDispatcher->unregisterSource(this);
@@ -118,7 +138,9 @@ void EventRecorder::updateFakeTimer(uint32 millis) {
 	uint32 millisDelay = millis - _lastMillis;
 	_lastMillis = millis;
 	_fakeTimer += millisDelay;
-	_controlPanel->setReplayedTime(_fakeTimer);
+	if (_controlPanel) {
+		_controlPanel->setReplayedTime(_fakeTimer);
+	}
 }
 
 void EventRecorder::processTimeAndDate(TimeDate &td, bool skipRecord) {
@@ -161,7 +183,7 @@ void EventRecorder::processTimeAndDate(TimeDate &td, bool skipRecord) {
 			_recordFile->writeEvent(timeDateEvent);
 		}
 
-		_nextEvent = _playbackFile->getNextEvent();
+		fetchNextEvent();
 	}
 	if (_recordMode == kRecorderPlaybackPause)
 		td = _lastTimeDate;
@@ -218,9 +240,11 @@ void EventRecorder::processMillis(uint32 &millis, bool skipRecord) {
 			_recordFile->writeEvent(timerEvent);
 		}
 		updateSubsystems();
-		_nextEvent = _playbackFile->getNextEvent();
+		fetchNextEvent();
 		_timerManager->handler();
-		_controlPanel->setReplayedTime(_fakeTimer);
+		if (_controlPanel) {
+			_controlPanel->setReplayedTime(_fakeTimer);
+		}
 		_processingMillis = false;
 		break;
 	case kRecorderPlaybackPause:
@@ -260,7 +284,7 @@ void EventRecorder::processScreenUpdate() {
 		if (_nextEvent.recordedtype != Common::kRecorderEventTypeScreenUpdate) {
 			int numSkipped = 0;
 			while (true) {
-				_nextEvent = _playbackFile->getNextEvent();
+				fetchNextEvent();
 				numSkipped += 1;
 				if (_nextEvent.recordedtype == Common::kRecorderEventTypeScreenUpdate) {
 					warning("Skipped %d events to get to the next screen update at %d", numSkipped, _nextEvent.time);
@@ -271,7 +295,10 @@ void EventRecorder::processScreenUpdate() {
 		_processingMillis = true;
 		_fakeTimer = _nextEvent.time;
 		updateSubsystems();
-		_nextEvent = _playbackFile->getNextEvent();
+		if (_benchmark) {
+			updateBenchmark();
+		}
+		fetchNextEvent();
 		if (_recordMode == kRecorderUpdate) {
 			// write event to the updated file and update screenshot if necessary
 			screenUpdateEvent.recordedtype = Common::kRecorderEventTypeScreenUpdate;
@@ -280,7 +307,9 @@ void EventRecorder::processScreenUpdate() {
 			takeScreenshot();
 		}
 		_timerManager->handler();
-		_controlPanel->setReplayedTime(_fakeTimer);
+		if (_controlPanel) {
+			_controlPanel->setReplayedTime(_fakeTimer);
+		}
 		_processingMillis = false;
 		break;
 	default:
@@ -288,6 +317,63 @@ void EventRecorder::processScreenUpdate() {
 	}
 }
 
+void EventRecorder::fetchNextEvent() {
+	// Running out of events quits right away, so report before that happens
+	if (_benchmark && !_playbackFile->hasNextEvent()) {
+		printBenchmarkReport();
+	}
+	_nextEvent = _playbackFile->getNextEvent();
+}
+
+void EventRecorder::updateBenchmark() {
+	uint64 now = Common::Profiler::getMicros();
+	uint32 frameMillis = (uint32)((now - _benchmarkLastFrameTime) / 1000);
+	_benchmarkLastFrameTime = now;
+	_benchmarkFrames++;
+
+	// Bucket n holds the frames which took less than 2^n ms, the last
+	// one all slower frames
+	int bucket = 0;
+	while (bucket < kBenchmarkHistogramSize - 1 && frameMillis >= (1u << bucket)) {
+		bucket++;
+	}
+	_benchmarkHistogram[bucket]++;
+}
+
+void EventRecorder::printBenchmarkReport() {
+	_benchmark = false;
+
+	uint64 wallTime = Common::Profiler::getMicros() - _benchmarkStartTime;
+	double seconds = wallTime / 1000000.0;
+
+	Common::String report = Common::String::format("Benchmark of '%s' (engine '%s'):\n",
+		ConfMan.getActiveDomainName().c_str(), ConfMan.get("engineid").c_str());
+	report += Common::String::format("  Frames:      %u\n", _benchmarkFrames);
+	report += Common::String::format("  Wall time:   %.3f s\n", seconds);
+	report += Common::String::format("  Frame rate:  %.1f fps\n", seconds > 0.0 ? _benchmarkFrames / seconds : 0.0);
+#ifdef POSIX
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef MACOSX
+		// macOS reports bytes, everyone else kilobytes
+		long peakRss = usage.ru_maxrss / 1024;
+#else
+		long peakRss = usage.ru_maxrss;
+#endif
+		report += Common::String::format("  Peak RSS:    %ld KB\n", peakRss);
+	}
+#endif
+	report += "  Frame times:\n";
+	for (int i = 0; i < kBenchmarkHistogramSize; i++) {
+		if (i < kBenchmarkHistogramSize - 1) {
+			report += Common::String::format("    < %3u ms: %u\n", 1u << i, _benchmarkHistogram[i]);
+		} else {
+			report += Common::String::format("   >= %3u ms: %u\n", 1u << (i - 1), _benchmarkHistogram[i]);
+		}
+	}
+	g_system->logMessage(LogMessageType::kInfo, report.c_str());
+}
+
 void EventRecorder::checkForKeyCode(const Common::Event &event) {
 	if ((event.type == Common::EVENT_KEYDOWN) && (event.kbd.flags & Common::KBD_CTRL) && (event.kbd.keycode == Common::KEYCODE_p) && (!event.kbdRepeat)) {
 		togglePause();
@@ -308,7 +394,7 @@ bool EventRecorder::pollEvent(Common::Event &ev) {
 	}
 
 	ev = _nextEvent;
-	_nextEvent = _playbackFile->getNextEvent();
+	fetchNextEvent();
 	switch (ev.type) {
 	case Common::EVENT_MOUSEMOVE:
 	case Common::EVENT_LBUTTONDOWN:
@@ -337,6 +423,10 @@ void EventRecorder::togglePause() {
 	case kRecorderPlayback:
 	case kRecorderRecord:
 	case kRecorderUpdate:
+		if (!_controlPanel) {
+			// Benchmarks can't be paused
+			break;
+		}
 		oldState = _recordMode;
 		_recordMode = kRecorderPlaybackPause;
 		_controlPanel->runModal();
@@ -387,6 +477,14 @@ void EventRecorder::init(const Common::String &recordFileName, RecordMode mode)
 	_fakeTimer = 0;
 	_lastMillis = g_system->getMillis();
 	_lastScreenshotTime = 0;
+	if (mode == kRecorderBenchmark) {
+		// A benchmark is a playback at full speed without the control panel
+		_benchmark = true;
+		_fastPlayback = true;
+		_benchmarkFrames = 0;
+		memset(_benchmarkHistogram, 0, sizeof(_benchmarkHistogram));
+		mode = kRecorderPlayback;
+	}
 	_recordMode = mode;
 	_needcontinueGame = false;
 	if (ConfMan.hasKey("disable_display")) {
@@ -409,13 +507,13 @@ void EventRecorder::init(const Common::String &recordFileName, RecordMode mode)
 		error("playback:action=error reason=\"Record file loading error\"");
 		return;
 	}
-	if (_recordMode != kPassthrough) {
+	if (_recordMode != kPassthrough && !_benchmark) {
 		_controlPanel = new GUI::OnScreenDialog(_recordMode == kRecorderRecord);
 		_controlPanel->reflowLayout();
 	}
 	if ((_recordMode == kRecorderPlayback) || (_recordMode == kRecorderUpdate)) {
 		applyPlaybackSettings();
-		_nextEvent = _playbackFile->getNextEvent();
+		fetchNextEvent();
 	}
 	if ((_recordMode == kRecorderRecord) || (_recordMode == kRecorderUpdate)) {
 		getConfig();
@@ -425,6 +523,9 @@ void EventRecorder::init(const Common::String &recordFileName, RecordMode mode)
 	switchTimerManagers();
 	_needRedraw = true;
 	_initialized = true;
+	if (_benchmark) {
+		_benchmarkStartTime = _benchmarkLastFrameTime = Common::Profiler::getMicros();
+	}
 }
 
 
@@ -559,7 +660,11 @@ void EventRecorder::registerTimerManager(DefaultTimerManager *timerManager) {
 void EventRecorder::switchTimerManagers() {
 	delete _timerManager;
 	if (_recordMode == kPassthrough) {
+#ifdef SDL_BACKEND
 		_timerManager = new SdlTimerManager();
+#else
+		_timerManager = new DefaultTimerManager();
+#endif
 	} else {
 		_timerManager = new DefaultTimerManager();
 	}
@@ -588,7 +693,7 @@ bool EventRecorder::notifyEvent(const Common::Event &ev) {
 	case kRecorderUpdate: // passthrough
 	case kRecorderPlayback:
 		// pass through screen updates to avoid loss of sync!
-		if (evt.type == Common::EVENT_SCREEN_CHANGED)
+		if (evt.type == Common::EVENT_SCREEN_CHANGED && _controlPanel)
 			g_gui.processEvent(evt, _controlPanel);
 		if (_recordMode == kRecorderUpdate) {
 			// write a copy of the event to the output buffer
@@ -699,7 +804,7 @@ Common::SaveFileManager *EventRecorder::getSaveManager(Common::SaveFileManager *
 }
 
 void EventRecorder::preDrawOverlayGui() {
-	if ((_initialized) || (_needRedraw)) {
+	if (((_initialized) || (_needRedraw)) && _controlPanel) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
 		g_system->showOverlay();
@@ -756,10 +861,12 @@ void EventRecorder::setFileHeader() {
 	_recordFile->getHeader().name = _name;
 }
 
+#ifdef SDL_BACKEND
 SDL_Surface *EventRecorder::getSurface(int width, int height) {
 	// Create a RGB565 surface of the requested dimensions.
 	return SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 16, 0xF800, 0x07E0, 0x001F, 0x0000);
 }
+#endif
 
 bool EventRecorder::switchMode() {
 	const Plugin *plugin = EngineMan.findPlugin(ConfMan.get("engineid"));
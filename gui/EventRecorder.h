@@ -38,7 +38,11 @@
 #include "backends/mixer/mixer.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#ifdef SDL_BACKEND
 #include "backends/timer/sdl/sdl-timer.h"
+#else
+#include "backends/timer/default/default-timer.h"
+#endif
 #include "common/config-manager.h"
 #include "common/recorderfile.h"
 #include "backends/saves/recorder/recorder-saves.h"
@@ -74,7 +78,8 @@ public:
 		kRecorderRecord = 1,		/**< kRecorderRecord, do the recording */
 		kRecorderPlayback = 2,		/**< kRecorderPlayback, playback existing recording */
 		kRecorderPlaybackPause = 3,	/**< kRecorderPlaybackPause, internal state when user pauses the playback */
-		kRecorderUpdate = 4			/**< kRecorderUpdate, playback existing recording and update all hashes */
+		kRecorderUpdate = 4,		/**< kRecorderUpdate, playback existing recording and update all hashes */
+		kRecorderBenchmark = 5		/**< kRecorderBenchmark, playback existing recording as fast as possible and report timings */
 	};
 
 	void init(const Common::String &recordFileName, RecordMode mode);
@@ -177,7 +182,9 @@ public:
 	Common::String generateRecordFileName(const Common::String &target);
 
 	Common::SaveFileManager *getSaveManager(Common::SaveFileManager *realSaveManager);
+#ifdef SDL_BACKEND
 	SDL_Surface *getSurface(int width, int height);
+#endif
 	void RegisterEventSource();
 
 	/** Retrieve game screenshot and compute its checksum for comparison */
@@ -249,6 +256,21 @@ private:
 	bool _fastPlayback;
 	bool _needRedraw;
 	bool _processingMillis;
+
+	/** Benchmark statistics, only gathered in kRecorderBenchmark mode */
+	enum {
+		kBenchmarkHistogramSize = 10
+	};
+
+	bool _benchmark;
+	uint32 _benchmarkFrames;
+	uint64 _benchmarkStartTime;
+	uint64 _benchmarkLastFrameTime;
+	uint32 _benchmarkHistogram[kBenchmarkHistogramSize];
+
+	void fetchNextEvent();
+	void updateBenchmark();
+	void printBenchmarkReport();
 };
 
 } // End of namespace GUI
@@ -25,6 +25,8 @@
 #include "common/file.h"
 #include "common/debug.h"
 #include "common/debug-channels.h"
+#include "common/algorithm.h"
+#include "common/profiler.h"
 #include "common/system.h"
 
 #ifndef DISABLE_MD5
@@ -81,6 +83,8 @@ Debugger::Debugger() {
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
 	registerCmd("debugflag_enable",	WRAP_METHOD(Debugger, cmdDebugFlagEnable));
 	registerCmd("debugflag_disable",	WRAP_METHOD(Debugger, cmdDebugFlagDisable));
+
+	registerCmd("profile",			WRAP_METHOD(Debugger, cmdProfile));
 }
 
 Debugger::~Debugger() {
@@ -857,6 +861,67 @@ bool Debugger::cmdDebugFlagDisable(int argc, const char **argv) {
 	return true;
 }
 
+struct ProfileZoneTotalGreater {
+	bool operator()(const Common::Profiler::StatsMap::const_iterator &x, const Common::Profiler::StatsMap::const_iterator &y) const {
+		return x->_value.total > y->_value.total;
+	}
+};
+
+bool Debugger::cmdProfile(int argc, const char **argv) {
+	Common::Profiler &profiler = Common::Profiler::instance();
+
+	if (argc == 2 && !strcmp(argv[1], "on")) {
+		profiler.setEnabled(true);
+		debugPrintf("Profiling enabled\n");
+	} else if (argc == 2 && !strcmp(argv[1], "off")) {
+		profiler.setEnabled(false);
+		debugPrintf("Profiling disabled\n");
+	} else if (argc == 2 && !strcmp(argv[1], "reset")) {
+		profiler.reset();
+		debugPrintf("Profiling results cleared\n");
+	} else if (argc == 3 && !strcmp(argv[1], "trace")) {
+		if (!strcmp(argv[2], "stop")) {
+			if (profiler.stopTrace())
+				debugPrintf("Trace written\n");
+			else
+				debugPrintf("Failed to write trace\n");
+		} else {
+			profiler.startTrace(Common::Path(argv[2], Common::Path::kNativeSeparator));
+			profiler.setEnabled(true);
+			debugPrintf("Tracing to '%s', stop with 'profile trace stop'\n", argv[2]);
+		}
+	} else if (argc == 1) {
+		const Common::Profiler::StatsMap &stats = profiler.getStats();
+		const uint32 frames = profiler.getFrameCount();
+
+		debugPrintf("Profiling is %s, %u frames recorded", Common::Profiler::isEnabled() ? "enabled" : "disabled", frames);
+		if (profiler.getDroppedCount())
+			debugPrintf(", %u zones dropped", profiler.getDroppedCount());
+		debugPrintf("\n");
+		if (stats.empty()) {
+			debugPrintf("Usage: %s [on | off | reset | trace <filename> | trace stop]\n", argv[0]);
+			return true;
+		}
+
+		Common::Array<Common::Profiler::StatsMap::const_iterator> zones;
+		for (Common::Profiler::StatsMap::const_iterator i = stats.begin(); i != stats.end(); ++i)
+			zones.push_back(i);
+		Common::sort(zones.begin(), zones.end(), ProfileZoneTotalGreater());
+
+		debugPrintf("%-28s %8s %9s %9s %9s %9s\n", "Zone (times in us)", "Count", "Min", "Avg", "Max", "Per frame");
+		for (uint i = 0; i < zones.size(); i++) {
+			const Common::ProfileZoneStats &zone = zones[i]->_value;
+			debugPrintf("%-28s %8u %9llu %9llu %9llu %9llu\n", zones[i]->_key.c_str(), zone.count,
+				(unsigned long long)zone.min, (unsigned long long)(zone.total / zone.count),
+				(unsigned long long)zone.max, (unsigned long long)(frames ? zone.total / frames : 0));
+		}
+	} else {
+		debugPrintf("Usage: %s [on | off | reset | trace <filename> | trace stop]\n", argv[0]);
+	}
+
+	return true;
+}
+
 // Console handler
 #ifndef USE_TEXT_CONSOLE_FOR_DEBUGGER
 bool Debugger::debuggerInputCallback(GUI::ConsoleDialog *console, const char *input, void *refCon) {
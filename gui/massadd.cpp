@@ -25,6 +25,7 @@
 #include "common/debug.h"
 #include "common/system.h"
 #include "common/taskbar.h"
+#include "common/threadpool.h"
 #include "common/translation.h"
 
 #include "engines/advancedDetector.h"
@@ -68,7 +69,7 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	Common::U32StringArray l;
 
 	// The dir we start our scan at
-	_scanStack.push(startDir);
+	_scanStack.push(ScanEntry(startDir));
 
 	// Removed for now... Why would you put a title on mass add dialog called "Mass Add Dialog"?
 	// new StaticTextWidget(this, "massadddialog_caption", "Mass Add Dialog");
@@ -161,6 +162,29 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 	}
 }
 
+void MassAddDialog::listDirectories() {
+	// Listing directories is mostly waiting for the disk, so it is done on
+	// the thread pool when possible. Only as many directories as there are
+	// threads are listed at once, to keep the dialog responsive. Each
+	// directory is only accessed by a single thread.
+	uint count = 1;
+	if (Common::FSNode::supportsThreadedAccess())
+		count = MIN<uint>(Common::ThreadPool::instance().getThreadCount(), _scanStack.size());
+
+	Common::Array<ScanEntry *> dirs;
+	for (uint i = 0; i < count; i++) {
+		ScanEntry &entry = _scanStack[_scanStack.size() - 1 - i];
+		if (entry.listed)
+			break;
+		dirs.push_back(&entry);
+	}
+
+	Common::ThreadPool::instance().parallelFor(dirs.size(), [&dirs](uint i) {
+		dirs[i]->readable = dirs[i]->dir.getChildren(dirs[i]->files, Common::FSNode::kListAll);
+		dirs[i]->listed = true;
+	});
+}
+
 void MassAddDialog::handleTickle() {
 	if (_scanStack.empty())
 		return;	// We have finished scanning
@@ -169,13 +193,17 @@ void MassAddDialog::handleTickle() {
 
 	// Perform a breadth-first scan of the filesystem.
 	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
-		Common::FSNode dir = _scanStack.pop();
+		if (!_scanStack.top().listed)
+			listDirectories();
 
-		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
+		ScanEntry entry = _scanStack.pop();
+		if (!entry.readable) {
 			continue;
 		}
 
+		const Common::FSNode &dir = entry.dir;
+		const Common::FSList &files = entry.files;
+
 		// Run the detector on the dir
 		DetectionResults detectionResults = EngineMan.detectGames(files, (ADGF_WARNING | ADGF_UNSUPPORTED), true);
 
@@ -231,7 +259,7 @@ void MassAddDialog::handleTickle() {
 		// Recurse into all subdirs
 		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
 			if (file->isDirectory()) {
-				_scanStack.push(*file);
+				_scanStack.push(ScanEntry(*file));
 
 				_dirTotal++;
 			}
@@ -256,6 +284,9 @@ void MassAddDialog::handleTickle() {
 		buf = _("Scan complete!");
 		_dirProgressText->setLabel(buf);
 
+		// Make sure everything computed during the scan is kept
+		ADCacheMan.flushDiskCache(true);
+
 		buf = Common::U32String::format(_("Discovered %d new games, ignored %d previously added games."), _games.size(), _oldGamesCount);
 		_gameProgressText->setLabel(buf);
 
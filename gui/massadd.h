@@ -48,7 +48,24 @@ public:
 	}
 
 private:
-	Common::Stack<Common::FSNode>  _scanStack;
+	struct ScanEntry {
+		ScanEntry() : listed(false), readable(false) {}
+		explicit ScanEntry(const Common::FSNode &node) : dir(node), listed(false), readable(false) {}
+
+		Common::FSNode dir;
+		Common::FSList files; ///< The contents of dir, listed before it is scanned
+		bool listed;          ///< Whether files has been filled in
+		bool readable;        ///< Whether dir could be listed
+	};
+
+	/**
+	 * List the contents of the directory on top of the scan stack. If the
+	 * filesystem allows it, the directories below it are listed in parallel,
+	 * one for each thread of the pool.
+	 */
+	void listDirectories();
+
+	Common::Stack<ScanEntry>  _scanStack;
 	DetectedGames _games;
 
 	/**
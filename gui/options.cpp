@@ -201,6 +201,8 @@ void OptionsDialog::init() {
 	_scalerPopUp = nullptr;
 	_scalerPopUpDesc = nullptr;
 	_scaleFactorPopUp = nullptr;
+	_scalerThreadsPopUpDesc = nullptr;
+	_scalerThreadsPopUp = nullptr;
 	_fullscreenCheckbox = nullptr;
 	_filteringCheckbox = nullptr;
 	_aspectCheckbox = nullptr;
@@ -416,10 +418,17 @@ void OptionsDialog::build() {
 				}
 
 			}
+
+			if (ConfMan.hasKey("scaler_threads", _domain))
+				_scalerThreadsPopUp->setSelectedTag(ConfMan.getInt("scaler_threads", _domain));
+			else
+				_scalerThreadsPopUp->setSelectedTag(uint32(-1));
 		} else {
 			_scalerPopUpDesc->setVisible(false);
 			_scalerPopUp->setVisible(false);
 			_scaleFactorPopUp->setVisible(false);
+			_scalerThreadsPopUpDesc->setVisible(false);
+			_scalerThreadsPopUp->setVisible(false);
 		}
 	}
 
@@ -708,6 +717,17 @@ void OptionsDialog::apply() {
 					else if (g_system->getScaleFactor() != defaultScaleFactor)
 						graphicsModeChanged = true;
 				}
+
+				if (_scalerThreadsPopUp->getSelectedTag() != (uint32)-1) {
+					int threads = _scalerThreadsPopUp->getSelectedTag();
+					if (!ConfMan.hasKey("scaler_threads", _domain) || ConfMan.getInt("scaler_threads", _domain) != threads) {
+						ConfMan.setInt("scaler_threads", threads, _domain);
+						graphicsModeChanged = true;
+					}
+				} else if (ConfMan.hasKey("scaler_threads", _domain)) {
+					ConfMan.removeKey("scaler_threads", _domain);
+					graphicsModeChanged = true;
+				}
 			}
 
 			if (_rendererTypePopUp) {
@@ -736,6 +756,7 @@ void OptionsDialog::apply() {
 			ConfMan.removeKey("stretch_mode", _domain);
 			ConfMan.removeKey("scaler", _domain);
 			ConfMan.removeKey("scale_factor", _domain);
+			ConfMan.removeKey("scaler_threads", _domain);
 			ConfMan.removeKey("render_mode", _domain);
 			ConfMan.removeKey("renderer", _domain);
 			ConfMan.removeKey("antialiasing", _domain);
@@ -1249,12 +1270,16 @@ void OptionsDialog::setGraphicSettingsState(bool enabled) {
 		_scalerPopUpDesc->setEnabled(enabled);
 		_scalerPopUp->setEnabled(enabled);
 		_scaleFactorPopUp->setEnabled(enabled);
+		_scalerThreadsPopUpDesc->setEnabled(enabled);
+		_scalerThreadsPopUp->setEnabled(enabled);
 	} else {
 		// Happens when we switch to backend that doesn't support scalers
 		if (_scalerPopUp) {
 			_scalerPopUpDesc->setEnabled(false);
 			_scalerPopUp->setEnabled(false);
 			_scaleFactorPopUp->setEnabled(false);
+			_scalerThreadsPopUpDesc->setEnabled(false);
+			_scalerThreadsPopUp->setEnabled(false);
 		}
 	}
 
@@ -1617,6 +1642,17 @@ void OptionsDialog::addGraphicControls(GuiObject *boss, const Common::String &pr
 
 		_scaleFactorPopUp = new PopUpWidget(boss, prefix + "grScaleFactorPopup");
 		updateScaleFactors(_scalerPopUp->getSelectedTag());
+
+		// Band-safe scalers split the screen into bands scaled on this many threads
+		static const uint threadCounts[] = { 1, 2, 3, 4, 6, 8, 12, 16 };
+		_scalerThreadsPopUpDesc = new StaticTextWidget(boss, prefix + "grScalerThreadsPopupDesc", _("Scaler threads:"));
+		_scalerThreadsPopUp = new PopUpWidget(boss, prefix + "grScalerThreadsPopup", _("Number of threads used by the scalers that support it"));
+		_scalerThreadsPopUp->appendEntry(_("<default>"), uint32(-1));
+		_scalerThreadsPopUp->appendEntry("");
+		_scalerThreadsPopUp->appendEntry(_c("Automatic", "threads"), 0);
+		for (uint i = 0; i < ARRAYSIZE(threadCounts); i++) {
+			_scalerThreadsPopUp->appendEntry(Common::String::format("%d", threadCounts[i]), threadCounts[i]);
+		}
 	}
 
 	if (!g_gui.useLowResGUI())
@@ -2053,6 +2089,8 @@ void OptionsDialog::setupGraphicsTab() {
 			_scalerPopUpDesc->setFontColor(ThemeEngine::FontColor::kFontColorOverride);
 		_scalerPopUp->setVisible(true);
 		_scaleFactorPopUp->setVisible(true);
+		_scalerThreadsPopUpDesc->setVisible(true);
+		_scalerThreadsPopUp->setVisible(true);
 	}
 
 	enableShaderControls(g_system->hasFeature(OSystem::kFeatureShaders));
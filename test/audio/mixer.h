@@ -0,0 +1,78 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+#include "audio/rate_intern.h"
+#include "audio/audiostream.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+private:
+	void playStopTemplate(bool lockFree) {
+		// The null backend cannot be asked for CPU features
+		Audio::rateMixFuncs = &Audio::rateMixFuncsGeneric;
+
+		Audio::MixerImpl impl(22050, true, 1024, lockFree);
+		impl.setReady(true);
+#ifdef ATOMICS_ARE_LOCK_FREE
+		TS_ASSERT_EQUALS(impl.isLockFree(), lockFree);
+#else
+		TS_ASSERT(!impl.isLockFree());
+#endif
+
+		Audio::Mixer &mixer = impl;
+
+		Audio::SoundHandle handle, other;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, createSineStream<int16>(22050, 1, nullptr, true, false), 42);
+		mixer.playStream(Audio::Mixer::kMusicSoundType, &other, createSineStream<int16>(22050, 1, nullptr, true, true));
+
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundIDActive(42));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 42);
+		TS_ASSERT(mixer.hasActiveChannelOfType(Audio::Mixer::kSFXSoundType));
+
+		mixer.setChannelVolume(handle, 100);
+		mixer.setChannelBalance(handle, -20);
+		mixer.setChannelRate(handle, 11025);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 100);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), -20);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 11025u);
+		mixer.resetChannelRate(handle);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 22050u);
+
+		int16 buffer[1024 * 2];
+		TS_ASSERT_EQUALS(impl.mixCallback((byte *)buffer, sizeof(buffer)), 1024);
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(!mixer.isSoundIDActive(42));
+		TS_ASSERT(mixer.isSoundHandleActive(other));
+
+		// Let the remaining stream run out on its own
+		for (int i = 0; i < 30; ++i)
+			impl.mixCallback((byte *)buffer, sizeof(buffer));
+		TS_ASSERT(!mixer.isSoundHandleActive(other));
+		TS_ASSERT(!mixer.hasActiveChannelOfType(Audio::Mixer::kMusicSoundType));
+
+		TS_ASSERT_EQUALS(impl.getStats().callbacks, 31u);
+
+		Audio::rateMixFuncs = nullptr;
+	}
+
+public:
+	void test_play_stop() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		playStopTemplate(false);
+#endif
+	}
+
+	void test_play_stop_lock_free() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		playStopTemplate(true);
+#endif
+	}
+};
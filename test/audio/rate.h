@@ -0,0 +1,105 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+#include "audio/audiostream.h"
+
+#include "helper.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	const Audio::RateMixFuncs *getBestRateMixFuncs() {
+		const Audio::RateMixFuncs *funcs = &Audio::rateMixFuncsGeneric;
+#ifdef SCUMMVM_NEON
+		funcs = &Audio::rateMixFuncsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs = &Audio::rateMixFuncsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			funcs = &Audio::rateMixFuncsAVX2;
+#endif
+		return funcs;
+	}
+
+	// Convert a sine wave in several odd sized chunks on top of a noisy
+	// output buffer, so that both the vector and the remainder code paths
+	// and the saturation get exercised.
+	int16 *convert(const Audio::RateMixFuncs *funcs, int inRate, int outRate, bool inStereo, bool outStereo, bool reverseStereo,
+	               Audio::st_volume_t volL, Audio::st_volume_t volR, int totalFrames) {
+		Audio::rateMixFuncs = funcs;
+
+		Audio::SeekableAudioStream *s = createSineStream<int16>(inRate, 1, nullptr, true, inStereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, inStereo, outStereo, reverseStereo);
+
+		const int outChannels = outStereo ? 2 : 1;
+		int16 *buffer = new int16[totalFrames * outChannels];
+		for (int i = 0; i < totalFrames * outChannels; ++i)
+			buffer[i] = (int16)((i * 7919) ^ (i << 9));
+
+		int pos = 0;
+		int chunk = 1;
+		while (pos < totalFrames) {
+			int len = MIN(chunk, totalFrames - pos);
+			int written = converter->convert(*s, buffer + pos * outChannels, len, volL, volR);
+			if (written <= 0)
+				break;
+			pos += written;
+			chunk = chunk * 3 + 1;
+		}
+
+		delete converter;
+		delete s;
+		return buffer;
+	}
+
+	void compareTemplate(int inRate, int outRate, bool inStereo, bool outStereo, bool reverseStereo) {
+		const Audio::RateMixFuncs *best = getBestRateMixFuncs();
+		const Audio::st_volume_t volumes[][2] = { { 256, 256 }, { 255, 40 }, { 0, 131 } };
+		const int totalFrames = 4000;
+		const int outChannels = outStereo ? 2 : 1;
+
+		for (int v = 0; v < ARRAYSIZE(volumes); ++v) {
+			int16 *expected = convert(&Audio::rateMixFuncsGeneric, inRate, outRate, inStereo, outStereo, reverseStereo, volumes[v][0], volumes[v][1], totalFrames);
+			int16 *actual = convert(best, inRate, outRate, inStereo, outStereo, reverseStereo, volumes[v][0], volumes[v][1], totalFrames);
+			TS_ASSERT_EQUALS(memcmp(expected, actual, sizeof(int16) * totalFrames * outChannels), 0);
+			delete[] expected;
+			delete[] actual;
+		}
+
+		Audio::rateMixFuncs = nullptr;
+	}
+
+public:
+	void test_copy_convert() {
+		compareTemplate(22050, 22050, false, false, false);
+		compareTemplate(22050, 22050, false, true, false);
+		compareTemplate(22050, 22050, true, false, false);
+		compareTemplate(22050, 22050, true, true, false);
+		compareTemplate(22050, 22050, true, true, true);
+	}
+
+	void test_simple_convert() {
+		compareTemplate(44100, 22050, false, false, false);
+		compareTemplate(44100, 22050, false, true, false);
+		compareTemplate(44100, 22050, true, false, false);
+		compareTemplate(44100, 22050, true, true, false);
+		compareTemplate(44100, 22050, true, true, true);
+	}
+
+	void test_interpolate_convert() {
+		compareTemplate(11025, 44100, false, false, false);
+		compareTemplate(11025, 44100, false, true, false);
+		compareTemplate(11025, 44100, true, false, false);
+		compareTemplate(11025, 44100, true, true, false);
+		compareTemplate(22050, 48000, true, true, true);
+	}
+};
@@ -0,0 +1,33 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+
+class AtomicTestSuite : public CxxTest::TestSuite {
+public:
+	void test_load_store() {
+		Common::Atomic<uint32> value;
+		TS_ASSERT_EQUALS(value.load(), 0u);
+
+		value.store(5, Common::kMemoryOrderRelease);
+		TS_ASSERT_EQUALS(value.load(Common::kMemoryOrderAcquire), 5u);
+
+		value = 7;
+		TS_ASSERT_EQUALS((uint32)value, 7u);
+	}
+
+	void test_modify() {
+		Common::Atomic<int> value(10);
+
+		TS_ASSERT_EQUALS(value.fetchAdd(3, Common::kMemoryOrderRelaxed), 10);
+		TS_ASSERT_EQUALS(value.exchange(-1), 13);
+		TS_ASSERT_EQUALS(value.load(), -1);
+
+		int expected = 0;
+		TS_ASSERT(!value.compareExchangeWeak(expected, 4, Common::kMemoryOrderAcqRel, Common::kMemoryOrderRelaxed));
+		TS_ASSERT_EQUALS(expected, -1);
+
+		while (!value.compareExchangeWeak(expected, 4, Common::kMemoryOrderAcqRel, Common::kMemoryOrderRelaxed))
+			;
+		TS_ASSERT_EQUALS(value.load(), 4);
+	}
+};
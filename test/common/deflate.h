@@ -0,0 +1,51 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/compression/deflate.h"
+#include "common/memstream.h"
+
+class DeflateTestSuite : public CxxTest::TestSuite {
+	static byte testByte(uint32 pos) {
+		// Compressible, but not trivially so
+		return (byte)((pos * 7 + (pos >> 9) * 13) & 0x3f);
+	}
+
+public:
+	void test_seek() {
+#ifdef USE_ZLIB
+		const uint32 size = 3 * 1024 * 1024 + 123;
+
+		// The writer takes ownership of the output stream, but not its data
+		Common::MemoryWriteStreamDynamic *compressed = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *writer = Common::wrapCompressedWriteStream(compressed);
+		byte block[1024];
+		for (uint32 pos = 0; pos < size; pos += sizeof(block)) {
+			uint32 len = MIN<uint32>(sizeof(block), size - pos);
+			for (uint32 i = 0; i < len; i++)
+				block[i] = testByte(pos + i);
+			writer->write(block, len);
+		}
+		writer->finalize();
+		byte *data = compressed->getData();
+		uint32 dataSize = compressed->size();
+		delete writer;
+
+		Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(
+			new Common::MemoryReadStream(data, dataSize, DisposeAfterUse::YES));
+		TS_ASSERT_EQUALS(stream->size(), (int64)size);
+
+		// Read everything once, then jump around backwards and forwards
+		stream->seek(0, SEEK_END);
+		TS_ASSERT_EQUALS(stream->pos(), (int64)size);
+
+		const uint32 positions[] = { 2500000, 10, 1048576, 3000000, 1048575, 0, size - 1 };
+		for (uint i = 0; i < ARRAYSIZE(positions); i++) {
+			TS_ASSERT(stream->seek(positions[i]));
+			TS_ASSERT_EQUALS(stream->pos(), (int64)positions[i]);
+			TS_ASSERT_EQUALS(stream->readByte(), testByte(positions[i]));
+		}
+
+		TS_ASSERT(!stream->err());
+		delete stream;
+#endif
+	}
+};
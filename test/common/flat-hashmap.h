@@ -0,0 +1,306 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	typedef Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FlatStringMap;
+
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		FlatStringMap container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(container.contains(0));
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.contains(17));
+		TS_ASSERT(!container.contains(-1));
+
+		FlatStringMap container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("foo"));
+		TS_ASSERT(container2.contains("QUUX"));
+		TS_ASSERT(!container2.contains("bar"));
+		TS_ASSERT(!container2.contains("asdf"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		container.erase(0);
+		TS_ASSERT(!container.empty());
+		container.erase(1);
+		TS_ASSERT(!container.empty());
+		container.erase(2);
+		TS_ASSERT(!container.empty());
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		container[1] = 33;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.empty());
+		container.erase(1);
+		TS_ASSERT(container.empty());
+	}
+
+	void test_add_remove_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		TS_ASSERT(container.contains(1));
+		container.erase(container.find(1));
+		TS_ASSERT(!container.contains(1));
+		container.erase(container.find(0));
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(2));
+		TS_ASSERT(container.empty());
+	}
+
+	void test_lookup() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+		container.setVal(3, 12);
+		container.getOrCreateVal(4) = 96;
+
+		TS_ASSERT_EQUALS(container[0], 17);
+		TS_ASSERT_EQUALS(container[1], -1);
+		TS_ASSERT_EQUALS(container.getVal(2), 45);
+		TS_ASSERT_EQUALS(container[3], 12);
+		TS_ASSERT_EQUALS(container[4], 96);
+
+		int val = 0;
+		TS_ASSERT(container.tryGetVal(2, val));
+		TS_ASSERT_EQUALS(val, 45);
+		TS_ASSERT(!container.tryGetVal(5, val));
+		TS_ASSERT_EQUALS(val, 45);
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+
+		// We take a const ref now to ensure that the map
+		// is not modified by getValOrDefault.
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0, -10), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17, -10), -10);
+		TS_ASSERT_EQUALS(container.size(), 2U);
+	}
+
+	void test_iterator_begin_end() {
+		Common::FlatHashMap<int, int> container;
+
+		// The container is initially empty ...
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+
+		// ... then non-empty ...
+		container[324] = 33;
+		TS_ASSERT_DIFFERS(container.begin(), container.end());
+
+		// ... and again empty.
+		container.clear();
+		TS_ASSERT_EQUALS(container.begin(), container.end());
+	}
+
+	void test_hash_map_copy() {
+		FlatStringMap map1, container2;
+		map1["foo"] = "bar";
+		container2 = map1;
+		TS_ASSERT_EQUALS(container2["foo"], "bar");
+		map1["foo"] = "baz";
+		TS_ASSERT_EQUALS(container2["foo"], "bar");
+
+		FlatStringMap container3(map1);
+		TS_ASSERT_EQUALS(container3["foo"], "baz");
+	}
+
+	void test_collision() {
+		// Keys sharing the same low bits used to collide in HashMap; here
+		// they also exercise moving entries back and forth within a cluster.
+		Common::FlatHashMap<int, int> h;
+		for (int i = 0; i < 8; i++)
+			h[(i << 12) + 5] = i;
+		for (int i = 0; i < 8; i += 2)
+			h.erase((i << 12) + 5);
+		for (int i = 0; i < 8; i++)
+			TS_ASSERT_EQUALS(h.contains((i << 12) + 5), (i & 1) != 0);
+		for (int i = 1; i < 8; i += 2)
+			TS_ASSERT_EQUALS(h[(i << 12) + 5], i);
+		TS_ASSERT_EQUALS(h.size(), 4U);
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		container.erase(1);
+		container[1] = 42;
+		container.erase(0);
+		container.erase(1);
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::iterator i;
+		for (i = container.begin(); i != container.end(); ++i) {
+			int key = i->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+
+		found = 0;
+		Common::FlatHashMap<int, int>::const_iterator j;
+		for (j = container.begin(); j != container.end(); ++j) {
+			int key = j->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+	}
+
+	void test_against_hashmap() {
+		// Mirror a long sequence of pseudo random operations in a HashMap
+		// and check that both maps agree.
+		Common::FlatHashMap<uint, uint> flat;
+		Common::HashMap<uint, uint> ref;
+		uint32 seed = 12345;
+
+		for (int i = 0; i < 20000; i++) {
+			seed = seed * 1103515245 + 12345;
+			uint key = (seed >> 8) % 1500;
+			if (seed & 0x80000000) {
+				flat.erase(key);
+				ref.erase(key);
+			} else {
+				flat[key] = i;
+				ref[key] = i;
+			}
+		}
+
+		TS_ASSERT_EQUALS(flat.size(), ref.size());
+		for (Common::HashMap<uint, uint>::const_iterator it = ref.begin(); it != ref.end(); ++it)
+			TS_ASSERT_EQUALS(flat.getValOrDefault(it->_key, 0xFFFFFFFF), it->_value);
+
+		uint count = 0;
+		for (Common::FlatHashMap<uint, uint>::const_iterator it = flat.begin(); it != flat.end(); ++it) {
+			TS_ASSERT(ref.contains(it->_key));
+			count++;
+		}
+		TS_ASSERT_EQUALS(count, ref.size());
+	}
+
+	template<class Map, class Key>
+	void benchmark(const char *name, const Common::Array<Key> &keys, int iters) {
+		uint32 insertTime = 0, lookupTime = 0, eraseTime = 0;
+		uint found = 0;
+
+		for (int i = 0; i < iters; i++) {
+			Map map;
+
+			uint32 start = g_system->getMillis();
+			for (uint k = 0; k < keys.size(); k++)
+				map[keys[k]] = k;
+			insertTime += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (int pass = 0; pass < 4; pass++) {
+				for (uint k = 0; k < keys.size(); k++)
+					found += map.contains(keys[(k * 7) % keys.size()]);
+			}
+			lookupTime += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (uint k = 0; k < keys.size(); k++)
+				map.erase(keys[k]);
+			eraseTime += g_system->getMillis() - start;
+
+			TS_ASSERT(map.empty());
+		}
+
+		TS_ASSERT_EQUALS(found, 4 * keys.size() * iters);
+		debug("%s: %d iters of %u keys (in milliseconds): insert %u, lookup (x4) %u, erase %u", name, iters, keys.size(), insertTime, lookupTime, eraseTime);
+	}
+
+	void test_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 200;
+#else
+		const int iters = 1;
+#endif
+
+		// File names, as found in the maps used by the archives and the
+		// detection code
+		Common::Array<Common::String> keys;
+		for (int i = 0; i < 20000; i++)
+			keys.push_back(Common::String::format("resource.%03d/pic%05d.bmp", i % 1000, i * 37));
+
+		benchmark<Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >("HashMap<String>", keys, iters);
+		benchmark<Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> >("FlatHashMap<String>", keys, iters);
+
+		Common::Array<uint> intKeys;
+		uint32 seed = 12345;
+		for (int i = 0; i < 20000; i++) {
+			seed = seed * 1103515245 + 12345;
+			intKeys.push_back(seed);
+		}
+
+		benchmark<Common::HashMap<uint, uint> >("HashMap<uint>", intKeys, iters);
+		benchmark<Common::FlatHashMap<uint, uint> >("FlatHashMap<uint>", intKeys, iters);
+#endif
+	}
+};
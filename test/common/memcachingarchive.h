@@ -0,0 +1,135 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/stream.h"
+
+class MemcachingArchiveTestSuite : public CxxTest::TestSuite {
+	// An archive with members "a" to "d" of 1000 bytes each, which counts
+	// how often contents are read
+	class TestArchive : public Common::MemcachingCaseInsensitiveArchive {
+	public:
+		TestArchive() : Common::MemcachingCaseInsensitiveArchive(512), reads(0) {}
+
+		bool hasFile(const Common::Path &path) const override {
+			Common::String name = path.toString();
+			return name.size() == 1 && name[0] >= 'a' && name[0] <= 'd';
+		}
+
+		int listMembers(Common::ArchiveMemberList &list) const override {
+			return 0;
+		}
+
+		const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+			return Common::ArchiveMemberPtr();
+		}
+
+		Common::SharedArchiveContents readContentsForPath(const Common::Path &translatedPath) const override {
+			if (!hasFile(translatedPath))
+				return Common::SharedArchiveContents();
+
+			reads++;
+			byte *contents = new byte[1000];
+			memset(contents, translatedPath.toString()[0], 1000);
+			return Common::SharedArchiveContents(contents, 1000);
+		}
+
+		mutable int reads;
+	};
+
+	void readMember(const TestArchive &archive, const char *name) {
+		Common::SeekableReadStream *stream = archive.createReadStreamForMember(name);
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), 1000);
+		TS_ASSERT_EQUALS(stream->readByte(), name[0]);
+		delete stream;
+	}
+
+	uint32 _oldCacheBudget;
+
+public:
+	void setUp() {
+		_oldCacheBudget = Common::MemcachingCaseInsensitiveArchive::getCacheBudget();
+	}
+
+	void tearDown() {
+		Common::MemcachingCaseInsensitiveArchive::setCacheBudget(_oldCacheBudget);
+	}
+
+	void test_lru() {
+		Common::MemcachingCaseInsensitiveArchive::setCacheBudget(2000);
+		TestArchive archive;
+
+		readMember(archive, "a");
+		readMember(archive, "b");
+		readMember(archive, "a");
+		TS_ASSERT_EQUALS(archive.reads, 2);
+
+		// "b" is the least recently used member, so it gets dropped
+		readMember(archive, "c");
+		TS_ASSERT_EQUALS(archive.getCacheStats().evictions, 1u);
+		readMember(archive, "a");
+		TS_ASSERT_EQUALS(archive.reads, 3);
+		readMember(archive, "b");
+		TS_ASSERT_EQUALS(archive.reads, 4);
+
+		const Common::MemcachingCaseInsensitiveArchive::CacheStats &stats = archive.getCacheStats();
+		TS_ASSERT_EQUALS(stats.hits, 2u);
+		TS_ASSERT_EQUALS(stats.misses, 4u);
+		TS_ASSERT_EQUALS(stats.cachedSize, 2000u);
+
+		Common::MemcachingCaseInsensitiveArchive::setCacheBudget(0);
+		TS_ASSERT_EQUALS(archive.getCacheStats().cachedSize, 0u);
+		readMember(archive, "a");
+		TS_ASSERT_EQUALS(archive.reads, 5);
+	}
+
+	void test_shared_budget() {
+		Common::MemcachingCaseInsensitiveArchive::setCacheBudget(2000);
+		TestArchive archive;
+
+		{
+			// The archives share the budget, so "a" gets dropped
+			TestArchive other;
+			readMember(archive, "a");
+			readMember(other, "b");
+			readMember(other, "c");
+			TS_ASSERT_EQUALS(archive.getCacheStats().evictions, 1u);
+			TS_ASSERT_EQUALS(archive.getCacheStats().cachedSize, 0u);
+			TS_ASSERT_EQUALS(other.getCacheStats().cachedSize, 2000u);
+			readMember(archive, "a");
+			TS_ASSERT_EQUALS(archive.reads, 2);
+			TS_ASSERT_EQUALS(other.getCacheStats().evictions, 1u);
+		}
+
+		// Deleting an archive gives its space back
+		readMember(archive, "b");
+		TS_ASSERT_EQUALS(archive.getCacheStats().evictions, 1u);
+		TS_ASSERT_EQUALS(archive.getCacheStats().cachedSize, 2000u);
+	}
+
+	void test_open_streams() {
+		Common::MemcachingCaseInsensitiveArchive::setCacheBudget(0);
+		TestArchive archive;
+
+		// Contents stay available while a stream reads them
+		Common::SeekableReadStream *stream = archive.createReadStreamForMember("a");
+		readMember(archive, "a");
+		TS_ASSERT_EQUALS(archive.reads, 1);
+		delete stream;
+
+		readMember(archive, "a");
+		TS_ASSERT_EQUALS(archive.reads, 2);
+		TS_ASSERT(!archive.createReadStreamForMember("e"));
+	}
+
+	void test_prefetch() {
+		Common::MemcachingCaseInsensitiveArchive::setCacheBudget(4000);
+		TestArchive archive;
+
+		archive.prefetchMember("c");
+		TS_ASSERT_EQUALS(archive.reads, 1);
+		readMember(archive, "c");
+		TS_ASSERT_EQUALS(archive.reads, 1);
+		TS_ASSERT_EQUALS(archive.getCacheStats().hits, 1u);
+	}
+};
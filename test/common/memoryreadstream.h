@@ -104,4 +104,30 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_mapped_span() {
+		byte *contents = new byte[7];
+		for (int i = 0; i < 7; ++i)
+			contents[i] = i + 1;
+
+		Common::SharedPtr<byte> span(contents, Common::ArrayDeleter<byte>());
+		Common::MappedReadStream *ms = new Common::MappedReadStream(span, 7);
+		TS_ASSERT_EQUALS(ms->getData(), contents);
+
+		// Parts of the span are views, not copies
+		TS_ASSERT_EQUALS(ms->getSpan(2, 3).get(), contents + 2);
+		TS_ASSERT(!ms->getSpan(5, 3));
+		TS_ASSERT(!ms->createSpanStream(8, 0));
+
+		Common::MappedReadStream *sub = ms->createSpanStream(3, 4);
+		TS_ASSERT(sub);
+		delete ms;
+		span.reset();
+
+		// The substream keeps the span alive
+		TS_ASSERT_EQUALS(sub->size(), 4);
+		TS_ASSERT_EQUALS(sub->readByte(), 4);
+		TS_ASSERT_EQUALS(sub->readUint16BE(), 0x0506);
+		delete sub;
+	}
 };
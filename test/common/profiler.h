@@ -0,0 +1,48 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/profiler.h"
+
+class ProfilerTestSuite : public CxxTest::TestSuite {
+public:
+	void test_zones() {
+		Common::Profiler profiler;
+
+		{
+			PROFILE_ZONE("disabled");
+		}
+
+		profiler.setEnabled(true);
+		for (int i = 0; i < 3; ++i) {
+			PROFILE_ZONE("outer");
+			PROFILE_ZONE("inner");
+		}
+		profiler.setEnabled(false);
+
+		const Common::Profiler::StatsMap &stats = profiler.getStats();
+		TS_ASSERT(!stats.contains("disabled"));
+		TS_ASSERT(stats.contains("outer"));
+		TS_ASSERT(stats.contains("inner"));
+		TS_ASSERT_EQUALS(stats["outer"].count, 3u);
+		TS_ASSERT_EQUALS(stats["inner"].count, 3u);
+		TS_ASSERT_LESS_THAN_EQUALS(stats["inner"].min, stats["inner"].max);
+		TS_ASSERT_LESS_THAN_EQUALS(stats["inner"].max, stats["inner"].total);
+		TS_ASSERT_EQUALS(profiler.getDroppedCount(), 0u);
+
+		profiler.reset();
+		TS_ASSERT(profiler.getStats().empty());
+	}
+
+	void test_frames() {
+		Common::Profiler profiler;
+
+		// Frames are only counted while profiling is enabled, from the
+		// second call to endFrame() on
+		profiler.endFrame();
+		profiler.setEnabled(true);
+		for (int i = 0; i < 4; ++i)
+			profiler.endFrame();
+
+		TS_ASSERT_EQUALS(profiler.getFrameCount(), 3u);
+		TS_ASSERT_EQUALS(profiler.getStats()["Frame"].count, 3u);
+	}
+};
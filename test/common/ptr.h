@@ -157,6 +157,26 @@ class PtrTestSuite : public CxxTest::TestSuite {
 		a = b;
 	}
 
+	struct CountedValue {
+		InstanceCountingClass instance;
+		int value;
+	};
+
+	void test_aliasing() {
+		Common::SharedPtr<int> alias;
+		{
+			Common::SharedPtr<CountedValue> p(new CountedValue());
+			p->value = 5;
+			alias = Common::SharedPtr<int>(p, &p->value);
+			TS_ASSERT_EQUALS(p.refCount(), 2);
+		}
+		// The alias keeps the whole object alive
+		TS_ASSERT_EQUALS(InstanceCountingClass::count, 1);
+		TS_ASSERT_EQUALS(*alias, 5);
+		alias.reset();
+		TS_ASSERT_EQUALS(InstanceCountingClass::count, 0);
+	}
+
 	void test_weak_ptr() {
 		Common::SharedPtr<B> b(new B);
 		Common::WeakPtr<A> a(b);
@@ -0,0 +1,46 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/spsc-queue.h"
+
+class SPSCQueueTestSuite : public CxxTest::TestSuite {
+public:
+	void test_push_pop() {
+		Common::SPSCQueue<int, 4> queue;
+		int x = -1;
+
+		TS_ASSERT(queue.empty());
+		TS_ASSERT(!queue.pop(x));
+		TS_ASSERT_EQUALS(x, -1);
+
+		TS_ASSERT(queue.push(1));
+		TS_ASSERT(queue.push(2));
+		TS_ASSERT(!queue.empty());
+
+		TS_ASSERT(queue.pop(x));
+		TS_ASSERT_EQUALS(x, 1);
+		TS_ASSERT(queue.pop(x));
+		TS_ASSERT_EQUALS(x, 2);
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_full_wraparound() {
+		Common::SPSCQueue<int, 4> queue;
+		int x;
+
+		TS_ASSERT_EQUALS(queue.capacity(), 4u);
+
+		for (int round = 0; round < 5; ++round) {
+			for (int i = 0; i < 4; ++i)
+				TS_ASSERT(queue.push(round * 10 + i));
+
+			TS_ASSERT(queue.full());
+			TS_ASSERT(!queue.push(99));
+
+			for (int i = 0; i < 4; ++i) {
+				TS_ASSERT(queue.pop(x));
+				TS_ASSERT_EQUALS(x, round * 10 + i);
+			}
+			TS_ASSERT(queue.empty());
+		}
+	}
+};
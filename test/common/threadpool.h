@@ -0,0 +1,66 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/threadpool.h"
+#include "common/array.h"
+
+static void threadPoolSquare(void *data, uint index) {
+	((uint *)data)[index] = index * index;
+}
+
+class ThreadPoolTestSuite : public CxxTest::TestSuite {
+public:
+	void test_run() {
+		Common::ThreadPool pool(4);
+		Common::Array<uint> values(1000, 0u);
+
+		TS_ASSERT_LESS_THAN_EQUALS(pool.getThreadCount(), 4u);
+
+		// Run several loops on the same pool to make sure the workers pick
+		// up each of them
+		for (uint round = 0; round < 20; ++round) {
+			values.resize(0);
+			values.resize(1000 + round, 0u);
+			pool.run(threadPoolSquare, values.data(), values.size());
+
+			for (uint i = 0; i < values.size(); ++i)
+				TS_ASSERT_EQUALS(values[i], i * i);
+		}
+	}
+
+	void test_parallel_for() {
+		Common::ThreadPool pool(3);
+		Common::Array<uint> counts(257, 0u);
+
+		pool.parallelFor(counts.size(), [&counts](uint index) {
+			counts[index]++;
+		});
+
+		for (uint i = 0; i < counts.size(); ++i)
+			TS_ASSERT_EQUALS(counts[i], 1u);
+
+		// Empty and single iteration loops
+		pool.parallelFor(0, [&counts](uint index) {
+			counts[index]++;
+		});
+		pool.parallelFor(1, [&counts](uint index) {
+			counts[index]++;
+		});
+		TS_ASSERT_EQUALS(counts[0], 2u);
+		TS_ASSERT_EQUALS(counts[1], 1u);
+	}
+
+	void test_nested() {
+		Common::ThreadPool pool(2);
+		Common::Array<uint> values(16 * 16, 0u);
+
+		// A loop started from within a task runs serially
+		pool.parallelFor(16, [&pool, &values](uint outer) {
+			pool.parallelFor(16, [&values, outer](uint inner) {
+				values[outer * 16 + inner] = outer + inner;
+			});
+		});
+
+		for (uint i = 0; i < values.size(); ++i)
+			TS_ASSERT_EQUALS(values[i], i / 16 + i % 16);
+	}
+};
@@ -0,0 +1,132 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirty_region.h"
+
+class DirtyRegionTestSuite : public CxxTest::TestSuite {
+private:
+	// Checks that the rects do not overlap and cover all tiles touched by
+	// the added rects, but nothing else
+	void checkCoverage(const Graphics::DirtyRegion &region, const Common::Array<Common::Rect> &added) {
+		const int w = region.getWidth(), h = region.getHeight(), tile = region.getTileSize();
+		Common::Array<byte> expected(w * h), actual(w * h);
+
+		for (uint i = 0; i < added.size(); i++) {
+			Common::Rect r(added[i]);
+			r.clip(Common::Rect(w, h));
+			if (r.isEmpty())
+				continue;
+			for (int y = r.top / tile * tile; y < MIN<int>((r.bottom + tile - 1) / tile * tile, h); y++)
+				for (int x = r.left / tile * tile; x < MIN<int>((r.right + tile - 1) / tile * tile, w); x++)
+					expected[y * w + x] = 1;
+		}
+
+		Common::Array<Common::Rect> rects;
+		region.getRects(rects);
+		for (uint i = 0; i < rects.size(); i++) {
+			TS_ASSERT(Common::Rect(w, h).contains(rects[i]));
+			for (int y = rects[i].top; y < rects[i].bottom; y++)
+				for (int x = rects[i].left; x < rects[i].right; x++)
+					actual[y * w + x]++;
+		}
+
+		TS_ASSERT(expected == actual);
+	}
+
+public:
+	void test_empty() {
+		Graphics::DirtyRegion region;
+		region.setSize(320, 200);
+		TS_ASSERT(region.isEmpty());
+
+		region.addRect(Common::Rect(320, 200, 400, 300));
+		region.addRect(Common::Rect(10, 10, 10, 20));
+		TS_ASSERT(region.isEmpty());
+		TS_ASSERT_EQUALS(region.getAddedPixels(), 0U);
+
+		Common::Array<Common::Rect> rects;
+		region.getRects(rects);
+		TS_ASSERT(rects.empty());
+	}
+
+	void test_snapToTiles() {
+		Graphics::DirtyRegion region(32);
+		region.setSize(320, 200);
+		region.addRect(Common::Rect(40, 10, 50, 40));
+
+		Common::Array<Common::Rect> rects;
+		region.getRects(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT(rects[0] == Common::Rect(32, 0, 64, 64));
+		TS_ASSERT_EQUALS(region.getAddedPixels(), 300U);
+	}
+
+	void test_overlapping() {
+		Graphics::DirtyRegion region(16);
+		region.setSize(320, 200);
+
+		// A mouse cursor moving in small steps
+		for (int i = 0; i < 200; i++)
+			region.addRect(Common::Rect(100 + i / 4, 50 + i / 8, 116 + i / 4, 66 + i / 8));
+
+		Common::Array<Common::Rect> rects;
+		region.getRects(rects);
+		uint32 pixels = 0;
+		for (uint i = 0; i < rects.size(); i++)
+			pixels += rects[i].width() * rects[i].height();
+
+		TS_ASSERT_EQUALS(region.getAddedPixels(), 200U * 16 * 16);
+		TS_ASSERT_LESS_THAN(pixels, region.getAddedPixels() / 10);
+	}
+
+	void test_full() {
+		Graphics::DirtyRegion region(32);
+		region.setSize(300, 190);
+		region.addRect(Common::Rect(0, 0, 150, 190));
+		TS_ASSERT(!region.isFull());
+		region.addRect(Common::Rect(150, 0, 300, 190));
+		TS_ASSERT(region.isFull());
+
+		Common::Array<Common::Rect> rects;
+		region.getRects(rects);
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT(rects[0] == Common::Rect(300, 190));
+
+		region.clear();
+		TS_ASSERT(region.isEmpty());
+		region.addAll();
+		TS_ASSERT(region.isFull());
+	}
+
+	void test_mergeRows() {
+		Graphics::DirtyRegion region(32);
+		region.setSize(640, 480);
+		region.addRect(Common::Rect(64, 64, 128, 200));
+		region.addRect(Common::Rect(300, 100, 310, 110));
+
+		Common::Array<Common::Rect> rects;
+		region.getRects(rects);
+		TS_ASSERT_EQUALS(rects.size(), 2U);
+		TS_ASSERT(rects[0] == Common::Rect(64, 64, 128, 224));
+		TS_ASSERT(rects[1] == Common::Rect(288, 96, 320, 128));
+	}
+
+	void test_random() {
+		uint32 seed = 1;
+		for (int pass = 0; pass < 20; pass++) {
+			Graphics::DirtyRegion region(8 + pass);
+			region.setSize(200 + pass * 3, 150 + pass * 5);
+
+			Common::Array<Common::Rect> added;
+			for (int i = 0; i < pass * 5; i++) {
+				seed = seed * 1103515245 + 12345;
+				int x = (seed >> 8) % 260 - 20, y = (seed >> 16) % 200 - 20;
+				seed = seed * 1103515245 + 12345;
+				Common::Rect r(x, y, x + (seed >> 8) % 60 + 1, y + (seed >> 16) % 60 + 1);
+				region.addRect(r);
+				added.push_back(r);
+			}
+
+			checkCoverage(region, added);
+		}
+	}
+};
@@ -0,0 +1,83 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/managed_surface.h"
+
+class ManagedSurfaceTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_transBlitCLUT8() {
+		Graphics::ManagedSurface src(4, 1, Graphics::PixelFormat::createFormatCLUT8());
+		Graphics::ManagedSurface dst(6, 1, Graphics::PixelFormat::createFormatCLUT8());
+		const byte srcPixels[] = { 1, 5, 2, 5 };
+		memcpy(src.getPixels(), srcPixels, sizeof(srcPixels));
+		dst.clear(9);
+
+		dst.transBlitFrom(src, Common::Point(1, 0), 5);
+		const byte expected[] = { 9, 1, 9, 2, 9, 9 };
+		TS_ASSERT_EQUALS(memcmp(dst.getPixels(), expected, sizeof(expected)), 0);
+
+		// Flipped and partially outside of the destination
+		dst.clear(9);
+		dst.transBlitFrom(src, Common::Point(-1, 0), 5, true);
+		const byte expectedFlipped[] = { 2, 9, 1, 9, 9, 9 };
+		TS_ASSERT_EQUALS(memcmp(dst.getPixels(), expectedFlipped, sizeof(expectedFlipped)), 0);
+
+		dst.clear(9);
+		dst.transBlitFrom(src, Common::Point(1, 0), 5, false, 7);
+		const byte expectedOverride[] = { 9, 7, 9, 7, 9, 9 };
+		TS_ASSERT_EQUALS(memcmp(dst.getPixels(), expectedOverride, sizeof(expectedOverride)), 0);
+	}
+
+	void test_transBlitCLUT8ToRGB() {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		Graphics::ManagedSurface src(2, 2, Graphics::PixelFormat::createFormatCLUT8());
+		Graphics::ManagedSurface dst(2, 2, format);
+		const byte palette[] = { 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255 };
+		src.setPalette(palette, 0, 4);
+		const byte srcPixels[] = { 1, 0, 2, 3 };
+		memcpy(src.getPixels(), srcPixels, sizeof(srcPixels));
+		dst.clear(format.ARGBToColor(255, 10, 20, 30));
+
+		dst.transBlitFrom(src, Common::Point(0, 0), 0);
+		TS_ASSERT_EQUALS(dst.getPixel(0, 0), format.ARGBToColor(255, 255, 0, 0));
+		TS_ASSERT_EQUALS(dst.getPixel(1, 0), format.ARGBToColor(255, 10, 20, 30));
+		TS_ASSERT_EQUALS(dst.getPixel(0, 1), format.ARGBToColor(255, 0, 255, 0));
+		TS_ASSERT_EQUALS(dst.getPixel(1, 1), format.ARGBToColor(255, 0, 0, 255));
+	}
+
+	void test_transBlitRGB565() {
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		Graphics::ManagedSurface src(3, 1, format);
+		Graphics::ManagedSurface dst(3, 1, format);
+		src.setPixel(0, 0, 0x1234);
+		src.setPixel(1, 0, 0xf81f);
+		src.setPixel(2, 0, 0xffff);
+		dst.clear(0x0841);
+
+		dst.transBlitFrom(src, Common::Point(0, 0), 0xf81f);
+		TS_ASSERT_EQUALS(dst.getPixel(0, 0), 0x1234u);
+		TS_ASSERT_EQUALS(dst.getPixel(1, 0), 0x0841u);
+		TS_ASSERT_EQUALS(dst.getPixel(2, 0), 0xffffu);
+	}
+
+	void test_transBlitARGB() {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		Graphics::ManagedSurface src(3, 1, format);
+		Graphics::ManagedSurface dst(3, 1, format);
+		src.setPixel(0, 0, format.ARGBToColor(255, 200, 100, 50));
+		src.setPixel(1, 0, format.ARGBToColor(0, 200, 100, 50));
+		src.setPixel(2, 0, format.ARGBToColor(128, 255, 255, 255));
+		dst.clear(format.ARGBToColor(255, 0, 0, 0));
+
+		dst.transBlitFrom(src, Common::Point(0, 0));
+		TS_ASSERT_EQUALS(dst.getPixel(0, 0), format.ARGBToColor(255, 200, 100, 50));
+		TS_ASSERT_EQUALS(dst.getPixel(1, 0), format.ARGBToColor(255, 0, 0, 0));
+		TS_ASSERT_EQUALS(dst.getPixel(2, 0), format.ARGBToColor(255, 128, 128, 128));
+
+		// The transparent color only compares the RGB values
+		dst.clear(format.ARGBToColor(255, 0, 0, 0));
+		dst.transBlitFrom(src, Common::Point(0, 0), format.ARGBToColor(0, 200, 100, 50));
+		TS_ASSERT_EQUALS(dst.getPixel(0, 0), format.ARGBToColor(255, 0, 0, 0));
+		TS_ASSERT_EQUALS(dst.getPixel(2, 0), format.ARGBToColor(255, 128, 128, 128));
+	}
+};
@@ -0,0 +1,119 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "graphics/surface.h"
+#include "graphics/scalerplugin.h"
+
+#ifdef USE_SCALERS
+#include "graphics/scaler/dotmatrix.h"
+#include "graphics/scaler/sai.h"
+#include "graphics/scaler/scalebit.h"
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+#endif
+
+class ScalerBandsTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Enough border for every scaler to look outside of the scaled rects
+	static const int kPadding = 4;
+
+	void createSource(Graphics::Surface &src, int width, int height, const Graphics::PixelFormat &format) {
+		src.create(width + kPadding * 2, height + kPadding * 2, format);
+
+		// Few colors, so that the scalers find plenty of edges to work on
+		uint32 seed = 12345;
+		for (int y = 0; y < src.h; y++) {
+			for (int x = 0; x < src.w; x++) {
+				seed = seed * 1103515245 + 12345;
+				uint8 c = (seed >> 28) * 16;
+				src.setPixel(x, y, format.RGBToColor(c, 255 - c, (c * 3) & 0xff));
+			}
+		}
+	}
+
+	void scale(Scaler *scaler, uint threads, const Graphics::Surface &src, Graphics::Surface &dst, const Common::Rect &r) {
+		scaler->setThreadCount(threads);
+		scaler->scale((const uint8 *)src.getBasePtr(r.left + kPadding, r.top + kPadding), src.pitch,
+		              (uint8 *)dst.getBasePtr(r.left * scaler->getFactor(), r.top * scaler->getFactor()), dst.pitch,
+		              r.width(), r.height(), r.left, r.top);
+	}
+
+	void compareBands(Scaler *scaler, uint factor, const Graphics::PixelFormat &format) {
+		const int width = 320, height = 200;
+		const Common::Rect rects[] = {
+			Common::Rect(0, 0, width, height),
+			Common::Rect(16, 3, 208, 197),
+			Common::Rect(64, 20, 96, 60)
+		};
+
+		Graphics::Surface src;
+		createSource(src, width, height, format);
+		scaler->setFactor(factor);
+
+		for (int i = 0; i < ARRAYSIZE(rects); i++) {
+			Graphics::Surface expected, actual;
+			expected.create(width * factor, height * factor, format);
+			actual.create(width * factor, height * factor, format);
+
+			scale(scaler, 1, src, expected, rects[i]);
+			scale(scaler, 7, src, actual, rects[i]);
+
+			TS_ASSERT_EQUALS(memcmp(expected.getPixels(), actual.getPixels(), expected.pitch * expected.h), 0);
+			expected.free();
+			actual.free();
+		}
+
+		src.free();
+		delete scaler;
+	}
+
+	void compareFormats(Scaler *(*create)(const Graphics::PixelFormat &), uint factor) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		for (int f = 0; f < ARRAYSIZE(formats); f++)
+			compareBands(create(formats[f]), factor, formats[f]);
+	}
+
+	template<class T>
+	static Scaler *createScaler(const Graphics::PixelFormat &format) {
+		return new T(format);
+	}
+
+public:
+	void test_advmame() {
+#ifdef USE_SCALERS
+		compareFormats(createScaler<AdvMameScaler>, 2);
+		compareFormats(createScaler<AdvMameScaler>, 3);
+		compareFormats(createScaler<AdvMameScaler>, 4);
+#endif
+	}
+
+	void test_sai() {
+#ifdef USE_SCALERS
+		compareFormats(createScaler<SAIScaler>, 2);
+		compareFormats(createScaler<SuperSAIScaler>, 2);
+		compareFormats(createScaler<SuperEagleScaler>, 2);
+#endif
+	}
+
+	void test_dotmatrix() {
+#ifdef USE_SCALERS
+		compareFormats(createScaler<DotMatrixScaler>, 2);
+#endif
+	}
+
+	void test_hq() {
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS)
+		compareFormats(createScaler<HQScaler>, 2);
+		compareFormats(createScaler<HQScaler>, 3);
+#endif
+	}
+};
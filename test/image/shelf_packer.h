@@ -0,0 +1,150 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/shelf_packer.h"
+
+class ShelfPackerTestSuite : public CxxTest::TestSuite {
+private:
+	// All rectangles must lie within the area and keep the gutter free
+	void checkLayout(const Graphics::ShelfPacker &packer, uint gutter) {
+		for (uint i = 0; i < packer.getIdCount(); i++) {
+			if (!packer.isUsed(i))
+				continue;
+
+			const Common::Rect &area = packer.getArea(i);
+			TS_ASSERT_LESS_THAN_EQUALS(0, area.left);
+			TS_ASSERT_LESS_THAN_EQUALS(0, area.top);
+			TS_ASSERT_LESS_THAN_EQUALS((uint)(area.right + gutter), packer.getWidth());
+			TS_ASSERT_LESS_THAN_EQUALS((uint)(area.bottom + gutter), packer.getHeight());
+
+			Common::Rect padded(area.left, area.top, area.right + gutter, area.bottom + gutter);
+			for (uint j = i + 1; j < packer.getIdCount(); j++) {
+				if (packer.isUsed(j))
+					TS_ASSERT(!padded.intersects(packer.getArea(j)));
+			}
+		}
+	}
+
+public:
+	void test_packing() {
+		Graphics::ShelfPacker packer(64, 32, 256, 1);
+
+		int a = packer.add(20, 10);
+		int b = packer.add(20, 10);
+		int c = packer.add(20, 5);
+		int d = packer.add(30, 12);
+		TS_ASSERT_EQUALS(a, 0);
+		TS_ASSERT_EQUALS(b, 1);
+		TS_ASSERT_EQUALS(c, 2);
+		TS_ASSERT_EQUALS(d, 3);
+
+		// Rectangles of the same height share a shelf, lower ones fill it up
+		TS_ASSERT_EQUALS(packer.getArea(a), Common::Rect(0, 0, 20, 10));
+		TS_ASSERT_EQUALS(packer.getArea(b), Common::Rect(21, 0, 41, 10));
+		TS_ASSERT_EQUALS(packer.getArea(c), Common::Rect(42, 0, 62, 5));
+		TS_ASSERT_EQUALS(packer.getArea(d), Common::Rect(0, 11, 30, 23));
+		checkLayout(packer, 1);
+
+		// Ids are handed out again once removed
+		packer.remove(b);
+		TS_ASSERT(!packer.isUsed(b));
+		TS_ASSERT_EQUALS(packer.add(8, 8), b);
+		TS_ASSERT_EQUALS(packer.getWidth(), 64u);
+		TS_ASSERT_EQUALS(packer.getHeight(), 32u);
+		checkLayout(packer, 1);
+	}
+
+	void test_repack() {
+		Graphics::ShelfPacker packer(64, 32, 256, 0);
+
+		// Four shelves, filling the whole area. No rectangles are moved.
+		Common::Array<Common::Rect> oldAreas(1, Common::Rect(1, 1));
+		int ids[8];
+		for (int i = 0; i < 8; i++) {
+			ids[i] = packer.add(32, 8, &oldAreas);
+			TS_ASSERT(oldAreas.empty());
+		}
+		TS_ASSERT_EQUALS(packer.getArea(ids[7]), Common::Rect(32, 24, 64, 32));
+
+		// The space of removed rectangles is only reclaimed by repacking
+		for (int i = 0; i < 8; i += 2)
+			packer.remove(ids[i]);
+
+		int id = packer.add(64, 16, &oldAreas);
+		TS_ASSERT_LESS_THAN_EQUALS(0, id);
+		TS_ASSERT_EQUALS(packer.getWidth(), 64u);
+		TS_ASSERT_EQUALS(packer.getHeight(), 32u);
+		TS_ASSERT_EQUALS(oldAreas.size(), 8u);
+		for (int i = 1; i < 8; i += 2) {
+			TS_ASSERT_EQUALS(oldAreas[ids[i]], Common::Rect(32, i / 2 * 8, 64, i / 2 * 8 + 8));
+			TS_ASSERT_EQUALS(packer.getArea(ids[i]).width(), 32);
+			TS_ASSERT_EQUALS(packer.getArea(ids[i]).height(), 8);
+		}
+		checkLayout(packer, 0);
+	}
+
+	void test_no_repack() {
+		Graphics::ShelfPacker packer(32, 32, 32, 0);
+
+		// Without removed rectangles at the maximum size, nothing is moved
+		Common::Array<Common::Rect> oldAreas;
+		TS_ASSERT_EQUALS(packer.add(32, 16), 0);
+		TS_ASSERT_EQUALS(packer.add(16, 8), 1);
+		TS_ASSERT_EQUALS(packer.add(16, 8), 2);
+		TS_ASSERT_EQUALS(packer.add(32, 16, &oldAreas), -1);
+		TS_ASSERT(oldAreas.empty());
+		TS_ASSERT_EQUALS(packer.getArea(0), Common::Rect(0, 0, 32, 16));
+		TS_ASSERT_EQUALS(packer.getArea(1), Common::Rect(0, 16, 16, 24));
+		TS_ASSERT_EQUALS(packer.getArea(2), Common::Rect(16, 16, 32, 24));
+
+		// Removing rectangles makes room again
+		packer.remove(1);
+		packer.remove(2);
+		TS_ASSERT_EQUALS(packer.add(32, 16, &oldAreas), 1);
+		TS_ASSERT_EQUALS(oldAreas.size(), 3u);
+		checkLayout(packer, 0);
+	}
+
+	void test_growth() {
+		Graphics::ShelfPacker packer(32, 32, 128, 1);
+
+		Common::Array<int> ids;
+		for (int i = 0; i < 40; i++) {
+			int id = packer.add(15, 7 + i % 3);
+			TS_ASSERT_LESS_THAN_EQUALS(0, id);
+			ids.push_back(id);
+		}
+
+		// The width is doubled first, then the height, up to the maximum
+		TS_ASSERT_LESS_THAN(32u, packer.getWidth());
+		TS_ASSERT_LESS_THAN_EQUALS(packer.getWidth(), 128u);
+		TS_ASSERT_LESS_THAN_EQUALS(packer.getHeight(), 128u);
+		TS_ASSERT_LESS_THAN_EQUALS(packer.getHeight(), packer.getWidth());
+		for (uint i = 0; i < ids.size(); i++) {
+			TS_ASSERT(packer.isUsed(ids[i]));
+			TS_ASSERT_EQUALS(packer.getArea(ids[i]).width(), 15);
+			TS_ASSERT_EQUALS(packer.getArea(ids[i]).height(), (int16)(7 + i % 3));
+		}
+		checkLayout(packer, 1);
+
+		// Rectangles that don't fit at the maximum size leave it as it was
+		const uint width = packer.getWidth(), height = packer.getHeight();
+		Common::Array<Common::Rect> areas;
+		for (uint i = 0; i < ids.size(); i++)
+			areas.push_back(packer.getArea(ids[i]));
+
+		TS_ASSERT_EQUALS(packer.add(128, 4), -1);
+		TS_ASSERT_EQUALS(packer.add(200, 1), -1);
+		TS_ASSERT_EQUALS(packer.getWidth(), width);
+		TS_ASSERT_EQUALS(packer.getHeight(), height);
+		for (uint i = 0; i < ids.size(); i++)
+			TS_ASSERT_EQUALS(packer.getArea(ids[i]), areas[i]);
+
+		// Filling the area up to its maximum size
+		int id;
+		while ((id = packer.add(60, 20)) >= 0)
+			ids.push_back(id);
+		TS_ASSERT_EQUALS(packer.getWidth(), 128u);
+		TS_ASSERT_EQUALS(packer.getHeight(), 128u);
+		checkLayout(packer, 1);
+	}
+};
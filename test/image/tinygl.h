@@ -0,0 +1,345 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/debug.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zspan.h"
+#endif
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class TinyGLTestSuite : public CxxTest::TestSuite
+{
+#ifdef USE_TINYGL
+private:
+	typedef void (TinyGLTestSuite::*DrawFunc)(TGLuint texture, TinyGL::BlitImage *image, int frame);
+
+	static const int kWidth = 320;
+	static const int kHeight = 240;
+
+	const TinyGL::ZSpanFuncs *getBestZSpanFuncs() {
+		const TinyGL::ZSpanFuncs *funcs = &TinyGL::zSpanFuncsGeneric;
+#ifdef SCUMMVM_NEON
+		funcs = &TinyGL::zSpanFuncsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs = &TinyGL::zSpanFuncsSSE2;
+#endif
+		return funcs;
+	}
+
+	// A table without any span fillers, which leaves everything to the per pixel code
+	static const TinyGL::ZSpanFuncs *getNoZSpanFuncs() {
+		static const TinyGL::ZSpanFuncs funcs = {};
+		return &funcs;
+	}
+
+	float nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return (seed >> 8) / 16777216.0f;
+	}
+
+	TGLuint createTexture() {
+		byte pixels[64 * 64 * 4];
+		for (int i = 0; i < 64 * 64; i++) {
+			pixels[i * 4 + 0] = (i * 7) & 0xff;
+			pixels[i * 4 + 1] = (i >> 6) * 4;
+			pixels[i * 4 + 2] = ((i & 63) ^ (i >> 6)) * 4;
+			pixels[i * 4 + 3] = (i & 8) ? 255 : 96;
+		}
+
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, TGL_NEAREST);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MAG_FILTER, TGL_NEAREST);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 64, 64, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, pixels);
+		return texture;
+	}
+
+	TinyGL::BlitImage *createBlitImage(const Graphics::PixelFormat &format) {
+		Graphics::Surface surface;
+		surface.create(48, 32, format);
+		for (int y = 0; y < surface.h; y++) {
+			for (int x = 0; x < surface.w; x++) {
+				surface.setPixel(x, y, format.ARGBToColor(255, x * 5, y * 8, 128));
+			}
+		}
+
+		TinyGL::BlitImage *image = tglGenBlitImage();
+		tglUploadBlitImage(image, surface, 0, false);
+		surface.free();
+		return image;
+	}
+
+	void drawTriangles(uint32 &seed, int count, float offset) {
+		tglBegin(TGL_TRIANGLES);
+		for (int i = 0; i < count * 3; i++) {
+			tglColor4f(nextRandom(seed), nextRandom(seed), nextRandom(seed), 0.5f + nextRandom(seed) * 0.5f);
+			tglVertex3f(nextRandom(seed) * 2.4f - 1.2f + offset, nextRandom(seed) * 2.4f - 1.2f, nextRandom(seed) * 2.0f - 1.0f);
+		}
+		tglEnd();
+	}
+
+	void drawFrame(TGLuint texture, TinyGL::BlitImage *image, int frame) {
+		uint32 seed = 4321;
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+		drawTriangles(seed, 40, 0.0f);
+
+		// Blits run serially, between the tiled draw calls
+		tglBlit(image, 40 + frame * 8, 100);
+
+		tglEnable(TGL_BLEND);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		tglEnable(TGL_TEXTURE_2D);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglBegin(TGL_QUADS);
+		for (int i = 0; i < 6; i++) {
+			float x = nextRandom(seed) * 1.6f - 1.0f, y = nextRandom(seed) * 1.6f - 1.0f;
+			tglColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+			tglTexCoord2f(0.0f, 0.0f);
+			tglVertex3f(x, y, 0.0f);
+			tglTexCoord2f(1.0f, 0.0f);
+			tglVertex3f(x + 0.5f, y, 0.1f);
+			tglTexCoord2f(1.0f, 1.0f);
+			tglVertex3f(x + 0.5f, y + 0.4f, 0.2f);
+			tglTexCoord2f(0.0f, 1.0f);
+			tglVertex3f(x, y + 0.4f, 0.1f);
+		}
+		tglEnd();
+		tglDisable(TGL_TEXTURE_2D);
+
+		tglBegin(TGL_LINES);
+		for (int i = 0; i < 20; i++) {
+			tglColor4f(nextRandom(seed), nextRandom(seed), nextRandom(seed), 1.0f);
+			tglVertex3f(nextRandom(seed) * 2.0f - 1.0f, nextRandom(seed) * 2.0f - 1.0f, 0.0f);
+		}
+		tglEnd();
+		tglDisable(TGL_BLEND);
+
+		// Only this part moves between the frames, leaving most of the frame untouched
+		tglShadeModel(TGL_FLAT);
+		drawTriangles(seed, 5, frame * 0.05f);
+		tglDisable(TGL_DEPTH_TEST);
+	}
+
+	void drawTexturedTriangles(uint32 &seed, int count) {
+		tglBegin(TGL_TRIANGLES);
+		for (int i = 0; i < count * 3; i++) {
+			tglColor4f(0.5f + nextRandom(seed) * 0.5f, 0.5f + nextRandom(seed) * 0.5f, 0.5f + nextRandom(seed) * 0.5f, nextRandom(seed));
+			tglTexCoord2f(nextRandom(seed) * 2.0f, nextRandom(seed) * 2.0f);
+			tglVertex3f(nextRandom(seed) * 2.4f - 1.2f, nextRandom(seed) * 2.4f - 1.2f, nextRandom(seed) * 2.0f - 1.0f);
+		}
+		tglEnd();
+	}
+
+	// Goes through every mode the span fillers handle, and a few they don't
+	void drawSpanModes(TGLuint texture, TinyGL::BlitImage *image, int frame) {
+		uint32 seed = 1234;
+
+		tglClearColor(0.3f, 0.2f, 0.1f, 0.5f);
+		tglClearDepth(1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		tglEnable(TGL_DEPTH_TEST);
+		tglDepthFunc(TGL_LESS);
+		tglShadeModel(TGL_SMOOTH);
+		drawTriangles(seed, 20, 0.0f);
+
+		tglDepthFunc(TGL_LEQUAL);
+		tglDepthMask(TGL_FALSE);
+		tglShadeModel(TGL_FLAT);
+		drawTriangles(seed, 10, 0.0f);
+		tglDepthMask(TGL_TRUE);
+
+		tglEnable(TGL_TEXTURE_2D);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglShadeModel(TGL_SMOOTH);
+		drawTexturedTriangles(seed, 10);
+
+		tglEnable(TGL_BLEND);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		drawTexturedTriangles(seed, 10);
+		tglShadeModel(TGL_FLAT);
+		drawTexturedTriangles(seed, 5);
+		tglDisable(TGL_TEXTURE_2D);
+		tglShadeModel(TGL_SMOOTH);
+		drawTriangles(seed, 10, 0.0f);
+
+		// Not handled by the span fillers
+		tglBlendFunc(TGL_ONE, TGL_ONE);
+		drawTriangles(seed, 5, 0.0f);
+		tglDisable(TGL_BLEND);
+		tglDepthFunc(TGL_GREATER);
+		drawTriangles(seed, 5, 0.0f);
+
+		tglDepthFunc(TGL_ALWAYS);
+		drawTriangles(seed, 5, 0.0f);
+		tglDisable(TGL_DEPTH_TEST);
+		tglDepthFunc(TGL_LESS);
+
+		tglEnable(TGL_TEXTURE_2D);
+		tglEnable(TGL_BLEND);
+		drawTexturedTriangles(seed, 5);
+		tglDisable(TGL_BLEND);
+		tglDisable(TGL_TEXTURE_2D);
+
+		// After the first frame, the dirty rects of these clip the spans of everything else
+		drawTriangles(seed, 3, frame * 0.05f);
+	}
+
+	void render(uint threads, Graphics::Surface *frames, int numFrames, DrawFunc draw = &TinyGLTestSuite::drawFrame,
+	            const Graphics::PixelFormat &format = Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)) {
+		TinyGL::ContextHandle *context = TinyGL::createContext(kWidth, kHeight, format, 256, false, true);
+		TinyGL::setThreadCount(threads);
+
+		TGLuint texture = createTexture();
+		TinyGL::BlitImage *image = createBlitImage(format);
+		for (int i = 0; i < numFrames; i++) {
+			(this->*draw)(texture, image, i);
+			TinyGL::presentBuffer();
+
+			Graphics::Surface surface;
+			TinyGL::getSurfaceRef(surface);
+			frames[i].copyFrom(surface);
+		}
+
+		tglDeleteBlitImage(image);
+		tglDeleteTextures(1, &texture);
+		TinyGL::destroyContext(context);
+	}
+#endif
+
+public:
+	void test_tiles() {
+#ifdef USE_TINYGL
+		const int numFrames = 3;
+		Graphics::Surface expected[numFrames], actual[numFrames];
+
+		TinyGL::zSpanFuncs = getBestZSpanFuncs();
+		render(1, expected, numFrames);
+		render(4, actual, numFrames);
+		TinyGL::zSpanFuncs = nullptr;
+
+		for (int i = 0; i < numFrames; i++) {
+			TS_ASSERT_EQUALS(memcmp(expected[i].getPixels(), actual[i].getPixels(), expected[i].pitch * expected[i].h), 0);
+			expected[i].free();
+			actual[i].free();
+		}
+#endif
+	}
+
+	void test_spans() {
+#ifdef USE_TINYGL
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0)
+		};
+		const TinyGL::ZSpanFuncs *funcs[] = { &TinyGL::zSpanFuncsGeneric, getBestZSpanFuncs() };
+		const int numFrames = 3;
+
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			Graphics::Surface expected[numFrames];
+			TinyGL::zSpanFuncs = getNoZSpanFuncs();
+			render(1, expected, numFrames, &TinyGLTestSuite::drawSpanModes, formats[f]);
+
+			for (int j = 0; j < ARRAYSIZE(funcs); j++) {
+				Graphics::Surface actual[numFrames];
+				TinyGL::zSpanFuncs = funcs[j];
+				render(1, actual, numFrames, &TinyGLTestSuite::drawSpanModes, formats[f]);
+
+				for (int i = 0; i < numFrames; i++) {
+					TS_ASSERT_EQUALS(memcmp(expected[i].getPixels(), actual[i].getPixels(), expected[i].pitch * expected[i].h), 0);
+					actual[i].free();
+				}
+			}
+
+			for (int i = 0; i < numFrames; i++)
+				expected[i].free();
+		}
+		TinyGL::zSpanFuncs = nullptr;
+#endif
+	}
+
+	void test_speed() {
+#if defined(USE_TINYGL) && BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int numFrames = 200;
+#else
+		const int numFrames = 10;
+#endif
+		const int numTriangles = 300;
+
+		const char *names[] = { "per pixel", "generic spans", "SIMD spans" };
+		const TinyGL::ZSpanFuncs *funcs[] = { getNoZSpanFuncs(), &TinyGL::zSpanFuncsGeneric, getBestZSpanFuncs() };
+
+		// The span fillers are chosen here, the null system can't be queried for the CPU features
+		TinyGL::zSpanFuncs = funcs[0];
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		TinyGL::ContextHandle *context = TinyGL::createContext(640, 480, format, 256, false, false);
+		TGLuint texture = createTexture();
+
+		for (int i = 0; i < ARRAYSIZE(funcs); i++) {
+			TinyGL::zSpanFuncs = funcs[i];
+
+			uint32 start = g_system->getMillis();
+			for (int j = 0; j < numFrames; j++) {
+				uint32 seed = 4321;
+				tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+				tglEnable(TGL_DEPTH_TEST);
+				tglShadeModel(TGL_SMOOTH);
+				drawTriangles(seed, numTriangles, 0.0f);
+				tglEnable(TGL_TEXTURE_2D);
+				tglBindTexture(TGL_TEXTURE_2D, texture);
+				tglEnable(TGL_BLEND);
+				tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+				drawTexturedTriangles(seed, numTriangles);
+				tglDisable(TGL_BLEND);
+				tglDisable(TGL_TEXTURE_2D);
+				tglDisable(TGL_DEPTH_TEST);
+				TinyGL::presentBuffer();
+			}
+			uint32 time = MAX<uint32>(g_system->getMillis() - start, 1);
+
+			debug("TinyGL triangles with %s: %.1f Ktriangles/s", names[i], numTriangles * 2.0 * numFrames / time);
+		}
+		TinyGL::zSpanFuncs = nullptr;
+
+		tglDeleteTextures(1, &texture);
+		TinyGL::destroyContext(context);
+#endif
+	}
+};
@@ -0,0 +1,265 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/debug.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/system.h"
+#include "common/ustr.h"
+#include "graphics/font.h"
+#include "graphics/fonts/ttf.h"
+#include "graphics/managed_surface.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class TTFTestSuite : public CxxTest::TestSuite
+{
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+private:
+	Graphics::Font *loadFont(int size, Graphics::TTFRenderMode renderMode) {
+		Common::File file;
+		if (!file.open(Common::FSNode("test/engine-data/FreeSans.ttf")))
+			return nullptr;
+
+		return Graphics::loadTTFFont(file, size, Graphics::kTTFSizeModeCharacter, 0, renderMode);
+	}
+
+	// What drawString did before it handed whole runs to the font
+	void drawStringByChar(const Graphics::Font &font, Graphics::ManagedSurface &dst, const Common::U32String &str, int x, int y, int w, uint32 color) {
+		const int leftX = x, rightX = x + w + 1;
+
+		uint32 last = 0;
+		for (uint i = 0; i < str.size(); i++) {
+			const uint32 cur = str[i];
+			x += font.getKerningOffset(last, cur);
+			last = cur;
+
+			Common::Rect charBox = font.getBoundingBox(cur);
+			if (x + charBox.right > rightX)
+				break;
+			if (x + charBox.right >= leftX)
+				font.drawChar(&dst, cur, x, y, color);
+
+			x += font.getCharWidth(cur);
+		}
+	}
+
+	bool sameSurfaces(const Graphics::ManagedSurface &a, const Graphics::ManagedSurface &b) {
+		for (int y = 0; y < a.h; y++) {
+			if (memcmp(a.getBasePtr(0, y), b.getBasePtr(0, y), a.w * a.format.bytesPerPixel))
+				return false;
+		}
+		return true;
+	}
+
+	// A line of text with kerning pairs, overlapping glyphs and several scripts
+	Common::U32String getSampleText() {
+		return Common::U32String("AVAWAY Ty fifl \xC3\xA0\xC3\xA9\xC3\xAE\xC3\xB5\xC3\xBC \xCE\xB1\xCE\xB2\xCE\xB3 \xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 jjj ///", Common::kUtf8);
+	}
+
+	// Random words in the scripts FreeSans covers
+	Common::U32String makeCorpus(uint numWords) {
+		static const uint32 ranges[][2] = {
+			{ 0x61, 0x7a }, { 0xe0, 0xff }, { 0x100, 0x17f }, { 0x3b1, 0x3c9 }, { 0x430, 0x44f }
+		};
+
+		Common::U32String corpus;
+		uint32 seed = 1234;
+		for (uint i = 0; i < numWords; i++) {
+			seed = seed * 1103515245 + 12345;
+			const uint32 *range = ranges[(seed >> 16) % ARRAYSIZE(ranges)];
+			seed = seed * 1103515245 + 12345;
+			uint length = 2 + (seed >> 16) % 9;
+
+			for (uint j = 0; j < length; j++) {
+				seed = seed * 1103515245 + 12345;
+				corpus += (Common::u32char_type_t)(range[0] + (seed >> 16) % (range[1] - range[0] + 1));
+			}
+			corpus += ' ';
+		}
+		return corpus;
+	}
+#endif
+
+public:
+	void test_drawString() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Graphics::Font *font = loadFont(18, Graphics::kTTFRenderModeNormal);
+		TS_ASSERT(font != nullptr);
+		if (!font)
+			return;
+
+		const Common::U32String text = getSampleText();
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat::createFormatCLUT8()
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(formats); i++) {
+			Graphics::ManagedSurface runs(200, 40, formats[i]);
+			Graphics::ManagedSurface chars(200, 40, formats[i]);
+			const uint32 background = formats[i].isCLUT8() ? 3 : formats[i].ARGBToColor(128, 20, 40, 60);
+			const uint32 color = formats[i].isCLUT8() ? 7 : formats[i].RGBToColor(250, 200, 100);
+
+			// Clipped on all sides, and the text is longer than the area
+			const int positions[][3] = { { 2, 4, 196 }, { -7, -9, 300 }, { 30, 28, 120 } };
+			for (uint j = 0; j < ARRAYSIZE(positions); j++) {
+				runs.clear(background);
+				chars.clear(background);
+				font->drawString(&runs, text, positions[j][0], positions[j][1], positions[j][2], color);
+				drawStringByChar(*font, chars, text, positions[j][0], positions[j][1], positions[j][2], color);
+				TS_ASSERT(sameSurfaces(runs, chars));
+			}
+
+			// The transparent color counts as a transparent background
+			runs.clear(background);
+			chars.clear(background);
+			runs.setTransparentColor(background);
+			chars.setTransparentColor(background);
+			font->drawString(&runs, text, 2, 4, 196, color);
+			drawStringByChar(*font, chars, text, 2, 4, 196, color);
+			TS_ASSERT(sameSurfaces(runs, chars));
+		}
+
+		delete font;
+#endif
+	}
+
+	void test_sharedGlyphs() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Graphics::Font *font = loadFont(16, Graphics::kTTFRenderModeNormal);
+		Graphics::Font *sameFont = loadFont(16, Graphics::kTTFRenderModeNormal);
+		Graphics::Font *monoFont = loadFont(16, Graphics::kTTFRenderModeMonochrome);
+		TS_ASSERT(font && sameFont && monoFont);
+		if (!font || !sameFont || !monoFont)
+			return;
+
+		const Common::U32String text = getSampleText();
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		const uint32 background = format.ARGBToColor(255, 0, 0, 0);
+		const uint32 color = format.ARGBToColor(255, 255, 255, 255);
+
+		Graphics::ManagedSurface first(200, 30, format);
+		Graphics::ManagedSurface second(200, 30, format);
+		first.clear(background);
+		second.clear(background);
+		font->drawString(&first, text, 0, 4, 200, color);
+		delete font;
+		sameFont->drawString(&second, text, 0, 4, 200, color);
+		TS_ASSERT(sameSurfaces(first, second));
+
+		// Fonts rendered with another mode do not get the same glyphs
+		second.clear(background);
+		monoFont->drawString(&second, text, 0, 4, 200, color);
+		bool antialiased = false;
+		for (int y = 0; y < second.h; y++) {
+			for (int x = 0; x < second.w; x++) {
+				uint32 pixel = second.getPixel(x, y);
+				if (pixel != background && pixel != color)
+					antialiased = true;
+			}
+		}
+		TS_ASSERT(!antialiased);
+		TS_ASSERT(!sameSurfaces(first, second));
+
+		delete sameFont;
+		delete monoFont;
+#endif
+	}
+
+	void test_glyphEviction() {
+#if defined(USE_FREETYPE2) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Graphics::Font *font = loadFont(64, Graphics::kTTFRenderModeLight);
+		TS_ASSERT(font != nullptr);
+		if (!font)
+			return;
+
+		const Common::U32String text = getSampleText();
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		const uint32 color = format.RGBToColor(255, 255, 255);
+
+		Graphics::ManagedSurface before(400, 80, format);
+		Graphics::ManagedSurface after(400, 80, format);
+		before.clear(0);
+		after.clear(0);
+		font->drawString(&before, text, 0, 0, 400, color);
+
+		// Draw more large glyphs than the glyph atlas keeps
+		Graphics::ManagedSurface scratch(400, 80, format);
+		for (uint32 chr = 0x20; chr < 0x500; chr++)
+			font->drawChar(&scratch, chr, 0, 0, color);
+
+		font->drawString(&after, text, 0, 0, 400, color);
+		TS_ASSERT(sameSurfaces(before, after));
+
+		delete font;
+#endif
+	}
+
+	void test_speed() {
+#if defined(USE_FREETYPE2) && BENCHMARK_TIME
+		Common::install_null_g_system();
+
+		Graphics::Font *font = loadFont(14, Graphics::kTTFRenderModeLight);
+		TS_ASSERT(font != nullptr);
+		if (!font)
+			return;
+
+#ifdef SLOW_TESTS
+		const uint numWords = 200000;
+#else
+		const uint numWords = 20000;
+#endif
+		const Common::U32String corpus = makeCorpus(numWords);
+
+		uint32 start = g_system->getMillis();
+		Common::Array<Common::U32String> lines;
+		font->wordWrapText(corpus, 600, lines);
+		uint32 time = MAX<uint32>(g_system->getMillis() - start, 1);
+
+		debug("TTF word wrapping: %.1f Kwords/s", numWords * 1.0 / time);
+
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat::createFormatCLUT8()
+		};
+		const char *names[] = { "ARGB8888", "RGB565", "CLUT8" };
+
+		for (uint i = 0; i < ARRAYSIZE(formats); i++) {
+			Graphics::ManagedSurface dst(640, 480, formats[i]);
+			dst.clear(0);
+
+			const int lineHeight = font->getFontHeight();
+			uint numChars = 0;
+			start = g_system->getMillis();
+			for (uint j = 0; j < lines.size(); j++) {
+				int y = (j * lineHeight) % (dst.h - lineHeight);
+				font->drawString(&dst, lines[j], 20, y, 600, formats[i].isCLUT8() ? 15 : formats[i].RGBToColor(255, 255, 255));
+				numChars += lines[j].size();
+			}
+			time = MAX<uint32>(g_system->getMillis() - start, 1);
+
+			debug("TTF text drawing to %s: %.1f Kchars/s", names[i], numChars * 1.0 / time);
+		}
+
+		delete font;
+#endif
+	}
+};
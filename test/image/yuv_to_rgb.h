@@ -0,0 +1,218 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/debug.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum Subsampling {
+		kYUV444,
+		kYUV422,
+		kYUV420,
+		kYUV420Alpha,
+		kYUV410
+	};
+
+	struct Planes {
+		int width, height;
+		int yPitch, uvPitch;
+		byte *y, *u, *v, *a;
+	};
+
+	const Graphics::YUVToRGBFuncs *getBestYUVToRGBFuncs() {
+		const Graphics::YUVToRGBFuncs *funcs = &Graphics::yuvToRGBFuncsGeneric;
+#ifdef SCUMMVM_NEON
+		funcs = &Graphics::yuvToRGBFuncsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			funcs = &Graphics::yuvToRGBFuncsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			funcs = &Graphics::yuvToRGBFuncsAVX2;
+#endif
+		return funcs;
+	}
+
+	// The chroma planes get an extra row and column, which YUV410 needs.
+	// With sweep, u follows the chroma column and v the chroma row.
+	void createPlanes(Planes &planes, int width, int height, bool sweep) {
+		planes.width = width;
+		planes.height = height;
+		planes.yPitch = width + 3;
+		planes.uvPitch = width + 5;
+		planes.y = new byte[planes.yPitch * height];
+		planes.a = new byte[planes.yPitch * height];
+		planes.u = new byte[planes.uvPitch * (height + 1)];
+		planes.v = new byte[planes.uvPitch * (height + 1)];
+
+		uint32 seed = 12345;
+		for (int i = 0; i < planes.yPitch * height; i++) {
+			seed = seed * 1103515245 + 12345;
+			planes.y[i] = seed >> 24;
+			planes.a[i] = seed >> 16;
+		}
+		for (int i = 0; i < planes.uvPitch * (height + 1); i++) {
+			seed = seed * 1103515245 + 12345;
+			planes.u[i] = sweep ? (i % planes.uvPitch) : (seed >> 24);
+			planes.v[i] = sweep ? (i / planes.uvPitch) : (seed >> 16);
+		}
+	}
+
+	void destroyPlanes(Planes &planes) {
+		delete[] planes.y;
+		delete[] planes.u;
+		delete[] planes.v;
+		delete[] planes.a;
+	}
+
+	void convert(Graphics::Surface &dst, Subsampling subsampling, Graphics::YUVToRGBManager::LuminanceScale scale, const Planes &planes) {
+		switch (subsampling) {
+		case kYUV444:
+			YUVToRGBMan.convert444(&dst, scale, planes.y, planes.u, planes.v, planes.width, planes.height, planes.yPitch, planes.uvPitch);
+			break;
+		case kYUV422:
+			YUVToRGBMan.convert422(&dst, scale, planes.y, planes.u, planes.v, planes.width, planes.height, planes.yPitch, planes.uvPitch);
+			break;
+		case kYUV420:
+			YUVToRGBMan.convert420(&dst, scale, planes.y, planes.u, planes.v, planes.width, planes.height, planes.yPitch, planes.uvPitch);
+			break;
+		case kYUV420Alpha:
+			YUVToRGBMan.convert420Alpha(&dst, scale, planes.y, planes.u, planes.v, planes.a, planes.width, planes.height, planes.yPitch, planes.uvPitch);
+			break;
+		case kYUV410:
+			YUVToRGBMan.convert410(&dst, scale, planes.y, planes.u, planes.v, planes.width, planes.height, planes.yPitch, planes.uvPitch);
+			break;
+		}
+	}
+
+	void compareTemplate(Subsampling subsampling, const Graphics::PixelFormat &format, int width, int height, bool sweep) {
+		const Graphics::YUVToRGBFuncs *best = getBestYUVToRGBFuncs();
+		const Graphics::YUVToRGBManager::LuminanceScale scales[] = { Graphics::YUVToRGBManager::kScaleFull, Graphics::YUVToRGBManager::kScaleITU };
+
+		Planes planes;
+		createPlanes(planes, width, height, sweep);
+
+		for (int s = 0; s < ARRAYSIZE(scales); s++) {
+			Graphics::Surface expected, actual;
+			expected.create(width, height, format);
+			actual.create(width, height, format);
+
+			Graphics::yuvToRGBFuncs = &Graphics::yuvToRGBFuncsGeneric;
+			convert(expected, subsampling, scales[s], planes);
+			Graphics::yuvToRGBFuncs = best;
+			convert(actual, subsampling, scales[s], planes);
+
+			TS_ASSERT_EQUALS(memcmp(expected.getPixels(), actual.getPixels(), expected.pitch * height), 0);
+			expected.free();
+			actual.free();
+		}
+
+		Graphics::yuvToRGBFuncs = nullptr;
+		destroyPlanes(planes);
+	}
+
+	void compareFormats(Subsampling subsampling) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 4, 4, 4, 4, 12, 8, 4, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0)
+		};
+
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			// Widths that leave a few pixels for the scalar code
+			compareTemplate(subsampling, formats[f], 260, 256, true);
+			compareTemplate(subsampling, formats[f], 84, 20, false);
+		}
+	}
+
+	void benchmark(const char *name, Subsampling subsampling, const Graphics::PixelFormat &format, const Planes &planes, int iters) {
+		Graphics::Surface dst;
+		dst.create(planes.width, planes.height, format);
+
+		const Graphics::YUVToRGBFuncs *funcs[] = { &Graphics::yuvToRGBFuncsGeneric, getBestYUVToRGBFuncs() };
+		uint32 time[2];
+		for (int i = 0; i < 2; i++) {
+			Graphics::yuvToRGBFuncs = funcs[i];
+			uint32 start = g_system->getMillis();
+			for (int j = 0; j < iters; j++)
+				convert(dst, subsampling, Graphics::YUVToRGBManager::kScaleITU, planes);
+			time[i] = MAX<uint32>(g_system->getMillis() - start, 1);
+		}
+		Graphics::yuvToRGBFuncs = nullptr;
+		dst.free();
+
+		double mpixels = (double)planes.width * planes.height * iters / 1000000.0;
+		debug("%s to %dbpp: generic %.1f Mpixels/s, SIMD %.1f Mpixels/s", name, format.bytesPerPixel * 8,
+		      mpixels * 1000.0 / time[0], mpixels * 1000.0 / time[1]);
+	}
+
+public:
+	void test_convert444() {
+		compareFormats(kYUV444);
+	}
+
+	void test_convert422() {
+		compareFormats(kYUV422);
+	}
+
+	void test_convert420() {
+		compareFormats(kYUV420);
+	}
+
+	void test_convert420Alpha() {
+		compareFormats(kYUV420Alpha);
+	}
+
+	void test_convert410() {
+		compareFormats(kYUV410);
+	}
+
+	void test_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 100;
+#else
+		const int iters = 5;
+#endif
+
+		Planes planes;
+		createPlanes(planes, 1920, 1080, false);
+
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+		for (int f = 0; f < ARRAYSIZE(formats); f++) {
+			benchmark("YUV444", kYUV444, formats[f], planes, iters);
+			benchmark("YUV422", kYUV422, formats[f], planes, iters);
+			benchmark("YUV420", kYUV420, formats[f], planes, iters);
+			benchmark("YUV420 with alpha", kYUV420Alpha, formats[f], planes, iters);
+			benchmark("YUV410", kYUV410, formats[f], planes, iters);
+		}
+
+		destroyPlanes(planes);
+#endif
+	}
+};
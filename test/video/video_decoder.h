@@ -0,0 +1,161 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/video_decoder.h"
+#include "common/array.h"
+#include "graphics/surface.h"
+
+/** A video of a few frames at 10 fps, each filled with its frame number. */
+class TestVideoDecoder : public Video::VideoDecoder {
+public:
+	explicit TestVideoDecoder(bool decodeAheadSupported) : _decodeAheadSupported(decodeAheadSupported) {}
+	~TestVideoDecoder() { close(); }
+
+	bool loadStream(Common::SeekableReadStream *stream) override {
+		close();
+		addTrack(new TestVideoTrack());
+		return true;
+	}
+
+protected:
+	bool supportsDecodeAhead() const override { return _decodeAheadSupported; }
+
+private:
+	class TestVideoTrack : public FixedRateVideoTrack {
+	public:
+		TestVideoTrack() : _curFrame(-1) {
+			_surface.create(8, 4, Graphics::PixelFormat::createFormatCLUT8());
+		}
+
+		~TestVideoTrack() { _surface.free(); }
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return 5; }
+
+		bool isSeekable() const override { return true; }
+		bool seek(const Audio::Timestamp &time) override {
+			_curFrame = (int)getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame++;
+			_surface.fillRect(Common::Rect(_surface.w, _surface.h), _curFrame);
+			return &_surface;
+		}
+
+	protected:
+		Common::Rational getFrameRate() const override { return 10; }
+
+	private:
+		int _curFrame;
+		Graphics::Surface _surface;
+	};
+
+	bool _decodeAheadSupported;
+};
+
+/** What the decoder reports before decoding a frame, and the frame decoded. */
+struct VideoDecoderState {
+	int curFrame;
+	uint32 timeToNextFrame;
+	bool needsUpdate;
+	bool endOfVideo;
+	int pixel;
+
+	bool operator==(const VideoDecoderState &other) const {
+		return curFrame == other.curFrame && timeToNextFrame == other.timeToNextFrame &&
+		       needsUpdate == other.needsUpdate && endOfVideo == other.endOfVideo && pixel == other.pixel;
+	}
+};
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+public:
+	void test_decode_ahead_opt_in() {
+		TestVideoDecoder decoder(false);
+		decoder.loadStream(nullptr);
+		TS_ASSERT(!decoder.setDecodeAhead(2));
+
+		TestVideoDecoder aheadDecoder(true);
+		aheadDecoder.loadStream(nullptr);
+		TS_ASSERT(!aheadDecoder.setDecodeAhead(0));
+		TS_ASSERT(aheadDecoder.setDecodeAhead(2));
+		// Only once, and not after a frame was decoded
+		TS_ASSERT(!aheadDecoder.setDecodeAhead(2));
+
+		aheadDecoder.loadStream(nullptr);
+		aheadDecoder.decodeNextFrame();
+		TS_ASSERT(!aheadDecoder.setDecodeAhead(2));
+	}
+
+	void test_timing_contract() {
+		Common::Array<VideoDecoderState> serial = playVideo(0);
+
+		// The decoder is not started, so its time stays at 0 and each frame
+		// is due 100 ms after the previous one
+		TS_ASSERT_EQUALS(serial.size(), 12u);
+		for (uint i = 0; i < 5; i++) {
+			TS_ASSERT_EQUALS(serial[i].curFrame, (int)i - 1);
+			TS_ASSERT_EQUALS(serial[i].timeToNextFrame, i * 100);
+			TS_ASSERT_EQUALS(serial[i].needsUpdate, i == 0);
+			TS_ASSERT(!serial[i].endOfVideo);
+			TS_ASSERT_EQUALS(serial[i].pixel, (int)i);
+		}
+		TS_ASSERT_EQUALS(serial[5].curFrame, 4);
+		TS_ASSERT_EQUALS(serial[5].timeToNextFrame, 0u);
+		TS_ASSERT(!serial[5].needsUpdate);
+		TS_ASSERT(serial[5].endOfVideo);
+
+		// Rewinding starts over with the first frame
+		TS_ASSERT_EQUALS(serial[6].curFrame, -1);
+		TS_ASSERT(serial[6].needsUpdate);
+		TS_ASSERT_EQUALS(serial[6].pixel, 0);
+
+		for (uint frames = 1; frames <= 6; frames++) {
+			Common::Array<VideoDecoderState> ahead = playVideo(frames);
+			TS_ASSERT_EQUALS(ahead.size(), serial.size());
+			for (uint i = 0; i < ahead.size() && i < serial.size(); i++)
+				TS_ASSERT(ahead[i] == serial[i]);
+		}
+	}
+
+private:
+	static VideoDecoderState getState(Video::VideoDecoder &decoder) {
+		VideoDecoderState state;
+		state.curFrame = decoder.getCurFrame();
+		state.timeToNextFrame = decoder.getTimeToNextFrame();
+		state.needsUpdate = decoder.needsUpdate();
+		state.endOfVideo = decoder.endOfVideo();
+		state.pixel = -1;
+		return state;
+	}
+
+	static void decodeFrame(Video::VideoDecoder &decoder, Common::Array<VideoDecoderState> &states) {
+		VideoDecoderState state = getState(decoder);
+		const Graphics::Surface *frame = decoder.decodeNextFrame();
+		if (frame)
+			state.pixel = *(const byte *)frame->getBasePtr(frame->w - 1, frame->h - 1);
+		states.push_back(state);
+	}
+
+	/** Decode all frames, rewind and decode some of them again. */
+	static Common::Array<VideoDecoderState> playVideo(uint decodeAheadFrames) {
+		TestVideoDecoder decoder(true);
+		decoder.loadStream(nullptr);
+		if (decodeAheadFrames)
+			TS_ASSERT(decoder.setDecodeAhead(decodeAheadFrames));
+
+		Common::Array<VideoDecoderState> states;
+		while (!decoder.endOfVideo())
+			decodeFrame(decoder, states);
+		states.push_back(getState(decoder));
+
+		TS_ASSERT(decoder.rewind());
+		for (uint i = 0; i < 5; i++)
+			decodeFrame(decoder, states);
+		states.push_back(getState(decoder));
+		return states;
+	}
+};
@@ -0,0 +1,218 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "video/decode_ahead.h"
+#include "graphics/blit.h"
+
+#ifdef USE_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Video {
+
+DecodedFrame::DecodedFrame() : hasFrame(false), dirtyPalette(false), curFrame(-1), nextFrameStartTime(0), endOfTrack(false) {
+	memset(palette, 0, sizeof(palette));
+}
+
+DecodedFrame::~DecodedFrame() {
+	surface.free();
+}
+
+void DecodedFrame::setFrame(const Graphics::Surface *frame) {
+	hasFrame = (frame != nullptr);
+	if (!frame)
+		return;
+
+	if (surface.w != frame->w || surface.h != frame->h || surface.format != frame->format)
+		surface.create(frame->w, frame->h, frame->format);
+
+	Graphics::copyBlit((byte *)surface.getPixels(), (const byte *)frame->getPixels(), surface.pitch, frame->pitch,
+	                   frame->w, frame->h, frame->format.bytesPerPixel);
+}
+
+#ifdef USE_THREADS
+
+class DecodeAheadQueueImpl {
+public:
+	DecodeAheadQueueImpl(uint numFrames, DecodeAheadQueue::DecodeFunc func, void *data);
+	~DecodeAheadQueueImpl();
+
+	const DecodedFrame *pop();
+	void stop();
+	void clear();
+
+private:
+	void workerMain();
+
+	DecodeAheadQueue::DecodeFunc _func;
+	void *_data;
+
+	// A ring of the queued frames, with one more slot for the frame that was
+	// popped last. The worker never writes to that one.
+	DecodedFrame *_frames;
+	uint _numFrames;
+	uint _head;
+	uint _count;
+	bool _ended;
+
+	std::thread _worker;
+	bool _running;
+	bool _stopRequested;
+	std::mutex _mutex;
+	std::condition_variable _cond;
+};
+
+DecodeAheadQueueImpl::DecodeAheadQueueImpl(uint numFrames, DecodeAheadQueue::DecodeFunc func, void *data)
+	: _func(func), _data(data), _frames(new DecodedFrame[numFrames + 1]), _numFrames(numFrames),
+	  _head(0), _count(0), _ended(false), _running(false), _stopRequested(false) {
+}
+
+DecodeAheadQueueImpl::~DecodeAheadQueueImpl() {
+	stop();
+	delete[] _frames;
+}
+
+const DecodedFrame *DecodeAheadQueueImpl::pop() {
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	if (!_running && !_ended) {
+		_running = true;
+		_worker = std::thread(&DecodeAheadQueueImpl::workerMain, this);
+	}
+
+	_cond.wait(lock, [this] { return _count > 0 || _ended; });
+	if (_count == 0)
+		return nullptr;
+
+	uint slot = _head;
+	_head = (_head + 1) % (_numFrames + 1);
+	_count--;
+	lock.unlock();
+
+	_cond.notify_all();
+	return &_frames[slot];
+}
+
+void DecodeAheadQueueImpl::stop() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopRequested = true;
+	}
+	_cond.notify_all();
+
+	if (_worker.joinable())
+		_worker.join();
+
+	_running = false;
+	_stopRequested = false;
+}
+
+void DecodeAheadQueueImpl::clear() {
+	stop();
+
+	_head = 0;
+	_count = 0;
+	_ended = false;
+}
+
+void DecodeAheadQueueImpl::workerMain() {
+	for (;;) {
+		uint slot;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cond.wait(lock, [this] { return _stopRequested || _count < _numFrames; });
+			if (_stopRequested)
+				return;
+			slot = (_head + _count) % (_numFrames + 1);
+		}
+
+		// The slot is not part of the queue yet, so it can be filled
+		// without holding the lock
+		_func(_data, _frames[slot]);
+
+		bool ended = _frames[slot].endOfTrack;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_count++;
+			_ended = ended;
+		}
+		_cond.notify_all();
+
+		if (ended)
+			return;
+	}
+}
+
+#else
+
+class DecodeAheadQueueImpl {
+public:
+	DecodeAheadQueueImpl(uint numFrames, DecodeAheadQueue::DecodeFunc func, void *data)
+		: _func(func), _data(data), _ended(false) {}
+
+	const DecodedFrame *pop() {
+		if (_ended)
+			return nullptr;
+
+		_func(_data, _frame);
+		_ended = _frame.endOfTrack;
+		return &_frame;
+	}
+
+	void stop() {}
+	void clear() { _ended = false; }
+
+private:
+	DecodeAheadQueue::DecodeFunc _func;
+	void *_data;
+	DecodedFrame _frame;
+	bool _ended;
+};
+
+#endif
+
+DecodeAheadQueue::DecodeAheadQueue(uint numFrames, DecodeFunc func, void *data) {
+	assert(numFrames > 0);
+	_impl = new DecodeAheadQueueImpl(numFrames, func, data);
+}
+
+DecodeAheadQueue::~DecodeAheadQueue() {
+	delete _impl;
+}
+
+const DecodedFrame *DecodeAheadQueue::pop() {
+	return _impl->pop();
+}
+
+void DecodeAheadQueue::stop() {
+	_impl->stop();
+}
+
+void DecodeAheadQueue::clear() {
+	_impl->clear();
+}
+
+} // End of namespace Video
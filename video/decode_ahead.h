@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef VIDEO_DECODE_AHEAD_H
+#define VIDEO_DECODE_AHEAD_H
+
+#include "common/scummsys.h"
+#include "graphics/surface.h"
+
+namespace Video {
+
+/**
+ * A video frame that was decoded ahead of its presentation, together with
+ * the state of its track right after decoding it.
+ */
+struct DecodedFrame {
+	DecodedFrame();
+	~DecodedFrame();
+
+	/**
+	 * Copy @p frame into the surface, reusing its pixels when the size and
+	 * format did not change. A null frame is remembered as such.
+	 */
+	void setFrame(const Graphics::Surface *frame);
+
+	/** Copy of the decoded frame, only valid if hasFrame is set. */
+	Graphics::Surface surface;
+	bool hasFrame;
+
+	/** The palette of the frame, only valid if dirtyPalette is set. */
+	bool dirtyPalette;
+	byte palette[256 * 3];
+
+	/** The track's getCurFrame(), getNextFrameStartTime() and endOfTrack(). */
+	int curFrame;
+	uint32 nextFrameStartTime;
+	bool endOfTrack;
+};
+
+class DecodeAheadQueueImpl;
+
+/**
+ * A bounded queue of frames that a worker thread decodes ahead of the ones
+ * being presented.
+ *
+ * The worker is started by the first call to pop(), and keeps the queue
+ * filled until it decoded a frame at the end of the track. While it runs, the
+ * decode function owns the track, so anything else touching the track has
+ * to stop() the worker first.
+ *
+ * Without thread support, pop() decodes the frame itself.
+ */
+class DecodeAheadQueue {
+public:
+	/** Decode the next frame of the track into @p frame. */
+	typedef void (*DecodeFunc)(void *data, DecodedFrame &frame);
+
+	/**
+	 * @param numFrames Number of frames to decode ahead, at least one.
+	 * @param func      Function decoding a frame on the worker thread.
+	 * @param data      Data passed to @p func.
+	 */
+	DecodeAheadQueue(uint numFrames, DecodeFunc func, void *data);
+	~DecodeAheadQueue();
+
+	/**
+	 * Wait for the next decoded frame and remove it from the queue. The frame
+	 * stays valid until the next call to pop() or clear().
+	 *
+	 * @return The frame, or nullptr if the end of the track was reached.
+	 */
+	const DecodedFrame *pop();
+
+	/** Wait for the worker to finish its frame, keeping the queued frames. */
+	void stop();
+
+	/** Stop the worker and drop all queued frames, e.g. after a seek. */
+	void clear();
+
+private:
+	DecodeAheadQueueImpl *_impl;
+};
+
+} // End of namespace Video
+
+#endif
@@ -4,6 +4,7 @@ MODULE_OBJS := \
 	3do_decoder.o \
 	avi_decoder.o \
 	coktel_decoder.o \
+	decode_ahead.o \
 	dxa_decoder.o \
 	flic_decoder.o \
 	hnm_decoder.o \
@@ -20,6 +20,7 @@
  */
 
 #include "video/video_decoder.h"
+#include "video/decode_ahead.h"
 
 #include "audio/audiostream.h"
 #include "audio/mixer.h" // for kMaxChannelVolume
@@ -27,6 +28,7 @@
 #include "common/rational.h"
 #include "common/file.h"
 #include "common/system.h"
+#include "common/threadpool.h"
 
 #include "graphics/palette.h"
 
@@ -49,12 +51,23 @@ VideoDecoder::VideoDecoder() {
 	_mainAudioTrack = 0;
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
+	_decodeAhead = 0;
+	_decodeAheadTrack = 0;
+}
+
+VideoDecoder::~VideoDecoder() {
+	delete _decodeAhead;
 }
 
 void VideoDecoder::close() {
 	if (isPlaying())
 		stop();
 
+	// The worker has to be gone before the tracks are
+	delete _decodeAhead;
+	_decodeAhead = 0;
+	_decodeAheadTrack = 0;
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		delete *it;
 
@@ -127,6 +140,9 @@ void VideoDecoder::pauseVideo(bool pause) {
 		return;
 	}
 
+	if (_decodeAhead && pause)
+		_decodeAhead->stop();
+
 	if (_pauseLevel == 1 && pause) {
 		_pauseStartTime = g_system->getMillis(); // Store the starting time from pausing to keep it for later
 
@@ -206,6 +222,30 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_canSetDither = false;
 	_canSetDefaultFormat = false;
 
+	if (_decodeAhead && _nextVideoTrack) {
+		const DecodedFrame *decoded = _decodeAhead->pop();
+		if (!decoded)
+			return 0;
+
+		_decodeAheadCurFrame = decoded->curFrame;
+		_decodeAheadNextFrameStartTime = decoded->nextFrameStartTime;
+		_decodeAheadEndOfTrack = decoded->endOfTrack;
+
+		if (decoded->dirtyPalette) {
+			memcpy(_decodeAheadPalette, decoded->palette, sizeof(_decodeAheadPalette));
+			_palette = _decodeAheadPalette;
+			_dirtyPalette = true;
+		}
+
+		findNextVideoTrack();
+		return decoded->hasFrame ? &decoded->surface : 0;
+	}
+
+	// Any remaining packets, e.g. audio, are read here again once the
+	// worker is done with the video track
+	if (_decodeAhead)
+		_decodeAhead->stop();
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -234,9 +274,15 @@ bool VideoDecoder::setReverse(bool reverse) {
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
+			if (_decodeAhead)
+				_decodeAhead->clear();
+
 			if (!((VideoTrack *)*it)->setReverse(reverse))
 				return false;
 
+			if (_decodeAhead)
+				resetDecodeAhead();
+
 			_needsUpdate = true; // force an update
 		}
 	}
@@ -255,7 +301,7 @@ int VideoDecoder::getCurFrame() const {
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
-			frame += ((VideoTrack *)*it)->getCurFrame() + 1;
+			frame += getTrackCurFrame((const VideoTrack *)*it) + 1;
 
 	return frame;
 }
@@ -296,7 +342,7 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = getTrackNextFrameStartTime(_nextVideoTrack);
 
 	if (_nextVideoTrack->isReversed()) {
 		// For reversed videos, we need to handle the time difference the opposite way.
@@ -317,8 +363,8 @@ bool VideoDecoder::endOfVideo() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && getTrackNextFrameStartTime((const VideoTrack *)track) >= (uint)_endTime.msecs();
+		bool endReached = isTrackEnded(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return false;
 	}
@@ -345,10 +391,16 @@ bool VideoDecoder::rewind() {
 	if (isPlaying())
 		stopAudio();
 
+	if (_decodeAhead)
+		_decodeAhead->clear();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if (!(*it)->rewind())
 			return false;
 
+	if (_decodeAhead)
+		resetDecodeAhead();
+
 	// Now that we've rewound, start all tracks again
 	if (isPlaying())
 		startAudio();
@@ -379,10 +431,16 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (isPlaying())
 		stopAudio();
 
+	if (_decodeAhead)
+		_decodeAhead->clear();
+
 	// Do the actual seeking
 	if (!seekIntern(time))
 		return false;
 
+	if (_decodeAhead)
+		resetDecodeAhead();
+
 	// Seek any external track too
 	for (TrackListIterator it = _externalTracks.begin(); it != _externalTracks.end(); it++)
 		if (!(*it)->seek(time))
@@ -444,6 +502,9 @@ void VideoDecoder::stop() {
 	// Stop audio here so we don't have it affect getTime()
 	stopAudio();
 
+	if (_decodeAhead)
+		_decodeAhead->stop();
+
 	// Keep the time marked down in case we start up again
 	// We do this before _playbackRate is set so we don't get
 	// _lastTimeChange returned, but before _pauseLevel is
@@ -562,6 +623,80 @@ bool VideoDecoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
 	return result;
 }
 
+bool VideoDecoder::setDecodeAhead(uint frames) {
+	// If a frame was already decoded, we can't set it now.
+	if (!supportsDecodeAhead() || !_canSetDefaultFormat || _decodeAhead || frames == 0)
+		return false;
+
+	VideoTrack *track = 0;
+
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			// We only allow this when one video track is present
+			if (track)
+				return false;
+
+			track = (VideoTrack *)*it;
+		}
+	}
+
+	if (!track)
+		return false;
+
+	// Create the shared pool here rather than racing for it on the worker
+	Common::ThreadPool::instance();
+
+	_decodeAhead = new DecodeAheadQueue(frames, &decodeAheadFrame, this);
+	_decodeAheadTrack = track;
+	resetDecodeAhead();
+	return true;
+}
+
+void VideoDecoder::decodeAheadFrame(void *data, DecodedFrame &frame) {
+	// This runs on the worker thread, which owns the track while it runs
+	VideoDecoder *decoder = (VideoDecoder *)data;
+	VideoTrack *track = decoder->_decodeAheadTrack;
+
+	decoder->readNextPacket();
+	frame.setFrame(track->decodeNextFrame());
+
+	frame.dirtyPalette = track->hasDirtyPalette();
+	if (frame.dirtyPalette)
+		memcpy(frame.palette, track->getPalette(), sizeof(frame.palette));
+
+	frame.curFrame = track->getCurFrame();
+	frame.nextFrameStartTime = track->getNextFrameStartTime();
+	frame.endOfTrack = track->endOfTrack();
+}
+
+void VideoDecoder::resetDecodeAhead() {
+	_decodeAhead->clear();
+	_decodeAheadCurFrame = _decodeAheadTrack->getCurFrame();
+	_decodeAheadNextFrameStartTime = _decodeAheadTrack->getNextFrameStartTime();
+	_decodeAheadEndOfTrack = _decodeAheadTrack->endOfTrack();
+}
+
+bool VideoDecoder::isTrackEnded(const Track *track) const {
+	if (_decodeAhead && track == _decodeAheadTrack)
+		return _decodeAheadEndOfTrack;
+
+	return track->endOfTrack();
+}
+
+uint32 VideoDecoder::getTrackNextFrameStartTime(const VideoTrack *track) const {
+	if (_decodeAhead && track == _decodeAheadTrack)
+		return _decodeAheadNextFrameStartTime;
+
+	return track->getNextFrameStartTime();
+}
+
+int VideoDecoder::getTrackCurFrame(const VideoTrack *track) const {
+	if (_decodeAhead && track == _decodeAheadTrack)
+		return _decodeAheadCurFrame;
+
+	return track->getCurFrame();
+}
+
 VideoDecoder::Track::Track() {
 	_paused = false;
 }
@@ -941,7 +1076,7 @@ const VideoDecoder::Track *VideoDecoder::getTrack(uint track) const {
 
 bool VideoDecoder::endOfVideoTracks() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack())
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !isTrackEnded(*it))
 			return false;
 
 	return true;
@@ -952,9 +1087,9 @@ VideoDecoder::VideoTrack *VideoDecoder::findNextVideoTrack() {
 	uint32 bestTime = 0xFFFFFFFF;
 
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack()) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !isTrackEnded(*it)) {
 			VideoTrack *track = (VideoTrack *)*it;
-			uint32 time = track->getNextFrameStartTime();
+			uint32 time = getTrackNextFrameStartTime(track);
 
 			if (time < bestTime) {
 				bestTime = time;
@@ -1008,8 +1143,8 @@ bool VideoDecoder::hasFramesLeft() const {
 
 		const VideoTrack *track = (const VideoTrack *)*it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && getTrackNextFrameStartTime(track) >= (uint)_endTime.msecs();
+		bool endReached = isTrackEnded(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return true;
 	}
@@ -46,13 +46,16 @@ struct Surface;
 
 namespace Video {
 
+class DecodeAheadQueue;
+struct DecodedFrame;
+
 /**
  * Generic interface for video decoder classes.
  */
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -395,6 +398,25 @@ public:
 	 */
 	bool setOutputPixelFormat(const Graphics::PixelFormat &format);
 
+	/**
+	 * Decode frames on a separate thread ahead of their presentation.
+	 *
+	 * Up to @p frames frames are kept decoded and converted, so that
+	 * decodeNextFrame() usually only has to hand out the next one. This is
+	 * only supported by formats whose supportsDecodeAhead() returns true,
+	 * and for videos with a single video track. While it is enabled, the
+	 * tracks must only be accessed through the functions of this class.
+	 *
+	 * This should be called after loadStream(), but before a decodeNextFrame()
+	 * call. This is enforced. It stays enabled until close() is called.
+	 *
+	 * @note YUV based videos share the YUVToRGBManager, so only one video
+	 *       at a time should decode ahead.
+	 * @param frames The number of frames to decode ahead
+	 * @return true on success, false otherwise
+	 */
+	bool setDecodeAhead(uint frames);
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -948,6 +970,20 @@ protected:
 	 */
 	virtual bool supportsAudioTrackSwitching() const { return false; }
 
+	/**
+	 * Can this video format decode ahead on a separate thread?
+	 * @see setDecodeAhead()
+	 *
+	 * Returning true implies that readNextPacket() and the video track's
+	 * decodeNextFrame() only touch the stream and the tracks of this
+	 * decoder, do not call into the backend other than through error(),
+	 * and hand audio to the mixer through streams which lock, such as
+	 * QueuingAudioStream. Anything else this class calls on the tracks
+	 * meanwhile, e.g. endOfTrack() of the audio tracks, must not depend on
+	 * the state they change.
+	 */
+	virtual bool supportsDecodeAhead() const { return false; }
+
 	/**
 	 * Get the audio track for the given index.
 	 *
@@ -979,6 +1015,21 @@ private:
 	bool _canSetDither;
 	bool _canSetDefaultFormat;
 
+	// Decoding ahead on a separate thread. While it runs, the state of the
+	// track as of the last presented frame is kept here.
+	DecodeAheadQueue *_decodeAhead;
+	VideoTrack *_decodeAheadTrack;
+	int _decodeAheadCurFrame;
+	uint32 _decodeAheadNextFrameStartTime;
+	bool _decodeAheadEndOfTrack;
+	byte _decodeAheadPalette[256 * 3];
+
+	static void decodeAheadFrame(void *data, DecodedFrame &frame);
+	void resetDecodeAhead();
+	bool isTrackEnded(const Track *track) const;
+	uint32 getTrackNextFrameStartTime(const VideoTrack *track) const;
+	int getTrackCurFrame(const VideoTrack *track) const;
+
 protected:
 	// Internal helper functions
 	void stopAudio();